@@ -208,6 +208,32 @@ static void BM_WaverBlit(benchmark::State& state) {
 
 BENCHMARK(BM_WaverBlit);
 
+static void BM_AffineBlit(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(60, 60);
+	auto rect = src->GetRect();
+	for (auto _: state) {
+		dest->AffineBlit(0, 0, 30, 30, *src, rect, rect, opacity, 2.0, 2.0, M_PI, 0, 0.0,
+				Tone(), Color(), false, false);
+	}
+}
+
+BENCHMARK(BM_AffineBlit);
+
+static void BM_AffineBlitEffects(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = Bitmap::Create(60, 60);
+	auto rect = src->GetRect();
+	for (auto _: state) {
+		dest->AffineBlit(0, 0, 30, 30, *src, rect, rect, opacity, 2.0, 2.0, M_PI, 0, 0.0,
+				Tone(255, 128, 128, 64), Color(255, 255, 255, 128), true, false);
+	}
+}
+
+BENCHMARK(BM_AffineBlitEffects);
+
 static void BM_Fill(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -340,6 +366,53 @@ static void BM_Blit2x(benchmark::State& state) {
 
 BENCHMARK(BM_Blit2x);
 
+static void BM_ScaleBlit(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	const int w = state.range(0);
+	const int h = state.range(1);
+	const int scale = state.range(2);
+	auto dest = Bitmap::Create(w * scale, h * scale);
+	auto src = Bitmap::Create(w, h);
+	auto rect = src->GetRect();
+	for (auto _: state) {
+		dest->ScaleBlit(0, 0, *src, rect, scale);
+	}
+}
+
+BENCHMARK(BM_ScaleBlit)->Args({320, 240, 2})->Args({320, 240, 3})->Args({320, 240, 4})
+	->Args({640, 480, 2})->Args({640, 480, 3})->Args({640, 480, 4});
+
+static void BM_NearestStretchBlit(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	const int w = state.range(0);
+	const int h = state.range(1);
+	// 2.5x, between the integer scales
+	auto dest = Bitmap::Create(w * 5 / 2, h * 5 / 2);
+	auto dst_rect = dest->GetRect();
+	auto src = Bitmap::Create(w, h);
+	auto rect = src->GetRect();
+	for (auto _: state) {
+		dest->NearestStretchBlit(dst_rect, *src, rect);
+	}
+}
+
+BENCHMARK(BM_NearestStretchBlit)->Args({320, 240})->Args({640, 480});
+
+static void BM_StretchBlitPixman(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	const int w = state.range(0);
+	const int h = state.range(1);
+	auto dest = Bitmap::Create(w * 5 / 2, h * 5 / 2);
+	auto dst_rect = dest->GetRect();
+	auto src = Bitmap::Create(w, h);
+	auto rect = src->GetRect();
+	for (auto _: state) {
+		dest->StretchBlit(dst_rect, *src, rect, Opacity::Opaque());
+	}
+}
+
+BENCHMARK(BM_StretchBlitPixman)->Args({320, 240})->Args({640, 480});
+
 static void BM_TransformRectangle(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include "filefinder.h"
+#include "filesystem.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// A game folder with enough files per directory to resemble a real one.
+// Created in the temporary directory and removed again by the destructor.
+class BenchGame {
+public:
+	BenchGame() {
+#ifdef _WIN32
+		const char* tmp = std::getenv("TEMP");
+#else
+		const char* tmp = std::getenv("TMPDIR");
+#endif
+		const auto dir = FileFinder::MakePath(tmp ? tmp : "/tmp", "easyrpg_bench_game");
+
+		auto root = FileFinder::Root();
+		for (const char* sub : { "CharSet", "Picture" }) {
+			const auto path = FileFinder::MakePath(dir, sub);
+			root.MakeDirectory(path, false);
+			paths.push_back(path);
+			for (int i = 0; i < 200; ++i) {
+				paths.push_back(FileFinder::MakePath(path, "File" + std::to_string(i) + ".png"));
+				root.OpenOutputStream(paths.back());
+			}
+		}
+		paths.insert(paths.begin(), dir);
+		fs = root.Subtree(dir);
+	}
+
+	~BenchGame() {
+		// Files before their directory
+		for (auto it = paths.rbegin(); it != paths.rend(); ++it) {
+			std::remove(it->c_str());
+		}
+	}
+
+	BenchGame(const BenchGame&) = delete;
+	BenchGame& operator=(const BenchGame&) = delete;
+
+	FilesystemView fs;
+
+private:
+	std::vector<std::string> paths;
+};
+
+static void BM_FindFile(benchmark::State& state) {
+	BenchGame game;
+	auto exts = Utils::MakeSvArray(".bmp", ".png", ".xyz");
+	for (auto _: state) {
+		benchmark::DoNotOptimize(game.fs.FindFile({ "CharSet/File42", exts }));
+	}
+}
+
+BENCHMARK(BM_FindFile);
+
+static void BM_FindFileMixedCase(benchmark::State& state) {
+	BenchGame game;
+	auto exts = Utils::MakeSvArray(".bmp", ".png", ".xyz");
+	for (auto _: state) {
+		benchmark::DoNotOptimize(game.fs.FindFile({ "charset/FILE42", exts }));
+	}
+}
+
+BENCHMARK(BM_FindFileMixedCase);
+
+static void BM_FindFileMissing(benchmark::State& state) {
+	BenchGame game;
+	auto exts = Utils::MakeSvArray(".bmp", ".png", ".xyz");
+	for (auto _: state) {
+		benchmark::DoNotOptimize(game.fs.FindFile({ "Picture/Missing", exts }));
+	}
+}
+
+BENCHMARK(BM_FindFileMissing);
+
+BENCHMARK_MAIN();
@@ -45,4 +45,46 @@ static void BM_DrawSortLocality(benchmark::State& state) {
 
 BENCHMARK(BM_DrawSortLocality);
 
+// Characters walking on the map: a few drawables change their Z every frame
+static void DrawMoved(benchmark::State& state, bool full_sort) {
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	std::vector<std::unique_ptr<TestSprite>> sprites;
+	for (int i = 0; i < num_sprites; ++i) {
+		sprites.push_back(std::make_unique<TestSprite>());
+		sprites.back()->SetZ(Priority_Player + (i % 240) * 16);
+	}
+
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Bitmap dst(320, 240, false);
+	list.Draw(dst);
+
+	const int num_moved = state.range(0);
+	int frame = 0;
+	for (auto _: state) {
+		for (int i = 0; i < num_moved; ++i) {
+			auto& sprite = sprites[(frame * 37 + i * 101) % num_sprites];
+			sprite->SetZ(sprite->GetZ() + ((frame & 1) ? -1 : 1));
+		}
+		if (full_sort) {
+			list.SetDirty();
+		}
+		list.Draw(dst);
+		++frame;
+	}
+}
+
+static void BM_DrawMovedIncremental(benchmark::State& state) {
+	DrawMoved(state, false);
+}
+
+BENCHMARK(BM_DrawMovedIncremental)->Arg(1)->Arg(16)->Arg(64);
+
+static void BM_DrawMovedFullSort(benchmark::State& state) {
+	DrawMoved(state, true);
+}
+
+BENCHMARK(BM_DrawMovedFullSort)->Arg(1)->Arg(16)->Arg(64);
+
 BENCHMARK_MAIN();
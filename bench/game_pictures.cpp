@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include "game_pictures.h"
+
+// Custom menu games use a lot of picture ids of which only some are shown
+constexpr int max_pics = 2000;
+
+static Game_Pictures make(int shown) {
+	Game_Pictures pictures;
+	// Allocates all pictures
+	pictures.GetPicture(max_pics);
+
+	Game_Pictures::ShowParams show = {};
+	show.magnify = 100;
+	show.red = show.green = show.blue = show.saturation = 100;
+	for (int i = 0; i < shown; ++i) {
+		// Spread over the whole id range
+		pictures.Show(1 + i * (max_pics / shown), show);
+	}
+	return pictures;
+}
+
+static void move(Game_Pictures& pictures, int shown) {
+	Game_Pictures::MoveParams move = {};
+	move.position_x = 320;
+	move.position_y = 240;
+	move.magnify = 200;
+	move.top_trans = move.bottom_trans = 50;
+	move.duration = 1000;
+	for (int i = 0; i < shown; ++i) {
+		pictures.Move(1 + i * (max_pics / shown), move);
+	}
+}
+
+static void BM_PicturesIdle(benchmark::State& state) {
+	auto pictures = make(state.range(0));
+	for (auto _: state) {
+		pictures.Update(false);
+	}
+}
+
+BENCHMARK(BM_PicturesIdle)->Arg(10)->Arg(200)->Arg(2000);
+
+static void BM_PicturesMoving(benchmark::State& state) {
+	auto pictures = make(state.range(0));
+	int frame = 0;
+	for (auto _: state) {
+		if (frame++ % 1000 == 0) {
+			move(pictures, state.range(0));
+		}
+		pictures.Update(false);
+	}
+}
+
+BENCHMARK(BM_PicturesMoving)->Arg(10)->Arg(200)->Arg(2000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include <bitmap.h>
+#include <pixel_format.h>
+#include <png.h>
+#include <zlib.h>
+#include <cstring>
+#include <vector>
+
+// Size of a CharSet
+constexpr int width = 288;
+constexpr int height = 256;
+
+static std::vector<uint8_t> MakeIndices() {
+	std::vector<uint8_t> indices(width * height);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			// Runs of the same color with transparent gaps like a sprite sheet
+			indices[y * width + x] = ((x / 24 + y / 32) % 3 == 0) ? 0 : ((x / 4) ^ y) & 0xFF;
+		}
+	}
+	return indices;
+}
+
+static std::vector<uint8_t> MakeXYZ() {
+	std::vector<uint8_t> raw(768);
+	for (int i = 0; i < 768; ++i) {
+		raw[i] = (i * 7) & 0xFF;
+	}
+	auto indices = MakeIndices();
+	raw.insert(raw.end(), indices.begin(), indices.end());
+
+	uLongf size = compressBound(raw.size());
+	std::vector<uint8_t> file(8 + size);
+	memcpy(file.data(), "XYZ1", 4);
+	file[4] = width & 0xFF;
+	file[5] = width >> 8;
+	file[6] = height & 0xFF;
+	file[7] = height >> 8;
+	compress(file.data() + 8, &size, raw.data(), raw.size());
+	file.resize(8 + size);
+	return file;
+}
+
+static void Put(std::vector<uint8_t>& file, uint32_t value, int bytes) {
+	for (int i = 0; i < bytes; ++i) {
+		file.push_back((value >> (i * 8)) & 0xFF);
+	}
+}
+
+static std::vector<uint8_t> MakeBMP() {
+	std::vector<uint8_t> file = { 'B', 'M' };
+	Put(file, 0, 4);
+	Put(file, 0, 4);
+	Put(file, 14 + 40 + 256 * 4, 4);
+	Put(file, 40, 4);
+	Put(file, width, 4);
+	Put(file, height, 4);
+	Put(file, 1, 2);
+	Put(file, 8, 2);
+	Put(file, 0, 4);
+	Put(file, 0, 4);
+	Put(file, 0, 4);
+	Put(file, 0, 4);
+	Put(file, 256, 4);
+	Put(file, 0, 4);
+	for (int i = 0; i < 256; ++i) {
+		Put(file, i * 0x010307, 4);
+	}
+	auto indices = MakeIndices();
+	file.insert(file.end(), indices.begin(), indices.end());
+	return file;
+}
+
+static void WritePNGData(png_structp png_ptr, png_bytep data, png_size_t length) {
+	auto* file = reinterpret_cast<std::vector<uint8_t>*>(png_get_io_ptr(png_ptr));
+	file->insert(file->end(), data, data + length);
+}
+
+static std::vector<uint8_t> MakePNG() {
+	std::vector<uint8_t> file;
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	png_set_write_fn(png_ptr, &file, WritePNGData, NULL);
+	png_set_IHDR(png_ptr, info_ptr, width, height, 8, PNG_COLOR_TYPE_PALETTE,
+		PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+
+	png_color palette[256];
+	for (int i = 0; i < 256; ++i) {
+		palette[i] = { (png_byte) i, (png_byte) (i * 3), (png_byte) (i * 7) };
+	}
+	png_set_PLTE(png_ptr, info_ptr, palette, 256);
+	png_write_info(png_ptr, info_ptr);
+
+	auto indices = MakeIndices();
+	for (int y = 0; y < height; ++y) {
+		png_write_row(png_ptr, &indices[y * width]);
+	}
+	png_write_end(png_ptr, NULL);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+	return file;
+}
+
+static void Decode(benchmark::State& state, const std::vector<uint8_t>& file) {
+	Bitmap::SetFormat(format_B8G8R8A8_a().format());
+	bool transparent = state.range(0);
+
+	for (auto _: state) {
+		Bitmap bmp(file.data(), file.size(), transparent, 0);
+		benchmark::DoNotOptimize(bmp.pixels());
+	}
+}
+
+static void BM_DecodeXYZ(benchmark::State& state) {
+	Decode(state, MakeXYZ());
+}
+
+BENCHMARK(BM_DecodeXYZ)->Arg(0)->Arg(1);
+
+static void BM_DecodeBMP(benchmark::State& state) {
+	Decode(state, MakeBMP());
+}
+
+BENCHMARK(BM_DecodeBMP)->Arg(0)->Arg(1);
+
+static void BM_DecodePNG(benchmark::State& state) {
+	Decode(state, MakePNG());
+}
+
+BENCHMARK(BM_DecodePNG)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <bitmap.h>
+#include <pixel_format.h>
+#include <game_clock.h>
+#include <game_pictures.h>
+#include <input.h>
+#include <player.h>
+#include <scene.h>
+
+// Logic frames per second of fast forward plus (--turbo-fps 0) against the
+// turbo fast forward (--turbo-fps N). The logic frames run through the loop
+// of Player::MainLoop. A logic frame updates moving pictures, a present
+// draws 300 tiles to the 320x240 screen, stretches it to 960x720 and waits
+// for the 60 fps frame limit.
+
+constexpr int num_pics = 200;
+constexpr int num_tiles = 300;
+constexpr int speed_modifier_plus = 10;
+
+static void move(Game_Pictures& pictures) {
+	Game_Pictures::MoveParams move = {};
+	move.position_x = 320;
+	move.position_y = 240;
+	move.magnify = 200;
+	move.top_trans = move.bottom_trans = 50;
+	move.duration = 1000;
+	for (int i = 1; i <= num_pics; ++i) {
+		pictures.Move(i, move);
+	}
+}
+
+static void FastForward(benchmark::State& state, int turbo_fps) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto tile = Bitmap::Create(16, 16, Color(255, 128, 0, 255));
+	auto screen = Bitmap::Create(320, 240, false);
+	auto window = Bitmap::Create(960, 720, false);
+
+	Game_Pictures pictures;
+	Game_Pictures::ShowParams show = {};
+	show.magnify = 100;
+	show.red = show.green = show.blue = show.saturation = 100;
+	for (int i = 1; i <= num_pics; ++i) {
+		pictures.Show(i, show);
+	}
+
+	// The turbo only runs while a scene is active and fast forward plus is held
+	Scene::instance = std::make_shared<Scene>();
+	Scene::instance->type = Scene::Map;
+	Input::press_time[Input::FAST_FORWARD_PLUS] = 1;
+	Player::SetTurboFps(turbo_fps);
+
+	const auto frame_limit = Game_Clock::TimeStepFromFps(60);
+
+	Game_Clock::SetGameSpeedFactor(speed_modifier_plus);
+	Game_Clock::ResetFrame(Game_Clock::now());
+
+	int64_t updates = 0;
+	int64_t presents = 0;
+	for (auto _: state) {
+		const auto frame_time = Game_Clock::now();
+		Game_Clock::OnNextFrame(frame_time);
+
+		Player::UpdateLogicFrames(frame_time, [&](int) {
+			if (updates++ % 1000 == 0) {
+				move(pictures);
+			}
+			pictures.Update(false);
+		});
+
+		for (int i = 0; i < num_tiles; ++i) {
+			screen->Blit((i * 16) % 320, (i / 20 * 16) % 240, *tile, tile->GetRect(), Opacity::Opaque());
+		}
+		window->StretchBlit(window->GetRect(), *screen, screen->GetRect(), Opacity::Opaque());
+		++presents;
+
+		const auto next = frame_time + frame_limit;
+		const auto now = Game_Clock::now();
+		if (now < next) {
+			Game_Clock::SleepFor(next - now);
+		}
+	}
+
+	Game_Clock::SetGameSpeedFactor(1);
+	Player::SetTurboFps(0);
+	Input::press_time[Input::FAST_FORWARD_PLUS] = 0;
+	Scene::instance.reset();
+
+	state.counters["logic_fps"] = benchmark::Counter(updates, benchmark::Counter::kIsRate);
+	state.counters["present_fps"] = benchmark::Counter(presents, benchmark::Counter::kIsRate);
+}
+
+static void BM_FastForwardPlus(benchmark::State& state) {
+	FastForward(state, 0);
+}
+
+BENCHMARK(BM_FastForwardPlus)->UseRealTime();
+
+static void BM_FastForwardTurbo(benchmark::State& state) {
+	FastForward(state, state.range(0));
+}
+
+BENCHMARK(BM_FastForwardTurbo)->Arg(60)->Arg(30)->Arg(15)->UseRealTime();
+
+BENCHMARK_MAIN();
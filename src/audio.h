@@ -106,6 +106,16 @@ struct AudioInterface {
 	 */
 	virtual void SE_Play(Filesystem_Stream::InputStream stream, int volume, int pitch) = 0;
 
+	/**
+	 * Prepares a sound effect for fast playback without playing it.
+	 * Implementations without a SE cache ignore this.
+	 *
+	 * @param stream file to preload.
+	 * @param pitch pitch the sound effect is played with.
+	 * @return false when no further sound effects should be preloaded.
+	 */
+	virtual bool SE_Preload(Filesystem_Stream::InputStream, int /* pitch */) { return false; }
+
 	/**
 	 * Stops the currently playing sound effect.
 	 */
@@ -157,6 +157,10 @@ void GenericAudio::SE_Play(Filesystem_Stream::InputStream stream, int volume, in
 	Output::Debug("Couldn't play {} SE. No free channel available", stream.GetName());
 }
 
+bool GenericAudio::SE_Preload(Filesystem_Stream::InputStream stream, int pitch) {
+	return AudioSeCache::Preload(std::move(stream), pitch);
+}
+
 void GenericAudio::SE_Stop() {
 	for (auto& SE_Channel : SE_Channels) {
 		SE_Channel.stopped = true; //Stop all running sound effects
@@ -171,6 +175,8 @@ void GenericAudio::SetFormat(int frequency, AudioDecoder::Format format, int cha
 	output_format.frequency = frequency;
 	output_format.format = format;
 	output_format.channels = channels;
+
+	AudioSeCache::SetOutputFormat(frequency, format, channels);
 }
 
 bool GenericAudio::PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStream filestream, int volume, int pitch, int fadein) {
@@ -202,11 +208,9 @@ bool GenericAudio::PlayOnChannel(SeChannel& chan, Filesystem_Stream::InputStream
 	chan.paused = true; // Pause channel so the audio thread doesn't work on it
 	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
 
-	std::unique_ptr<AudioSeCache> cache = AudioSeCache::Create(std::move(filestream));
+	std::unique_ptr<AudioSeCache> cache = AudioSeCache::Create(std::move(filestream), pitch);
 	if (cache) {
-		chan.decoder = cache->CreateSeDecoder();
-		chan.decoder->SetPitch(pitch);
-		chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+		chan.decoder = cache->CreateSeDecoder(pitch);
 		chan.volume = volume;
 		chan.paused = false; // Unpause channel -> Play it.
 		return true;
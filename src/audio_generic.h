@@ -52,6 +52,7 @@ public:
 	void BGM_Volume(int volume) override;
 	void BGM_Pitch(int pitch) override;
 	void SE_Play(Filesystem_Stream::InputStream stream, int volume, int pitch) override;
+	bool SE_Preload(Filesystem_Stream::InputStream stream, int pitch) override;
 	void SE_Stop() override;
 	virtual void Update() override;
 
@@ -18,13 +18,14 @@
 // Headers
 #include <cassert>
 #include <cstring>
-#include <map>
+#include <list>
 #include <memory>
-#include <set>
+#include <unordered_map>
 #include "audio_resampler.h"
 #include "audio_secache.h"
 #include "game_clock.h"
 #include "filefinder.h"
+#include "memory_stats.h"
 #include "output.h"
 
 #ifdef LOW_MEMORY_DEVICES
@@ -33,56 +34,164 @@
 #define CACHE_SIZE_DEF 3
 #endif
 
-using namespace std::chrono_literals;
-
 namespace {
-	typedef std::map<std::string, AudioSeRef> cache_type;
+	struct CacheEntry {
+		AudioSeRef se;
+		std::list<int>::iterator lru_it;
+		/** Key in name_to_id, empty when the id is unused */
+		std::string name;
+		/** AudioSeCache instances holding the id */
+		int users = 0;
+	};
+
+	/** Maps the SE filename and pitch to the id used for all further lookups */
+	std::unordered_map<std::string, int> name_to_id;
+	/** Indexed by id. se is null when the SE is not cached */
+	std::vector<CacheEntry> entries;
+	/** Ids of entries without SE and users, reused before entries grows */
+	std::vector<int> free_ids;
+	/** Ids of cached SE, most recently used first */
+	std::list<int> lru;
+
+	size_t cache_limit = CACHE_SIZE_DEF * 1024 * 1024;
+	size_t cache_size = 0;
+
+	MemoryStats::Source se_stats("Sounds", [](MemoryStats::Source& source) {
+		source.SetUsage(cache_size, lru.size());
+	});
+
+	struct {
+		int frequency = 0;
+		AudioDecoder::Format format = AudioDecoder::Format::S16;
+		int channels = 0;
+	} output_format;
+
+	/** The pitch is part of the key because pitched SEs are cached resampled */
+	std::string MakeKey(StringView name, int pitch) {
+		std::string key = ToString(name);
+		if (pitch != 100) {
+			key += '\0';
+			key += std::to_string(pitch);
+		}
+		return key;
+	}
+
+	/** @return id of the key, the caller becomes a user of the id */
+	int Acquire(std::string key) {
+		auto it = name_to_id.find(key);
+		if (it != name_to_id.end()) {
+			++entries[it->second].users;
+			return it->second;
+		}
 
-	cache_type cache;
+		int id;
+		if (!free_ids.empty()) {
+			id = free_ids.back();
+			free_ids.pop_back();
+		} else {
+			id = static_cast<int>(entries.size());
+			entries.emplace_back();
+		}
 
-	constexpr int cache_limit = CACHE_SIZE_DEF * 1024 * 1024;
-	int cache_size = 0;
+		auto& entry = entries[id];
+		entry.name = key;
+		entry.users = 1;
+		name_to_id.emplace(std::move(key), id);
+		return id;
+	}
+
+	/** Forgets the key of an id without SE and users, the id is reused */
+	void FreeIfUnused(int id) {
+		auto& entry = entries[id];
+		if (entry.se || entry.users > 0) {
+			return;
+		}
+
+		name_to_id.erase(entry.name);
+		entry.name.clear();
+		entry.name.shrink_to_fit();
+		free_ids.push_back(id);
+	}
+
+	void Release(int id) {
+		--entries[id].users;
+		FreeIfUnused(id);
+	}
 
 	void FreeCacheMemory() {
-		auto cur_time = Game_Clock::GetFrameTime();
+		// Evict starting with the least recently used SE until the limit is met
+		auto it = lru.end();
+		while (cache_size > cache_limit && it != lru.begin()) {
+			--it;
+			auto& entry = entries[*it];
 
-		for (auto it = cache.begin(); it != cache.end(); ) {
-			if (it->second.use_count() > 1) {
+			if (entry.se.use_count() > 1) {
 				// SE is currently playing
-				++it;
-				continue;
-			}
-
-			if (cache_size <= cache_limit && cur_time - it->second->last_access < 3s) {
-				// Below memory limit and last access < 3s
-				++it;
 				continue;
 			}
 
 #ifdef CACHE_DEBUG
-			Output::Debug("SE: Freeing memory of {}", it->first);
+			Output::Debug("SE: Freeing memory of id {}", *it);
 #endif
 
-			cache_size -= it->second->buffer.size();
-
-			it = cache.erase(it);
+			cache_size -= entry.se->buffer.size();
+			se_stats.Evict();
+			entry.se.reset();
+			FreeIfUnused(*it);
+			it = lru.erase(it);
 		}
 
 #ifdef CACHE_DEBUG
 		Output::Debug("SE cache size: {}", cache_size / 1024.0 / 1024);
+#endif
+	}
+
+	bool IsOutputFormat(const AudioSeData& se) {
+		return se.frequency == output_format.frequency &&
+			se.format == output_format.format &&
+			se.channels == output_format.channels;
+	}
+
+	/**
+	 * Converts the decoded sample to the output format of the mixer and
+	 * applies the pitch in the same pass.
+	 * Formats the resampler cannot produce are kept as close as possible,
+	 * the mixer handles any format.
+	 */
+	AudioSeRef ConvertToOutputFormat(AudioSeRef se, int pitch) {
+#ifdef USE_AUDIO_RESAMPLER
+		if (output_format.frequency <= 0 || (pitch == 100 && IsOutputFormat(*se))) {
+			return se;
+		}
+
+		AudioResampler resampler(std::make_unique<AudioSeDecoder>(se));
+		Filesystem_Stream::InputStream is;
+		if (!resampler.Open(std::move(is))) {
+			return se;
+		}
+		resampler.SetPitch(pitch);
+		resampler.SetFormat(output_format.frequency, output_format.format, output_format.channels);
+
+		auto converted = std::make_shared<AudioSeData>();
+		resampler.GetFormat(converted->frequency, converted->format, converted->channels);
+		converted->pitch = pitch;
+		converted->buffer = resampler.DecodeAll();
+		converted->buffer.shrink_to_fit();
+		return converted;
+#else
+		return se;
 #endif
 	}
 }
 
-std::unique_ptr<AudioSeCache> AudioSeCache::Create(Filesystem_Stream::InputStream stream) {
+std::unique_ptr<AudioSeCache> AudioSeCache::Create(Filesystem_Stream::InputStream stream, int pitch) {
 	std::unique_ptr<AudioSeCache> se;
 
-	auto const it = cache.find(ToString(stream.GetName()));
-
 	se = std::make_unique<AudioSeCache>();
-	se->filename = ToString(stream.GetName());
+	se->id = Acquire(MakeKey(stream.GetName(), pitch));
+	se->pitch = pitch;
 
-	if (it == cache.end()) {
+	if (!se->IsCached()) {
 		// Not in cache
 		if (!stream) {
 			se.reset();
@@ -106,6 +215,23 @@ std::unique_ptr<AudioSeCache> AudioSeCache::Create(Filesystem_Stream::InputStrea
 	return se;
 }
 
+AudioSeCache::~AudioSeCache() {
+	Release(id);
+}
+
+bool AudioSeCache::Preload(Filesystem_Stream::InputStream stream, int pitch) {
+	if (cache_size >= cache_limit) {
+		return false;
+	}
+
+	auto se = Create(std::move(stream), pitch);
+	if (se && !se->Load(true)) {
+		return false;
+	}
+
+	return cache_size < cache_limit;
+}
+
 void AudioSeCache::GetFormat(int& frequency, AudioDecoder::Format& format, int& channels) const {
 	if (!audio_decoder) {
 		if (!GetCachedFormat(frequency, format, channels)) {
@@ -119,16 +245,15 @@ void AudioSeCache::GetFormat(int& frequency, AudioDecoder::Format& format, int&
 }
 
 bool AudioSeCache::IsCached() const {
-	return cache.find(filename) != cache.end();
+	return entries[id].se != nullptr;
 }
 
 bool AudioSeCache::GetCachedFormat(int& frequency, AudioDecoder::Format& format, int& channels) const {
-	cache_type::const_iterator it = cache.find(filename);
-
-	if (it != cache.end()) {
-		frequency = (*it).second->frequency;
-		format = (*it).second->format;
-		channels = (*it).second->channels;
+	if (IsCached()) {
+		const auto& se = *entries[id].se;
+		frequency = se.frequency;
+		format = se.format;
+		channels = se.channels;
 
 		return true;
 	}
@@ -136,34 +261,35 @@ bool AudioSeCache::GetCachedFormat(int& frequency, AudioDecoder::Format& format,
 	return false;
 }
 
-std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder() {
-	AudioSeRef se;
-
-	if (IsCached()) {
-		se = cache.find(filename)->second;
-		se->last_access = Game_Clock::GetFrameTime();
+AudioSeRef AudioSeCache::Load(bool preload) {
+	auto& entry = entries[id];
 
-		std::unique_ptr<AudioDecoder> dec = std::make_unique<AudioSeDecoder>(se);
-#ifdef USE_AUDIO_RESAMPLER
-		dec = std::make_unique<AudioResampler>(std::move(dec));
-#endif
-		Filesystem_Stream::InputStream is;
-		dec->Open(std::move(is));
-		return dec;
-	}
-
-	// Not cached yet: Decode the sample without any resampling
-
-	if (!se) {
-		se.reset(new AudioSeData());
+	if (entry.se) {
+		se_stats.Hit();
+		entry.se->last_access = Game_Clock::GetFrameTime();
+		lru.splice(lru.begin(), lru, entry.lru_it);
+		return entry.se;
 	}
 
+	// Not cached yet: Decode the whole sample and convert it once to the
+	// format of the mixer, playback then only needs to mix it
 	assert(audio_decoder);
+	se_stats.Miss();
 
+	auto se = std::make_shared<AudioSeData>();
 	audio_decoder->GetFormat(se->frequency, se->format, se->channels);
 	se->buffer = audio_decoder->DecodeAll();
+	se = ConvertToOutputFormat(std::move(se), pitch);
+	se->last_access = Game_Clock::GetFrameTime();
+
+	if (preload && cache_size + se->buffer.size() > cache_limit) {
+		// Would evict the SEs preloaded before
+		return nullptr;
+	}
 
-	cache.insert(std::make_pair(filename, se));
+	entry.se = se;
+	lru.push_front(id);
+	entry.lru_it = lru.begin();
 
 	cache_size += se->buffer.size();
 
@@ -173,24 +299,69 @@ std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder() {
 
 	FreeCacheMemory();
 
-	std::unique_ptr<AudioDecoder> dec = std::unique_ptr<AudioDecoder>(new AudioSeDecoder(se));
+	return se;
+}
+
+std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder() {
+	AudioSeRef se = Load();
+
+	std::unique_ptr<AudioDecoder> dec = std::make_unique<AudioSeDecoder>(se);
 #ifdef USE_AUDIO_RESAMPLER
-	dec = std::unique_ptr<AudioDecoder>(new AudioResampler(std::move(dec)));
+	dec = std::make_unique<AudioResampler>(std::move(dec));
 #endif
 	Filesystem_Stream::InputStream is;
 	dec->Open(std::move(is));
 	return dec;
 }
 
+std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder(int pitch) {
+	AudioSeRef se = Load();
+
+	if (se->pitch == pitch && IsOutputFormat(*se)) {
+		// Already resampled to the output format: No resampler needed
+		return std::make_unique<AudioSeDecoder>(se);
+	}
+
+	auto dec = CreateSeDecoder();
+	// Only happens when the conversion failed, the pitch may be applied already
+	dec->SetPitch(se->pitch == pitch ? 100 : pitch);
+	if (output_format.frequency > 0) {
+		dec->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+	}
+	return dec;
+}
+
 AudioSeRef AudioSeCache::GetSeData() const {
-    assert(IsCached());
+	assert(IsCached());
 
-    return cache.find(filename)->second;
+	return entries[id].se;
 };
 
 void AudioSeCache::Clear() {
+	for (int cur_id : lru) {
+		entries[cur_id].se.reset();
+		FreeIfUnused(cur_id);
+	}
+	lru.clear();
 	cache_size = 0;
-	cache.clear();
+}
+
+void AudioSeCache::SetCacheLimit(size_t bytes) {
+	cache_limit = bytes;
+	FreeCacheMemory();
+}
+
+void AudioSeCache::SetOutputFormat(int frequency, AudioDecoder::Format format, int channels) {
+	if (output_format.frequency == frequency && output_format.format == format && output_format.channels == channels) {
+		return;
+	}
+
+	output_format.frequency = frequency;
+	output_format.format = format;
+	output_format.channels = channels;
+
+	// Cached samples are stored in the old format
+	Clear();
 }
 
 AudioSeDecoder::AudioSeDecoder(AudioSeRef se) :
@@ -23,7 +23,6 @@
 #include <string>
 #include <vector>
 #include <memory>
-#include <map>
 
 #include "audio_decoder.h"
 #include "game_clock.h"
@@ -40,6 +39,8 @@ public:
 	int frequency;
 	AudioDecoder::Format format;
 	int channels;
+	/** Pitch the sample was resampled with */
+	int pitch = 100;
 };
 
 typedef std::shared_ptr<AudioSeData> AudioSeRef;
@@ -69,19 +70,36 @@ private:
  * AudioSeCache provides an interface for accessing sound effects.
  * It also provides an automatic cache management, any SE is only decoded
  * once, otherwise returned from the cache.
- * The cache is flushed from recently (>10 seconds by default) unused
- * samples when it reaches the memory limit (5 MB by default).
+ * When an output format is set the samples are stored already converted
+ * to that format, playing them back at normal pitch only requires mixing.
+ * A SE played with a pitch is cached separately, resampled to the pitch
+ * and the output format in a single pass.
+ * The least recently used samples are flushed when the cache exceeds the
+ * memory limit (3 MB by default, 1 MB on low memory devices). Filenames of
+ * flushed samples are forgotten as well.
  * Uses an internal AudioDecoder for handling the decoding.
  */
 class AudioSeCache {
 public:
+	~AudioSeCache();
+
 	/**
 	 * Opens the passed filename with the internal audio decoder.
 	 *
 	 * @param stream Stream to the audio file
+	 * @param pitch Pitch the SE is played with
 	 * @return An AudioSeCache instance when the format was detected, otherwise null
 	 */
-	static std::unique_ptr<AudioSeCache> Create(Filesystem_Stream::InputStream stream);
+	static std::unique_ptr<AudioSeCache> Create(Filesystem_Stream::InputStream stream, int pitch = 100);
+
+	/**
+	 * Decodes the SE and puts it into the cache without playing it.
+	 *
+	 * @param stream Stream to the audio file
+	 * @param pitch Pitch the SE is played with
+	 * @return false when the cache is full and preloading should stop
+	 */
+	static bool Preload(Filesystem_Stream::InputStream stream, int pitch = 100);
 
 	/**
 	 * Retrieves the format of the internal audio decoder.
@@ -115,7 +133,7 @@ public:
 	bool GetCachedFormat(int& frequency, AudioDecoder::Format& format, int& channels) const;
 
 	/**
-	 * Decodes the whole sample without doing any resampling and caches it.
+	 * Decodes the whole sample and caches it.
 	 * When cached the decoding step is skipped.
 	 * The returned AudioDecoder contains the SE sample.
 	 *
@@ -123,6 +141,17 @@ public:
 	 */
 	std::unique_ptr<AudioDecoder> CreateSeDecoder();
 
+	/**
+	 * Like CreateSeDecoder but the returned decoder already produces the
+	 * output format set by SetOutputFormat.
+	 * The resampler is skipped when the cached sample is in the output
+	 * format, which is the case after the first decode.
+	 *
+	 * @param pitch Pitch of the SE, must match the pitch passed to Create
+	 * @return Decoded sound effect
+	 */
+	std::unique_ptr<AudioDecoder> CreateSeDecoder(int pitch);
+
 	/**
 	 * Returns the SE sample data handled by this SeCache.
 	 *
@@ -131,10 +160,37 @@ public:
 	AudioSeRef GetSeData() const;
 
 	static void Clear();
+
+	/**
+	 * Sets the memory limit of the cache.
+	 *
+	 * @param bytes Limit in bytes
+	 */
+	static void SetCacheLimit(size_t bytes);
+
+	/**
+	 * Sets the format of the mixer. Samples are converted to this format
+	 * when they are added to the cache.
+	 * Changing the format clears the cache.
+	 *
+	 * @param frequency Audio frequency
+	 * @param format Audio format
+	 * @param channels Amount of channels
+	 */
+	static void SetOutputFormat(int frequency, AudioDecoder::Format format, int channels);
 private:
+	/**
+	 * Decodes and caches the sample or returns the cached one.
+	 *
+	 * @param preload when true the sample is dropped instead of evicting others
+	 * @return sample, null when it was dropped
+	 */
+	AudioSeRef Load(bool preload = false);
+
 	std::unique_ptr<AudioDecoder> audio_decoder;
 
-	std::string filename;
+	int id = 0;
+	int pitch = 100;
 };
 
 #endif
@@ -146,6 +146,21 @@ public:
 	BitmapRef const& GetDisplaySurface() const;
 	BitmapRef& GetDisplaySurface();
 
+	/**
+	 * Returns whether the display surface is an ordinary bitmap that
+	 * UpdateDisplay reads from, so it can be exchanged with a back buffer.
+	 *
+	 * @return true if SwapDisplaySurface is supported
+	 */
+	virtual bool IsDisplaySurfaceSwappable() const;
+
+	/**
+	 * Exchanges the display surface with a bitmap of the same size and format.
+	 *
+	 * @param surface the new display surface, receives the old one
+	 */
+	void SwapDisplaySurface(BitmapRef& surface);
+
 	typedef std::bitset<Input::Keys::KEYS_COUNT> KeyStatus;
 
 	/**
@@ -237,6 +252,14 @@ protected:
 /** Global DisplayUi variable. */
 extern std::shared_ptr<BaseUi> DisplayUi;
 
+inline bool BaseUi::IsDisplaySurfaceSwappable() const {
+	return false;
+}
+
+inline void BaseUi::SwapDisplaySurface(BitmapRef& surface) {
+	main_surface.swap(surface);
+}
+
 inline bool BaseUi::IsFrameRateSynchronized() const {
 	return external_frame_rate;
 }
@@ -107,22 +107,33 @@ void BattleAnimation::DrawAt(Bitmap& dst, int x, int y) {
 			continue;
 		}
 
-		SetX(invert ? x - cell.x : cell.x + x);
-		SetY(cell.y + y);
+		const int cell_x = invert ? x - cell.x : cell.x + x;
+		const int cell_y = cell.y + y;
 		int sx = cell.cell_id % 5;
 		if (invert) sx = 4 - sx;
 		int sy = cell.cell_id / 5;
 		int size = animation.large ? 128 : 96;
-		SetSrcRect(Rect(sx * size, sy * size, size, size));
-		SetOx(size / 2);
-		SetOy(size / 2);
-		SetTone(Tone(cell.tone_red * 128 / 100,
+		const Rect cell_rect(sx * size, sy * size, size, size);
+		const Tone tone(cell.tone_red * 128 / 100,
 			cell.tone_green * 128 / 100,
 			cell.tone_blue * 128 / 100,
-			cell.tone_gray * 128 / 100));
-		SetOpacity(255 * (100 - cell.transparency) / 100);
-		SetZoomX(cell.zoom / 100.0);
-		SetZoomY(cell.zoom / 100.0);
+			cell.tone_gray * 128 / 100);
+		const int opacity = 255 * (100 - cell.transparency) / 100;
+		const double zoom = cell.zoom / 100.0;
+
+		if (DrawCell(dst, cell_x, cell_y, cell_rect, tone, opacity, zoom)) {
+			continue;
+		}
+
+		SetX(cell_x);
+		SetY(cell_y);
+		SetSrcRect(cell_rect);
+		SetOx(size / 2);
+		SetOy(size / 2);
+		SetTone(tone);
+		SetOpacity(opacity);
+		SetZoomX(zoom);
+		SetZoomY(zoom);
 		SetFlipX(invert);
 		Sprite::Draw(dst);
 	}
@@ -134,6 +145,28 @@ void BattleAnimation::DrawAt(Bitmap& dst, int x, int y) {
 	}
 }
 
+bool BattleAnimation::DrawCell(Bitmap& dst, int x, int y, Rect const& cell_rect, Tone const& tone, int opacity, double zoom) {
+	const BitmapRef& bitmap = GetBitmap();
+	if (!bitmap) {
+		return false;
+	}
+
+	if (opacity <= 0) {
+		return true;
+	}
+
+	// Every cell has its own tone, going through the sprite would create a
+	// tinted effect bitmap per cell and frame. The cell rect is taken from
+	// the whole sheet flipped as a unit, like the sprite does it.
+	Rect sheet_rect = bitmap->GetRect();
+	Rect src_rect = sheet_rect.GetSubRect(cell_rect);
+
+	return dst.AffineBlit(x, y, cell_rect.width / 2, cell_rect.height / 2,
+			*bitmap, src_rect, sheet_rect, Opacity(opacity, (opacity + 1) / 2, 0),
+			zoom, zoom, 0.0, 0, 0.0,
+			tone, GetFlashEffect(), invert, false);
+}
+
 void BattleAnimation::ProcessAnimationFlash(const lcf::rpg::AnimationTiming& timing) {
 	if (IsOnlySound()) {
 		return;
@@ -85,6 +85,13 @@ protected:
 	virtual void FlashTargets(int r, int g, int b, int p) = 0;
 	virtual void ShakeTargets(int str, int spd, int time) = 0;
 	void DrawAt(Bitmap& dst, int x, int y);
+	/**
+	 * Draws a cell with tone, opacity and zoom directly into dst without
+	 * creating an effect bitmap.
+	 *
+	 * @return false when the cell must be drawn through the sprite instead.
+	 */
+	bool DrawCell(Bitmap& dst, int x, int y, Rect const& cell_rect, Tone const& tone, int opacity, double zoom);
 	virtual void ProcessAnimationTiming(const lcf::rpg::AnimationTiming& timing);
 	virtual void ProcessAnimationFlash(const lcf::rpg::AnimationTiming& timing);
 	void OnBattleSpriteReady(FileRequestResult* result);
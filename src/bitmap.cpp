@@ -34,13 +34,100 @@
 #include "image_xyz.h"
 #include "image_bmp.h"
 #include "image_png.h"
+#include "image_out.h"
 #include "transform.h"
 #include "font.h"
 #include "output.h"
 #include "util_macro.h"
 #include "bitmap_hslrgb.h"
+#include "thread_pool.h"
 #include <iostream>
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#endif
+
+namespace {
+	/** x * a / 255 rounded like pixman does */
+	inline uint32_t MulUn8(uint32_t x, uint32_t a) {
+		uint32_t t = x * a + 0x80;
+		return ((t >> 8) + t) >> 8;
+	}
+
+	/**
+	 * Combines a row of pixels with AND and OR. All pixels are opaque when the
+	 * alpha bits of the AND result are set, all are transparent when the alpha
+	 * bits of the OR result are clear.
+	 */
+	void AccumulateOpacity(const uint32_t* p, int n, uint32_t& all, uint32_t& any) {
+		int i = 0;
+#if defined(__SSE2__)
+		if (n >= 4) {
+			__m128i vall = _mm_set1_epi32(-1);
+			__m128i vany = _mm_setzero_si128();
+			for (; i + 4 <= n; i += 4) {
+				__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+				vall = _mm_and_si128(vall, px);
+				vany = _mm_or_si128(vany, px);
+			}
+			// Fold the four lanes
+			vall = _mm_and_si128(vall, _mm_shuffle_epi32(vall, _MM_SHUFFLE(1, 0, 3, 2)));
+			vall = _mm_and_si128(vall, _mm_shuffle_epi32(vall, _MM_SHUFFLE(2, 3, 0, 1)));
+			vany = _mm_or_si128(vany, _mm_shuffle_epi32(vany, _MM_SHUFFLE(1, 0, 3, 2)));
+			vany = _mm_or_si128(vany, _mm_shuffle_epi32(vany, _MM_SHUFFLE(2, 3, 0, 1)));
+			all &= static_cast<uint32_t>(_mm_cvtsi128_si32(vall));
+			any |= static_cast<uint32_t>(_mm_cvtsi128_si32(vany));
+		}
+#elif defined(__ARM_NEON)
+		if (n >= 4) {
+			uint32x4_t vall = vdupq_n_u32(0xFFFFFFFF);
+			uint32x4_t vany = vdupq_n_u32(0);
+			for (; i + 4 <= n; i += 4) {
+				uint32x4_t px = vld1q_u32(p + i);
+				vall = vandq_u32(vall, px);
+				vany = vorrq_u32(vany, px);
+			}
+			all &= vgetq_lane_u32(vall, 0) & vgetq_lane_u32(vall, 1) & vgetq_lane_u32(vall, 2) & vgetq_lane_u32(vall, 3);
+			any |= vgetq_lane_u32(vany, 0) | vgetq_lane_u32(vany, 1) | vgetq_lane_u32(vany, 2) | vgetq_lane_u32(vany, 3);
+		}
+#endif
+		for (; i < n; ++i) {
+			all &= p[i];
+			any |= p[i];
+		}
+	}
+
+	/**
+	 * Classifies the rows of an image.
+	 *
+	 * @param p first pixel
+	 * @param stride pixels per row
+	 * @param width pixels to check per row
+	 * @param height rows to check
+	 * @param mask alpha bits
+	 */
+	ImageOpacity ComputeOpacity(const uint32_t* p, int stride, int width, int height, uint32_t mask) {
+		uint32_t all = 0xFFFFFFFF;
+		uint32_t any = 0;
+
+		for (int y = 0; y < height; ++y) {
+			AccumulateOpacity(p + y * stride, width, all, any);
+
+			if ((all & mask) != mask && (any & mask) != 0) {
+				// Neither opaque nor transparent, the other rows do not matter
+				return ImageOpacity::Partial;
+			}
+		}
+
+		return
+			(any & mask) == 0 ? ImageOpacity::Transparent :
+			(all & mask) == mask ? ImageOpacity::Opaque :
+			ImageOpacity::Partial;
+	}
+}
+
 BitmapRef Bitmap::Create(int width, int height, const Color& color) {
 	BitmapRef surface = Bitmap::Create(width, height, true);
 	surface->Fill(color);
@@ -95,14 +182,13 @@ Bitmap::Bitmap(Filesystem_Stream::InputStream stream, bool transparent, uint32_t
 	format = (transparent ? pixel_format : opaque_pixel_format);
 	pixman_format = find_format(format);
 
+	// Image constructors can run on a decoding thread
 	if (!stream) {
-		Output::Error("Couldn't read image file {}", stream.GetName());
+		Output::ErrorOrDefer("Couldn't read image file {}", stream.GetName());
 		return;
 	}
 
-	int w = 0;
-	int h = 0;
-	void* pixels = nullptr;
+	ImageOut image;
 
 	uint8_t data[4] = {};
 	size_t bytes = stream.read(reinterpret_cast<char*>(data),  4).gcount();
@@ -111,23 +197,32 @@ Bitmap::Bitmap(Filesystem_Stream::InputStream stream, bool transparent, uint32_t
 	bool img_okay = false;
 
 	if (bytes >= 4 && strncmp((char*)data, "XYZ1", 4) == 0)
-		img_okay = ImageXYZ::ReadXYZ(stream, transparent, w, h, pixels);
+		img_okay = ImageXYZ::ReadXYZ(stream, transparent, image);
 	else if (bytes > 2 && strncmp((char*)data, "BM", 2) == 0)
-		img_okay = ImageBMP::ReadBMP(stream, transparent, w, h, pixels);
+		img_okay = ImageBMP::ReadBMP(stream, transparent, image);
 	else if (bytes >= 4 && strncmp((char*)(data + 1), "PNG", 3) == 0)
-		img_okay = ImagePNG::ReadPNG(stream, transparent, w, h, pixels);
+		img_okay = ImagePNG::ReadPNG(stream, transparent, image);
 	else
 		Output::Warning("Unsupported image file {} (Magic: {:02X})", stream.GetName(), *reinterpret_cast<uint32_t*>(data));
 
 	if (!img_okay) {
-		free(pixels);
-		pixels = nullptr;
+		free(image.pixels);
 		return;
 	}
 
-	Init(w, h, nullptr);
+	if (!InitIndexed(image, flags)) {
+		Init(image.width, image.height, nullptr);
+		if (!bitmap) {
+			free(image.pixels);
+			return;
+		}
+
+		ConvertImage(image, transparent);
+	}
 
-	ConvertImage(w, h, pixels, transparent);
+	if (!bitmap) {
+		return;
+	}
 
 	CheckPixels(flags);
 }
@@ -136,29 +231,37 @@ Bitmap::Bitmap(const uint8_t* data, unsigned bytes, bool transparent, uint32_t f
 	format = (transparent ? pixel_format : opaque_pixel_format);
 	pixman_format = find_format(format);
 
-	int w = 0, h = 0;
-	void* pixels = nullptr;
+	ImageOut image;
 
 	bool img_okay = false;
 
 	if (bytes > 4 && strncmp((char*) data, "XYZ1", 4) == 0)
-		img_okay = ImageXYZ::ReadXYZ(data, bytes, transparent, w, h, pixels);
+		img_okay = ImageXYZ::ReadXYZ(data, bytes, transparent, image);
 	else if (bytes > 2 && strncmp((char*) data, "BM", 2) == 0)
-		img_okay = ImageBMP::ReadBMP(data, bytes, transparent, w, h, pixels);
+		img_okay = ImageBMP::ReadBMP(data, bytes, transparent, image);
 	else if (bytes > 4 && strncmp((char*)(data + 1), "PNG", 3) == 0)
-		img_okay = ImagePNG::ReadPNG((const void*) data, transparent, w, h, pixels);
+		img_okay = ImagePNG::ReadPNG((const void*) data, transparent, image);
 	else
 		Output::Warning("Unsupported image (Magic: {:02X})", bytes >= 4 ? *reinterpret_cast<const uint32_t*>(data) : 0);
 
 	if (!img_okay) {
-		free(pixels);
-		pixels = nullptr;
+		free(image.pixels);
 		return;
 	}
 
-	Init(w, h, nullptr);
+	if (!InitIndexed(image, flags)) {
+		Init(image.width, image.height, nullptr);
+		if (!bitmap) {
+			free(image.pixels);
+			return;
+		}
+
+		ConvertImage(image, transparent);
+	}
 
-	ConvertImage(w, h, pixels, transparent);
+	if (!bitmap) {
+		return;
+	}
 
 	CheckPixels(flags);
 }
@@ -190,54 +293,30 @@ size_t Bitmap::GetSize() const {
 		return 0;
 	}
 
-	return pitch() * height();
+	size_t size = pitch() * height();
+	if (indexed_palette) {
+		size += sizeof(pixman_indexed_t);
+	}
+	return size;
 }
 
 ImageOpacity Bitmap::ComputeImageOpacity() const {
-	bool all_opaque = true;
-	bool all_transp = true;
-
-	auto* p = reinterpret_cast<const uint32_t*>(pixels());
-	const auto mask = pixel_format.rgba_to_uint32_t(0, 0, 0, 0xFF);
-
-	int n = GetSize() / sizeof(uint32_t);
-	for (int i = 0; i < n; ++i ) {
-		auto px = p[i] & mask;
-		all_opaque &= (px == mask);
-		all_transp &= (px == 0);
-	}
-
-	return
-		all_transp ? ImageOpacity::Transparent :
-		all_opaque ? ImageOpacity::Opaque :
-		ImageOpacity::Partial;
+	return ComputeImageOpacity(GetRect());
 }
 
 ImageOpacity Bitmap::ComputeImageOpacity(Rect rect) const {
-	bool all_opaque = true;
-	bool all_transp = true;
-
 	const auto full_rect = GetRect();
 	rect = full_rect.GetSubRect(rect);
 
+	if (indexed_palette) {
+		return ComputeIndexedOpacity(rect);
+	}
+
 	auto* p = reinterpret_cast<const uint32_t*>(pixels());
 	const int stride = pitch() / sizeof(uint32_t);
 	const auto mask = pixel_format.rgba_to_uint32_t(0, 0, 0, 0xFF);
 
-	int xend = (rect.x + rect.width);
-	int yend = (rect.y + rect.height);
-	for (int y = rect.y * stride; y < yend * stride; y += stride) {
-		for (int x = rect.x; x < xend; ++x) {
-			auto px = p[x + y] & mask;
-			all_transp &= (px == 0);
-			all_opaque &= (px == mask);
-		}
-	}
-
-	return
-		all_transp ? ImageOpacity::Transparent :
-		all_opaque ? ImageOpacity::Opaque :
-		ImageOpacity::Partial;
+	return ComputeOpacity(p + rect.x + rect.y * stride, stride, rect.width, rect.height, mask);
 }
 
 void Bitmap::CheckPixels(uint32_t flags) {
@@ -270,10 +349,58 @@ void Bitmap::CheckPixels(uint32_t flags) {
 	if (flags & Flag_ReadOnly) {
 		read_only = true;
 
+		if ((flags & Flag_Chipset) && TilesCoverImage()) {
+			image_opacity = tile_opacity.GetCombined();
+		} else {
+			image_opacity = ComputeImageOpacity();
+		}
+	}
+}
+
+ImageOpacity Bitmap::ComputeIndexedOpacity(Rect rect) const {
+	// Bit 0: opaque, bit 1: transparent
+	uint8_t classes[256];
+	for (int i = 0; i < 256; ++i) {
+		auto alpha = indexed_palette->rgba[i] >> 24;
+		classes[i] = (alpha == 0xFF ? 1 : 0) | (alpha == 0 ? 2 : 0);
+	}
+
+	auto* p = reinterpret_cast<const uint8_t*>(pixels());
+	const int stride = pitch();
+
+	uint8_t all = 3;
+	for (int y = rect.y; y < rect.y + rect.height; ++y) {
+		auto* row = p + y * stride;
+		for (int x = rect.x; x < rect.x + rect.width; ++x) {
+			all &= classes[row[x]];
+		}
+
+		if (all == 0) {
+			return ImageOpacity::Partial;
+		}
+	}
+
+	return
+		(all & 2) ? ImageOpacity::Transparent :
+		(all & 1) ? ImageOpacity::Opaque :
+		ImageOpacity::Partial;
+}
+
+void Bitmap::SetTileOpacity(TileOpacity opacity) {
+	tile_opacity = std::move(opacity);
+	read_only = true;
+
+	if (TilesCoverImage()) {
+		image_opacity = tile_opacity.GetCombined();
+	} else {
 		image_opacity = ComputeImageOpacity();
 	}
 }
 
+bool Bitmap::TilesCoverImage() const {
+	return tile_opacity.GetWidth() * TILE_SIZE == width() && tile_opacity.GetHeight() * TILE_SIZE == height();
+}
+
 void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect_, double hue_) {
 	Rect dst_rect(x, y, 0, 0), src_rect = src_rect_;
 
@@ -426,6 +553,77 @@ DynamicFormat Bitmap::opaque_pixel_format;
 DynamicFormat Bitmap::image_format;
 DynamicFormat Bitmap::opaque_image_format;
 
+namespace {
+	std::unique_ptr<ThreadPool> composite_pool;
+
+	/** Minimum destination area of a composite to split it into bands */
+	constexpr int parallel_min_pixels = 128 * 128;
+	/** Minimum height of one band */
+	constexpr int parallel_min_band_height = 16;
+
+	/**
+	 * Wrapper around pixman_image_composite32 which splits large composites
+	 * into horizontal bands of the destination and runs them on the
+	 * composite thread pool.
+	 */
+	void Composite(pixman_op_t op, pixman_image_t* src, pixman_image_t* mask, pixman_image_t* dst,
+			int32_t src_x, int32_t src_y, int32_t mask_x, int32_t mask_y,
+			int32_t dst_x, int32_t dst_y, int32_t width, int32_t height) {
+		const int y0 = std::max(dst_y, 0);
+		const int y1 = std::min(dst_y + height, pixman_image_get_height(dst));
+		const int rows = y1 - y0;
+		int bands = 0;
+		// Bands must not read pixels another band writes
+		if (composite_pool && src != dst && mask != dst && width * rows >= parallel_min_pixels) {
+			bands = std::min(composite_pool->GetNumThreads() + 1, rows / parallel_min_band_height);
+		}
+
+		if (bands < 2) {
+			pixman_image_composite32(op, src, mask, dst, src_x, src_y, mask_x, mask_y, dst_x, dst_y, width, height);
+			return;
+		}
+
+		// pixman validates changed image properties lazily on the next composite.
+		// An empty composite does this on the calling thread, so the bands only read.
+		pixman_image_composite32(op, src, mask, dst, 0, 0, 0, 0, 0, 0, 0, 0);
+
+		composite_pool->ParallelFor(bands, [&](int band) {
+			const int by0 = y0 + rows * band / bands;
+			const int by1 = y0 + rows * (band + 1) / bands;
+			const int offset = by0 - dst_y;
+			pixman_image_composite32(op, src, mask, dst,
+					src_x, src_y + offset,
+					mask_x, mask_y + offset,
+					dst_x, by0,
+					width, by1 - by0);
+		});
+	}
+} // anonymous namespace
+
+void Bitmap::SetCompositeThreads(int threads) {
+	if (threads <= 1) {
+		composite_pool.reset();
+		return;
+	}
+
+	// The calling thread composites one of the bands
+	composite_pool.reset(new ThreadPool(threads - 1));
+}
+
+namespace {
+	bool indexed_storage = false;
+
+	/**
+	 * Below this amount of pixels the saved memory does not outweigh the
+	 * palette of an indexed bitmap
+	 */
+	constexpr int indexed_min_pixels = 128 * 128;
+}
+
+void Bitmap::SetIndexedStorage(bool enabled) {
+	indexed_storage = enabled;
+}
+
 void Bitmap::SetFormat(const DynamicFormat& format) {
 	pixel_format = format;
 	opaque_pixel_format = format;
@@ -481,7 +679,8 @@ void Bitmap::Init(int width, int height, void* data, int pitch, bool destroy) {
 	bitmap.reset(pixman_image_create_bits(pixman_format, width, height, (uint32_t*) data, pitch));
 
 	if (bitmap == NULL) {
-		Output::Error("Couldn't create {}x{} image.", width, height);
+		Output::ErrorOrDefer("Couldn't create {}x{} image.", width, height);
+		return;
 	}
 
 	if (format.bits == 8) {
@@ -493,25 +692,227 @@ void Bitmap::Init(int width, int height, void* data, int pitch, bool destroy) {
 		pixman_image_set_destroy_function(bitmap.get(), destroy_func, data);
 }
 
-void Bitmap::ConvertImage(int& width, int& height, void*& pixels, bool transparent) {
-	const DynamicFormat& img_format = transparent ? image_format : opaque_image_format;
+/**
+ * Table of the final pixel values of a palette.
+ */
+struct Bitmap::PaletteLut {
+	uint32_t pixels[256];
+	/** Shift of the alpha byte, opaque formats store 255 in the unused byte */
+	int alpha_shift = 24;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+	/** Byte b of the pixels, split into the four 64 entry TBL tables */
+	uint8x16x4_t planes[4][4];
+#endif
+
+	/** Must be called after all pixels are set */
+	void Prepare() {
+#if defined(__ARM_NEON) && defined(__aarch64__)
+		uint8_t bytes[4][256];
+		for (int i = 0; i < 256; ++i) {
+			for (int b = 0; b < 4; ++b) {
+				bytes[b][i] = static_cast<uint8_t>(pixels[i] >> (b * 8));
+			}
+		}
+		for (int b = 0; b < 4; ++b) {
+			for (int q = 0; q < 4; ++q) {
+				const uint8_t* table = bytes[b] + q * 64;
+				planes[b][q] = { { vld1q_u8(table), vld1q_u8(table + 16), vld1q_u8(table + 32), vld1q_u8(table + 48) } };
+			}
+		}
+#endif
+	}
+
+	/** Expands n palette indices from src to dst */
+	void Expand(uint32_t* dst, const uint8_t* src, int n) const;
+
+	/**
+	 * Composites n palette indices from src over dst like PIXMAN_OP_OVER
+	 * with a solid mask.
+	 *
+	 * @param opacity opacity of the mask
+	 */
+	void Over(uint32_t* dst, const uint8_t* src, int n, uint32_t opacity) const;
+};
+
+void Bitmap::PaletteLut::Expand(uint32_t* dst, const uint8_t* src, int n) const {
+	int x = 0;
+#if defined(__SSE2__)
+	// No gather instruction: The lookups stay scalar, but the indices are
+	// read and the pixels written 16 bytes at a time
+	for (; x + 16 <= n; x += 16) {
+		__m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+		for (int k = 0; k < 4; ++k) {
+			uint32_t i4 = static_cast<uint32_t>(_mm_cvtsi128_si32(idx));
+			idx = _mm_srli_si128(idx, 4);
+			__m128i px = _mm_setr_epi32(
+				pixels[i4 & 0xFF], pixels[(i4 >> 8) & 0xFF],
+				pixels[(i4 >> 16) & 0xFF], pixels[i4 >> 24]);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + k * 4), px);
+		}
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	// TBL looks up 16 bytes in a 64 byte table, TBX keeps the lanes whose
+	// index is out of range. Four lookups per byte plane cover the palette
+	// and ST4 interleaves the planes into pixels.
+	const uint8x16_t quarter = vdupq_n_u8(64);
+	for (; x + 16 <= n; x += 16) {
+		const uint8x16_t idx0 = vld1q_u8(src + x);
+		const uint8x16_t idx1 = vsubq_u8(idx0, quarter);
+		const uint8x16_t idx2 = vsubq_u8(idx1, quarter);
+		const uint8x16_t idx3 = vsubq_u8(idx2, quarter);
+		uint8x16x4_t px;
+		for (int b = 0; b < 4; ++b) {
+			uint8x16_t v = vqtbl4q_u8(planes[b][0], idx0);
+			v = vqtbx4q_u8(v, planes[b][1], idx1);
+			v = vqtbx4q_u8(v, planes[b][2], idx2);
+			px.val[b] = vqtbx4q_u8(v, planes[b][3], idx3);
+		}
+		vst4q_u8(reinterpret_cast<uint8_t*>(dst + x), px);
+	}
+#endif
+	for (; x < n; ++x) {
+		dst[x] = pixels[src[x]];
+	}
+}
+
+void Bitmap::PaletteLut::Over(uint32_t* dst, const uint8_t* src, int n, uint32_t opacity) const {
+	for (int x = 0; x < n; ++x) {
+		uint32_t s = pixels[src[x]];
+		if (opacity < 255) {
+			s = (MulUn8(s & 0xFF, opacity))
+				| (MulUn8((s >> 8) & 0xFF, opacity) << 8)
+				| (MulUn8((s >> 16) & 0xFF, opacity) << 16)
+				| (MulUn8(s >> 24, opacity) << 24);
+		}
+
+		const uint32_t sa = (s >> alpha_shift) & 0xFF;
+		if (sa == 0) {
+			continue;
+		}
+		if (sa == 255) {
+			dst[x] = s;
+			continue;
+		}
+
+		// Saturating s + d * (255 - sa) per channel
+		const uint32_t ia = 255 - sa;
+		const uint32_t d = dst[x];
+		uint32_t out = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			const uint32_t c = ((s >> shift) & 0xFF) + MulUn8((d >> shift) & 0xFF, ia);
+			out |= std::min<uint32_t>(c, 255) << shift;
+		}
+		dst[x] = out;
+	}
+}
+
+bool Bitmap::InitIndexed(ImageOut& image, uint32_t flags) {
+	// Only images which are never written to: Drawing onto an indexed image
+	// would have to map every color back to the palette
+	if (!indexed_storage || !image.indexed || !(flags & Flag_ReadOnly) || format.bits != 32 ||
+			image.width * image.height < indexed_min_pixels) {
+		return false;
+	}
 
-	// premultiply alpha
-	for (int y = 0; y < height; y++) {
-		uint8_t* dst = (uint8_t*) pixels + y * width * 4;
-		for (int x = 0; x < width; x++) {
-			uint8_t &r = *dst++;
-			uint8_t &g = *dst++;
-			uint8_t &b = *dst++;
-			uint8_t &a = *dst++;
+	indexed_palette.reset(new pixman_indexed_t());
+	indexed_palette->color = true;
+	auto lut = std::make_shared<PaletteLut>();
+	uint32_t alpha_mask = format.a.mask;
+	if (format.alpha_type != PF::Alpha) {
+		alpha_mask = ~(format.r.mask | format.g.mask | format.b.mask);
+	}
+	lut->alpha_shift = alpha_mask & 0xFF ? 0 : alpha_mask & 0xFF00 ? 8 : alpha_mask & 0xFF0000 ? 16 : 24;
+	for (int i = 0; i < 256; ++i) {
+		uint8_t r = image.palette[i][0];
+		uint8_t g = image.palette[i][1];
+		uint8_t b = image.palette[i][2];
+		uint8_t a = image.palette[i][3];
+		MultiplyAlpha(r, g, b, a);
+		// pixman expects premultiplied a8r8g8b8 palette entries
+		indexed_palette->rgba[i] = (uint32_t(a) << 24) | (uint32_t(r) << 16) | (uint32_t(g) << 8) | b;
+		lut->pixels[i] = format.rgba_to_uint32_t(r, g, b, a) | (format.alpha_type == PF::Alpha ? 0 : alpha_mask);
+	}
+	lut->Prepare();
+	indexed_lut = std::move(lut);
+
+	pixman_format = PIXMAN_c8;
+	bitmap.reset(pixman_image_create_bits(pixman_format, image.width, image.height, nullptr, 0));
+	if (bitmap == NULL) {
+		Output::ErrorOrDefer("Couldn't create {}x{} image.", image.width, image.height);
+		free(image.pixels);
+		return true;
+	}
+	pixman_image_set_indexed(bitmap.get(), indexed_palette.get());
+
+	auto* dst = reinterpret_cast<uint8_t*>(pixels());
+	const auto* src = reinterpret_cast<const uint8_t*>(image.pixels);
+	for (int y = 0; y < image.height; ++y) {
+		std::memcpy(dst + y * pitch(), src + y * image.width, image.width);
+	}
+	free(image.pixels);
+
+	return true;
+}
+
+void Bitmap::ConvertImage(ImageOut& image, bool transparent) {
+	const DynamicFormat& img_format = transparent ? image_format : opaque_image_format;
+	const int width = image.width;
+	const int height = image.height;
+
+	if (image.indexed) {
+		// Build the palette once in the target format, premultiplied and
+		// with the transparent color already applied
+		const bool direct = (format.bits == 32);
+		const DynamicFormat& lut_format = direct ? format : img_format;
+		PaletteLut lut;
+		for (int i = 0; i < 256; ++i) {
+			uint8_t r = image.palette[i][0];
+			uint8_t g = image.palette[i][1];
+			uint8_t b = image.palette[i][2];
+			uint8_t a = image.palette[i][3];
 			MultiplyAlpha(r, g, b, a);
+			lut.pixels[i] = lut_format.rgba_to_uint32_t(r, g, b, a);
+		}
+		lut.Prepare();
+
+		const uint8_t* src = (const uint8_t*) image.pixels;
+		if (direct) {
+			auto* dst = (uint8_t*) pixels();
+			for (int y = 0; y < height; y++) {
+				lut.Expand((uint32_t*) (dst + y * pitch()), src + y * width, width);
+			}
+			free(image.pixels);
+			return;
+		}
+
+		// Other formats are converted by pixman from RGBA8
+		void* rgba = malloc(width * height * 4);
+		if (!rgba) {
+			Output::Warning("Error allocating image pixel buffer.");
+			free(image.pixels);
+			return;
+		}
+		lut.Expand((uint32_t*) rgba, src, width * height);
+		free(image.pixels);
+		image.pixels = rgba;
+	} else {
+		// premultiply alpha
+		for (int y = 0; y < height; y++) {
+			uint8_t* dst = (uint8_t*) image.pixels + y * width * 4;
+			for (int x = 0; x < width; x++) {
+				uint8_t &r = *dst++;
+				uint8_t &g = *dst++;
+				uint8_t &b = *dst++;
+				uint8_t &a = *dst++;
+				MultiplyAlpha(r, g, b, a);
+			}
 		}
 	}
 
-	Bitmap src(pixels, width, height, 0, img_format);
+	Bitmap src(image.pixels, width, height, 0, img_format);
 	Clear();
 	Blit(0, 0, src, src.GetRect(), Opacity::Opaque());
-	free(pixels);
+	free(image.pixels);
 }
 
 void* Bitmap::pixels() {
@@ -574,9 +975,16 @@ void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity
 		return;
 	}
 
+	if (!opacity.IsSplit()) {
+		const bool over = !opacity.IsOpaque() || src.GetOperator() == PIXMAN_OP_OVER;
+		if (PaletteBlit(x, y, src, src_rect, std::min(opacity.Value(), 255), over)) {
+			return;
+		}
+	}
+
 	auto mask = CreateMask(opacity, src_rect);
 
-	pixman_image_composite32(src.GetOperator(mask.get()),
+	Composite(src.GetOperator(mask.get()),
 							 src.bitmap.get(),
 							 mask.get(), bitmap.get(),
 							 src_rect.x, src_rect.y,
@@ -590,7 +998,11 @@ void Bitmap::BlitFast(int x, int y, Bitmap const & src, Rect const & src_rect, O
 		return;
 	}
 
-	pixman_image_composite32(PIXMAN_OP_SRC,
+	if (PaletteBlit(x, y, src, src_rect, 255, false)) {
+		return;
+	}
+
+	Composite(PIXMAN_OP_SRC,
 		src.bitmap.get(),
 		nullptr, bitmap.get(),
 		src_rect.x, src_rect.y,
@@ -599,10 +1011,64 @@ void Bitmap::BlitFast(int x, int y, Bitmap const & src, Rect const & src_rect, O
 		src_rect.width, src_rect.height);
 }
 
+bool Bitmap::PaletteBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int opacity, bool over) {
+	if (!src.indexed_lut || format.bits != 32 || bitmap == src.bitmap) {
+		return false;
+	}
+	// The palette is stored in the format of src, the alpha byte of an
+	// opaque destination is never read
+	const auto& lut = *src.indexed_lut;
+	if (format.r.shift != src.format.r.shift || format.g.shift != src.format.g.shift ||
+		format.b.shift != src.format.b.shift ||
+		(format.alpha_type == PF::Alpha && format.a.shift != lut.alpha_shift)) {
+		return false;
+	}
+	// pixman reads transparent pixels outside of src, which SRC writes
+	if (src_rect.x < 0 || src_rect.y < 0 ||
+		src_rect.x + src_rect.width > src.width() || src_rect.y + src_rect.height > src.height()) {
+		return false;
+	}
+
+	int sx = src_rect.x;
+	int sy = src_rect.y;
+	int w = src_rect.width;
+	int h = src_rect.height;
+	if (x < 0) {
+		sx -= x;
+		w += x;
+		x = 0;
+	}
+	if (y < 0) {
+		sy -= y;
+		h += y;
+		y = 0;
+	}
+	w = std::min(w, width() - x);
+	h = std::min(h, height() - y);
+	if (w <= 0 || h <= 0) {
+		return true;
+	}
+
+	for (int row = 0; row < h; ++row) {
+		const uint8_t* src_row = static_cast<const uint8_t*>(src.pixels()) + (sy + row) * src.pitch() + sx;
+		uint32_t* dst_row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pixels()) + (y + row) * pitch()) + x;
+		if (over) {
+			lut.Over(dst_row, src_row, w, opacity);
+		} else {
+			lut.Expand(dst_row, src_row, w);
+		}
+	}
+	return true;
+}
+
 PixmanImagePtr Bitmap::GetSubimage(Bitmap const& src, const Rect& src_rect) {
 	uint8_t* pixels = (uint8_t*) src.pixels() + src_rect.x * src.bpp() + src_rect.y * src.pitch();
-	return PixmanImagePtr{ pixman_image_create_bits(src.pixman_format, src_rect.width, src_rect.height,
+	auto image = PixmanImagePtr{ pixman_image_create_bits(src.pixman_format, src_rect.width, src_rect.height,
 									(uint32_t*) pixels, src.pitch()) };
+	if (src.indexed_palette) {
+		pixman_image_set_indexed(image.get(), src.indexed_palette.get());
+	}
+	return image;
 }
 
 void Bitmap::TiledBlit(Rect const& src_rect, Bitmap const& src, Rect const& dst_rect, Opacity const& opacity) {
@@ -625,7 +1091,7 @@ void Bitmap::TiledBlit(int ox, int oy, Rect const& src_rect, Bitmap const& src,
 
 	auto mask = CreateMask(opacity, src_rect);
 
-	pixman_image_composite32(src.GetOperator(mask.get()),
+	Composite(src.GetOperator(mask.get()),
 							 src_bm.get(), mask.get(), bitmap.get(),
 							 ox, oy,
 							 0, 0,
@@ -651,7 +1117,7 @@ void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& sr
 
 	auto mask = CreateMask(opacity, src_rect, &xform);
 
-	pixman_image_composite32(src.GetOperator(mask.get()),
+	Composite(src.GetOperator(mask.get()),
 							 src.bitmap.get(), mask.get(), bitmap.get(),
 							 src_rect.x / zoom_x, src_rect.y / zoom_y,
 							 0, 0,
@@ -686,7 +1152,7 @@ void Bitmap::WaverBlit(int x, int y, double zoom_x, double zoom_y, Bitmap const&
 		const double sy = (i - yclip) * (2 * M_PI) / (32.0 * zoom_y);
 		const int offset = 2 * zoom_x * depth * std::sin(phase + sy);
 
-		pixman_image_composite32(src.GetOperator(mask.get()),
+		Composite(src.GetOperator(mask.get()),
 								 src.bitmap.get(), mask.get(), bitmap.get(),
 								 xoff, yoff + i,
 								 0, i,
@@ -719,7 +1185,7 @@ void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
 
 	auto timage = PixmanImagePtr{pixman_image_create_solid_fill(&pcolor)};
 
-	pixman_image_composite32(PIXMAN_OP_OVER,
+	Composite(PIXMAN_OP_OVER,
 			timage.get(), nullptr, bitmap.get(),
 			0, 0,
 			0, 0,
@@ -820,7 +1286,7 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 	}
 
 	if (&src != this)
-		pixman_image_composite32(src.GetOperator(),
+		Composite(src.GetOperator(),
 		src.bitmap.get(), nullptr, bitmap.get(),
 		src_rect.x, src_rect.y,
 		0, 0,
@@ -928,7 +1394,7 @@ void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, co
 	}
 
 	if (&src != this)
-		pixman_image_composite32(src.GetOperator(),
+		Composite(src.GetOperator(),
 								 src.bitmap.get(), nullptr, bitmap.get(),
 								 src_rect.x, src_rect.y,
 								 0, 0,
@@ -938,7 +1404,7 @@ void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, co
 	pixman_color_t tcolor = PixmanColor(color);
 	auto timage = PixmanImagePtr{ pixman_image_create_solid_fill(&tcolor) };
 
-	pixman_image_composite32(PIXMAN_OP_OVER,
+	Composite(PIXMAN_OP_OVER,
 							 timage.get(), src.bitmap.get(), bitmap.get(),
 							 0, 0,
 							 src_rect.x, src_rect.y,
@@ -993,7 +1459,7 @@ void Bitmap::Flip(bool horizontal, bool vertical) {
 
 	pixman_image_set_transform(temp.get(), &xform.matrix);
 
-	pixman_image_composite32(PIXMAN_OP_SRC,
+	Composite(PIXMAN_OP_SRC,
 							 temp.get(), nullptr, bitmap.get(),
 							 0, 0, 0, 0, 0, 0, w, h);
 }
@@ -1007,7 +1473,7 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 
 	auto source = PixmanImagePtr{ pixman_image_create_solid_fill(&tcolor) };
 
-	pixman_image_composite32(PIXMAN_OP_OVER,
+	Composite(PIXMAN_OP_OVER,
 							 source.get(), mask.bitmap.get(), bitmap.get(),
 							 0, 0,
 							 mx, my,
@@ -1016,7 +1482,7 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Bitmap const& src, int sx, int sy) {
-	pixman_image_composite32(PIXMAN_OP_OVER,
+	Composite(PIXMAN_OP_OVER,
 							 src.bitmap.get(), mask.bitmap.get(), bitmap.get(),
 							 sx, sy,
 							 mx, my,
@@ -1025,11 +1491,17 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::Blit2x(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect) {
+	if (src_rect.x == 0 && src_rect.y == 0 &&
+			dst_rect.width == src_rect.width * 2 && dst_rect.height == src_rect.height * 2 &&
+			ScaleBlit(dst_rect.x, dst_rect.y, src, src_rect, 2)) {
+		return;
+	}
+
 	Transform xform = Transform::Scale(0.5, 0.5);
 
 	pixman_image_set_transform(src.bitmap.get(), &xform.matrix);
 
-	pixman_image_composite32(PIXMAN_OP_SRC,
+	Composite(PIXMAN_OP_SRC,
 							 src.bitmap.get(), nullptr, bitmap.get(),
 							 src_rect.x, src_rect.y,
 							 0, 0,
@@ -1101,7 +1573,7 @@ void Bitmap::RotateZoomOpacityBlit(int x, int y, int ox, int oy,
 
 	auto mask = CreateMask(opacity, src_rect, &inv);
 
-	pixman_image_composite32(PIXMAN_OP_OVER,
+	Composite(PIXMAN_OP_OVER,
 							 src_img, mask.get(), bitmap.get(),
 							 dst_rect.x, dst_rect.y,
 							 dst_rect.x, dst_rect.y,
@@ -1128,6 +1600,667 @@ void Bitmap::ZoomOpacityBlit(int x, int y, int ox, int oy,
 	StretchBlit(dst_rect, src, src_rect, opacity);
 }
 
+namespace {
+	inline int64_t FloorDiv(int64_t a, int64_t b) {
+		return a >= 0 ? a / b : -((b - 1 - a) / b);
+	}
+
+	inline int64_t CeilDiv(int64_t a, int64_t b) {
+		return -FloorDiv(-a, b);
+	}
+
+	/** Narrows [begin, end) to the steps i for which v + i * u is in [lo, hi] */
+	void ClipSpan(int64_t v, int64_t u, int64_t lo, int64_t hi, int& begin, int& end) {
+		int64_t b = begin;
+		int64_t e = end;
+		if (u == 0) {
+			if (v < lo || v > hi) {
+				e = b;
+			}
+		} else if (u > 0) {
+			b = std::max(b, CeilDiv(lo - v, u));
+			e = std::min(e, FloorDiv(hi - v, u) + 1);
+		} else {
+			b = std::max(b, CeilDiv(v - hi, -u));
+			e = std::min(e, FloorDiv(v - lo, -u) + 1);
+		}
+		begin = static_cast<int>(b);
+		end = static_cast<int>(std::max(b, e));
+	}
+
+	struct AffineEffects {
+		/** Pixels of the rectangle the effects apply to */
+		const uint8_t* src;
+		int src_pitch;
+		int region_width;
+		int region_height;
+		/** Rectangle of the region which is sampled */
+		Rect bounds;
+		bool flip_x;
+		bool flip_y;
+		/** Maps destination pixel centers to bounds */
+		pixman_transform_t xform;
+		/** Maps destination pixel centers to the split opacity mask */
+		pixman_transform_t mask_xform;
+		bool split;
+		uint32_t top;
+		uint32_t bottom;
+		bool saturation;
+		int sat;
+		bool color;
+		Tone tone;
+		bool flash;
+		/** Premultiplied flash color in r, g, b, a order */
+		uint32_t flash_color[4];
+		int rs, gs, bs, as;
+	};
+
+	/** @return pixel at the transformed position (vx, vy) with the tone applied, 0 when transparent */
+	inline uint32_t AffineSample(const AffineEffects& e, int64_t vx, int64_t vy) {
+		int sx = e.bounds.x + static_cast<int>(vx >> 16);
+		int sy = e.bounds.y + static_cast<int>(vy >> 16);
+		if (e.flip_x) {
+			sx = e.region_width - 1 - sx;
+		}
+		if (e.flip_y) {
+			sy = e.region_height - 1 - sy;
+		}
+
+		uint32_t pixel = *reinterpret_cast<const uint32_t*>(e.src + sy * e.src_pitch + sx * 4);
+		if (((pixel >> e.as) & 0xFF) == 0) {
+			return 0;
+		}
+
+		if (e.saturation) {
+			saturation_tone(pixel, e.sat, e.rs, e.gs, e.bs, e.as);
+		}
+		if (e.color) {
+			color_tone(pixel, e.tone, e.rs, e.gs, e.bs, e.as);
+		}
+		return pixel;
+	}
+
+	/** @return alpha of pixel after the flash and the opacity are applied */
+	inline uint32_t AffineAlpha(const AffineEffects& e, uint32_t pixel, uint32_t opacity) {
+		uint32_t alpha = (pixel >> e.as) & 0xFF;
+		if (e.flash) {
+			const uint32_t fa = MulUn8(e.flash_color[3], alpha);
+			alpha = std::min<uint32_t>(255, fa + MulUn8(alpha, 255 - fa));
+		}
+		return MulUn8(alpha, opacity);
+	}
+
+	/** Blends pixel with the flash color and opacity over d */
+	inline uint32_t AffineBlend(const AffineEffects& e, uint32_t pixel, uint32_t opacity, uint32_t d) {
+		const int rs = e.rs, gs = e.gs, bs = e.bs, as = e.as;
+		const uint32_t alpha = (pixel >> as) & 0xFF;
+		uint32_t c[4] = { (pixel >> rs) & 0xFF, (pixel >> gs) & 0xFF, (pixel >> bs) & 0xFF, alpha };
+
+		if (e.flash) {
+			// Flash color over the pixel, masked by the pixel alpha
+			const uint32_t fa = MulUn8(e.flash_color[3], alpha);
+			for (int k = 0; k < 4; ++k) {
+				c[k] = std::min<uint32_t>(255, MulUn8(e.flash_color[k], alpha) + MulUn8(c[k], 255 - fa));
+			}
+		}
+
+		if (opacity < 255) {
+			for (auto& v: c) {
+				v = MulUn8(v, opacity);
+			}
+		}
+
+		const uint32_t ia = 255 - c[3];
+		return (std::min<uint32_t>(255, c[0] + MulUn8((d >> rs) & 0xFF, ia)) << rs)
+			| (std::min<uint32_t>(255, c[1] + MulUn8((d >> gs) & 0xFF, ia)) << gs)
+			| (std::min<uint32_t>(255, c[2] + MulUn8((d >> bs) & 0xFF, ia)) << bs)
+			| (std::min<uint32_t>(255, c[3] + MulUn8((d >> as) & 0xFF, ia)) << as);
+	}
+
+#if defined(__SSE2__)
+	/** MulUn8 on 16 bit lanes */
+	inline __m128i MulUn8x8(__m128i x, __m128i a) {
+		__m128i t = _mm_add_epi16(_mm_mullo_epi16(x, a), _mm_set1_epi16(0x80));
+		return _mm_srli_epi16(_mm_add_epi16(_mm_srli_epi16(t, 8), t), 8);
+	}
+
+	/** Two pixels widened to 16 bit lanes: factor a0 for the first, a1 for the second */
+	inline __m128i Splat2(uint32_t a0, uint32_t a1) {
+		return _mm_set_epi16(a1, a1, a1, a1, a0, a0, a0, a0);
+	}
+
+	/**
+	 * Four pixels of AffineBlend. The per pixel factors are passed in,
+	 * the channels are blended two pixels per register.
+	 */
+	inline void AffineBlend4(const AffineEffects& e, const uint32_t* pixels, const uint32_t* alpha, const uint32_t* keep,
+			const uint32_t* opacity, const uint32_t* inv_alpha, uint32_t* dst) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i max = _mm_set1_epi16(255);
+		const __m128i flash = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(
+				(e.flash_color[0] << e.rs) | (e.flash_color[1] << e.gs) | (e.flash_color[2] << e.bs) | (e.flash_color[3] << e.as))), zero);
+		const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+
+		__m128i out[2];
+		for (int h = 0; h < 2; ++h) {
+			const int k = h * 2;
+			__m128i c = h == 0 ? _mm_unpacklo_epi8(s, zero) : _mm_unpackhi_epi8(s, zero);
+			__m128i dc = h == 0 ? _mm_unpacklo_epi8(d, zero) : _mm_unpackhi_epi8(d, zero);
+			if (e.flash) {
+				c = _mm_min_epi16(max, _mm_add_epi16(
+						MulUn8x8(flash, Splat2(alpha[k], alpha[k + 1])),
+						MulUn8x8(c, Splat2(keep[k], keep[k + 1]))));
+			}
+			c = MulUn8x8(c, Splat2(opacity[k], opacity[k + 1]));
+			out[h] = _mm_min_epi16(max, _mm_add_epi16(c, MulUn8x8(dc, Splat2(inv_alpha[k], inv_alpha[k + 1]))));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(out[0], out[1]));
+	}
+#elif defined(__ARM_NEON)
+	/** MulUn8 on 16 bit lanes */
+	inline uint16x8_t MulUn8x8(uint16x8_t x, uint16x8_t a) {
+		uint16x8_t t = vaddq_u16(vmulq_u16(x, a), vdupq_n_u16(0x80));
+		return vshrq_n_u16(vaddq_u16(vshrq_n_u16(t, 8), t), 8);
+	}
+
+	/** Two pixels widened to 16 bit lanes: factor a0 for the first, a1 for the second */
+	inline uint16x8_t Splat2(uint32_t a0, uint32_t a1) {
+		return vcombine_u16(vdup_n_u16(static_cast<uint16_t>(a0)), vdup_n_u16(static_cast<uint16_t>(a1)));
+	}
+
+	/**
+	 * Four pixels of AffineBlend. The per pixel factors are passed in,
+	 * the channels are blended two pixels per register.
+	 */
+	inline void AffineBlend4(const AffineEffects& e, const uint32_t* pixels, const uint32_t* alpha, const uint32_t* keep,
+			const uint32_t* opacity, const uint32_t* inv_alpha, uint32_t* dst) {
+		const uint16x8_t max = vdupq_n_u16(255);
+		const uint16x8_t flash = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(
+				(e.flash_color[0] << e.rs) | (e.flash_color[1] << e.gs) | (e.flash_color[2] << e.bs) | (e.flash_color[3] << e.as))));
+		const uint8x16_t s = vreinterpretq_u8_u32(vld1q_u32(pixels));
+		const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst));
+
+		uint8x8_t out[2];
+		for (int h = 0; h < 2; ++h) {
+			const int k = h * 2;
+			uint16x8_t c = vmovl_u8(h == 0 ? vget_low_u8(s) : vget_high_u8(s));
+			uint16x8_t dc = vmovl_u8(h == 0 ? vget_low_u8(d) : vget_high_u8(d));
+			if (e.flash) {
+				c = vminq_u16(max, vaddq_u16(
+						MulUn8x8(flash, Splat2(alpha[k], alpha[k + 1])),
+						MulUn8x8(c, Splat2(keep[k], keep[k + 1]))));
+			}
+			c = MulUn8x8(c, Splat2(opacity[k], opacity[k + 1]));
+			out[h] = vmovn_u16(vminq_u16(max, vaddq_u16(c, MulUn8x8(dc, Splat2(inv_alpha[k], inv_alpha[k + 1])))));
+		}
+		vst1q_u32(dst, vreinterpretq_u32_u8(vcombine_u8(out[0], out[1])));
+	}
+#endif
+
+	/**
+	 * Draws count pixels of a destination row. Sampling is nearest neighbour
+	 * with pixman semantics: The transformed pixel center minus epsilon is
+	 * truncated and pixels outside of the source are transparent.
+	 * Only the span of pixels which sample inside of the source is visited.
+	 * The sampling is scalar, the blending runs on 4 pixels with SSE2 or NEON.
+	 *
+	 * @param e effects
+	 * @param dst first destination pixel
+	 * @param count number of pixels
+	 * @param v transformed center of the first pixel
+	 * @param mv transformed center of the first pixel in the mask
+	 */
+	void AffineRow(const AffineEffects& e, uint32_t* dst, int count, const pixman_vector_t& v, const pixman_vector_t& mv) {
+		const int64_t ux = e.xform.matrix[0][0];
+		const int64_t uy = e.xform.matrix[1][0];
+		const int64_t mux = e.mask_xform.matrix[0][0];
+		const int64_t muy = e.mask_xform.matrix[1][0];
+
+		int begin = 0;
+		int end = count;
+		ClipSpan(v.vector[0], ux, 1, static_cast<int64_t>(e.bounds.width) << 16, begin, end);
+		ClipSpan(v.vector[1], uy, 1, static_cast<int64_t>(e.bounds.height) << 16, begin, end);
+		if (e.split) {
+			// The mask is 1x2 pixels: top and bottom opacity
+			ClipSpan(mv.vector[0], mux, 1, int64_t(1) << 16, begin, end);
+			ClipSpan(mv.vector[1], muy, 1, int64_t(2) << 16, begin, end);
+		}
+
+		int64_t vx = v.vector[0] + begin * ux - pixman_fixed_e;
+		int64_t vy = v.vector[1] + begin * uy - pixman_fixed_e;
+		int64_t mvy = mv.vector[1] + begin * muy - pixman_fixed_e;
+
+		int i = begin;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+		for (; i + 4 <= end; i += 4) {
+			// Transparent pixels are 0 and blend to the unchanged destination
+			uint32_t pixels[4], alpha[4], keep[4], opacity[4], inv_alpha[4];
+			bool visible = false;
+			for (int k = 0; k < 4; ++k, vx += ux, vy += uy, mvy += muy) {
+				pixels[k] = AffineSample(e, vx, vy);
+				alpha[k] = (pixels[k] >> e.as) & 0xFF;
+				keep[k] = 255 - MulUn8(e.flash_color[3], alpha[k]);
+				opacity[k] = (e.split && (mvy >> 16) != 0) ? e.bottom : e.top;
+				inv_alpha[k] = 255 - AffineAlpha(e, pixels[k], opacity[k]);
+				visible |= alpha[k] != 0;
+			}
+			if (visible) {
+				AffineBlend4(e, pixels, alpha, keep, opacity, inv_alpha, dst + i);
+			}
+		}
+#endif
+		for (; i < end; ++i, vx += ux, vy += uy, mvy += muy) {
+			const uint32_t pixel = AffineSample(e, vx, vy);
+			if (pixel == 0) {
+				continue;
+			}
+
+			const uint32_t opacity = (e.split && (mvy >> 16) != 0) ? e.bottom : e.top;
+			dst[i] = AffineBlend(e, pixel, opacity, dst[i]);
+		}
+	}
+
+	/** Calls row for every row in [y0, y1), split into bands on the composite pool when large */
+	template <typename F>
+	void ForEachRow(int y0, int y1, int width, F&& row) {
+		const int rows = y1 - y0;
+		int bands = 0;
+		if (composite_pool && width * rows >= parallel_min_pixels) {
+			bands = std::min(composite_pool->GetNumThreads() + 1, rows / parallel_min_band_height);
+		}
+
+		if (bands < 2) {
+			for (int y = y0; y < y1; ++y) {
+				row(y);
+			}
+			return;
+		}
+
+		composite_pool->ParallelFor(bands, [&](int band) {
+			const int by1 = y0 + rows * (band + 1) / bands;
+			for (int y = y0 + rows * band / bands; y < by1; ++y) {
+				row(y);
+			}
+		});
+	}
+
+	/** @return transformed center of pixel (x, y) */
+	pixman_vector_t TransformCenter(const pixman_transform_t& xform, int x, int y) {
+		pixman_vector_t v = {{
+			pixman_int_to_fixed(x) + pixman_fixed_1 / 2,
+			pixman_int_to_fixed(y) + pixman_fixed_1 / 2,
+			pixman_fixed_1
+		}};
+		pixman_transform_point_3d(&xform, &v);
+		return v;
+	}
+} // anonymous namespace
+
+bool Bitmap::AffineBlit(int x, int y, int ox, int oy,
+		Bitmap const& src, Rect const& src_rect, Rect const& effect_rect,
+		Opacity const& opacity,
+		double zoom_x, double zoom_y, double angle,
+		int waver_depth, double waver_phase,
+		Tone const& tone, Color const& flash, bool flip_x, bool flip_y)
+{
+	if (bpp() != 4 || src.pixman_format != pixman_format || format.a.bits != 8) {
+		return false;
+	}
+
+	if (opacity.IsTransparent()) {
+		return true;
+	}
+
+	// The effects were applied to an effect bitmap of the size of effect_rect
+	// (flash and flip) or of the whole bitmap (tone) before. The geometry is
+	// calculated relative to that bitmap to sample the same pixels.
+	Rect region = src.GetRect();
+	Rect rect = src_rect;
+	if (flash.alpha != 0 || flip_x || flip_y) {
+		region = effect_rect;
+		rect = Rect(src_rect.x - effect_rect.x, src_rect.y - effect_rect.y, src_rect.width, src_rect.height);
+	}
+
+	if (rect.IsEmpty()) {
+		return true;
+	}
+
+	// Only rectangles inside of the bitmap, pixels outside are never read
+	auto inside = [](const Rect& r, int width, int height) {
+		return r.x >= 0 && r.y >= 0 && r.x + r.width <= width && r.y + r.height <= height;
+	};
+	if (!inside(region, src.GetWidth(), src.GetHeight()) || !inside(rect, region.width, region.height)) {
+		return false;
+	}
+
+	AffineEffects e;
+	e.src = reinterpret_cast<const uint8_t*>(src.pixels()) + region.y * src.pitch() + region.x * 4;
+	e.src_pitch = src.pitch();
+	e.region_width = region.width;
+	e.region_height = region.height;
+	e.bounds = Rect(0, 0, region.width, region.height);
+	e.flip_x = flip_x;
+	e.flip_y = flip_y;
+	e.split = opacity.IsSplit();
+	e.top = static_cast<uint32_t>(Utils::Clamp(opacity.top, 0, 255));
+	e.bottom = static_cast<uint32_t>(Utils::Clamp(opacity.bottom, 0, 255));
+	e.saturation = tone.gray != 128;
+	e.sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+	e.color = tone.red != 128 || tone.green != 128 || tone.blue != 128;
+	e.tone = tone;
+	e.flash = flash.alpha != 0;
+	e.flash_color[0] = (flash.red * flash.alpha) >> 8;
+	e.flash_color[1] = (flash.green * flash.alpha) >> 8;
+	e.flash_color[2] = (flash.blue * flash.alpha) >> 8;
+	e.flash_color[3] = flash.alpha;
+	e.rs = format.r.shift;
+	e.gs = format.g.shift;
+	e.bs = format.b.shift;
+	e.as = format.a.shift;
+
+	// Mask of the split opacity like created by CreateMask
+	auto mask_xform = [&](const Transform& xform) {
+		Transform mask = Transform::Scale(1.0 / rect.width, 1.0 / rect.height);
+		mask *= Transform::Translation(0, opacity.split);
+		mask *= xform;
+		return mask.matrix;
+	};
+
+	uint8_t* dst_pixels = reinterpret_cast<uint8_t*>(pixels());
+	const int dst_pitch = pitch();
+	const Rect dst_bounds = GetRect();
+
+	if (waver_depth != 0) {
+		// Same geometry as WaverBlit
+		const int wx = x - ox * zoom_x;
+		const int wy = y - oy * zoom_y;
+		const int height = static_cast<int>(std::floor(rect.height * zoom_y));
+		const int width = static_cast<int>(std::floor(rect.width * zoom_x));
+		const int src_x = rect.x * zoom_x;
+		const double yoff = rect.y * zoom_y;
+
+		Transform xform = Transform::Scale(1.0 / zoom_x, 1.0 / zoom_y);
+		e.xform = xform.matrix;
+		e.mask_xform = mask_xform(xform);
+
+		const int yclip = wy < 0 ? -wy : 0;
+		const int yend = std::min(height, dst_bounds.height - wy);
+		ForEachRow(yclip, yend, width, [&](int i) {
+			// RPG_RT compatible phase, see WaverBlit
+			const double sy = (i - yclip) * (2 * M_PI) / (32.0 * zoom_y);
+			const int offset = 2 * zoom_x * waver_depth * std::sin(waver_phase + sy);
+			const int src_y = yoff + i;
+
+			const int row_x = wx + offset;
+			const int x0 = std::max(row_x, 0);
+			const int x1 = std::min(row_x + width, dst_bounds.width);
+			if (x0 >= x1) {
+				return;
+			}
+
+			auto v = TransformCenter(e.xform, x0 - row_x + src_x, src_y);
+			auto mv = TransformCenter(e.mask_xform, x0 - row_x, i);
+			AffineRow(e, reinterpret_cast<uint32_t*>(dst_pixels + (wy + i) * dst_pitch) + x0, x1 - x0, v, mv);
+		});
+		return true;
+	}
+
+	if (angle != 0.0) {
+		// Same geometry as RotateZoomOpacityBlit
+		Transform fwd = Transform::Translation(x, y);
+		fwd *= Transform::Rotation(angle);
+		if (zoom_x != 1.0 || zoom_y != 1.0) {
+			fwd *= Transform::Scale(zoom_x, zoom_y);
+		}
+		fwd *= Transform::Translation(-ox, -oy);
+
+		Rect dst_rect = TransformRectangle(fwd, Rect{0, 0, rect.width, rect.height});
+		dst_rect.Adjust(dst_bounds);
+		if (dst_rect.IsEmpty()) {
+			return true;
+		}
+
+		auto inv = fwd.Inverse();
+		e.xform = inv.matrix;
+		e.mask_xform = mask_xform(inv);
+		e.bounds = rect;
+
+		ForEachRow(dst_rect.y, dst_rect.y + dst_rect.height, dst_rect.width, [&](int dy) {
+			auto v = TransformCenter(e.xform, dst_rect.x, dy);
+			auto mv = TransformCenter(e.mask_xform, dst_rect.x, dy);
+			AffineRow(e, reinterpret_cast<uint32_t*>(dst_pixels + dy * dst_pitch) + dst_rect.x, dst_rect.width, v, mv);
+		});
+		return true;
+	}
+
+	// Same geometry as ZoomOpacityBlit and StretchBlit, also for zoom 1
+	Rect dst_rect(
+		x - static_cast<int>(std::floor(ox * zoom_x)),
+		y - static_cast<int>(std::floor(oy * zoom_y)),
+		static_cast<int>(std::floor(rect.width * zoom_x)),
+		static_cast<int>(std::floor(rect.height * zoom_y)));
+	if (dst_rect.width <= 0 || dst_rect.height <= 0) {
+		return true;
+	}
+
+	const double scale_x = static_cast<double>(rect.width) / dst_rect.width;
+	const double scale_y = static_cast<double>(rect.height) / dst_rect.height;
+	Transform xform = Transform::Scale(scale_x, scale_y);
+	e.xform = xform.matrix;
+	e.mask_xform = mask_xform(xform);
+	const int src_x = rect.x / scale_x;
+	const int src_y = rect.y / scale_y;
+
+	Rect clip = dst_rect;
+	clip.Adjust(dst_bounds);
+	if (clip.IsEmpty()) {
+		return true;
+	}
+
+	ForEachRow(clip.y, clip.y + clip.height, clip.width, [&](int dy) {
+		const int i = clip.x - dst_rect.x;
+		const int j = dy - dst_rect.y;
+		auto v = TransformCenter(e.xform, src_x + i, src_y + j);
+		auto mv = TransformCenter(e.mask_xform, i, j);
+		AffineRow(e, reinterpret_cast<uint32_t*>(dst_pixels + dy * dst_pitch) + clip.x, clip.width, v, mv);
+	});
+	return true;
+}
+
+namespace {
+	/** Repeats every pixel of a row twice */
+	void ScaleRow2(uint32_t* dst, const uint32_t* src, int n) {
+		int i = 0;
+#if defined(__SSE2__)
+		for (; i + 4 <= n; i += 4) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_unpacklo_epi32(v, v));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 4), _mm_unpackhi_epi32(v, v));
+		}
+#elif defined(__ARM_NEON)
+		for (; i + 4 <= n; i += 4) {
+			uint32x4_t v = vld1q_u32(src + i);
+			uint32x4x2_t r = {{ v, v }};
+			vst2q_u32(dst + i * 2, r);
+		}
+#endif
+		for (; i < n; ++i) {
+			dst[i * 2] = dst[i * 2 + 1] = src[i];
+		}
+	}
+
+	/** Repeats every pixel of a row three times */
+	void ScaleRow3(uint32_t* dst, const uint32_t* src, int n) {
+		int i = 0;
+#if defined(__SSE2__)
+		for (; i + 4 <= n; i += 4) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 0, 0)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3 + 4), _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 1, 1)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3 + 8), _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 2)));
+		}
+#elif defined(__ARM_NEON)
+		for (; i + 4 <= n; i += 4) {
+			uint32x4_t v = vld1q_u32(src + i);
+			uint32x4x3_t r = {{ v, v, v }};
+			vst3q_u32(dst + i * 3, r);
+		}
+#endif
+		for (; i < n; ++i) {
+			dst[i * 3] = dst[i * 3 + 1] = dst[i * 3 + 2] = src[i];
+		}
+	}
+
+	/** Repeats every pixel of a row four times */
+	void ScaleRow4(uint32_t* dst, const uint32_t* src, int n) {
+		int i = 0;
+#if defined(__SSE2__)
+		for (; i + 4 <= n; i += 4) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 4), _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 8), _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 12), _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)));
+		}
+#elif defined(__ARM_NEON)
+		for (; i + 4 <= n; i += 4) {
+			uint32x4_t v = vld1q_u32(src + i);
+			uint32x4x4_t r = {{ v, v, v, v }};
+			vst4q_u32(dst + i * 4, r);
+		}
+#endif
+		for (; i < n; ++i) {
+			dst[i * 4] = dst[i * 4 + 1] = dst[i * 4 + 2] = dst[i * 4 + 3] = src[i];
+		}
+	}
+
+	/** Repeats every pixel of a row scale times */
+	template <typename T>
+	void ScaleRowN(T* dst, const T* src, int n, int scale) {
+		for (int i = 0; i < n; ++i) {
+			std::fill(dst, dst + scale, src[i]);
+			dst += scale;
+		}
+	}
+
+	/**
+	 * Picks the pixels of a row through a column map.
+	 * Unrolled instead of vectorized: SSE2 and NEON have no gather.
+	 */
+	template <typename T>
+	void MapRow(T* dst, const T* src, const int* columns, int n) {
+		int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			dst[i + 0] = src[columns[i + 0]];
+			dst[i + 1] = src[columns[i + 1]];
+			dst[i + 2] = src[columns[i + 2]];
+			dst[i + 3] = src[columns[i + 3]];
+		}
+		for (; i < n; ++i) {
+			dst[i] = src[columns[i]];
+		}
+	}
+
+	/** @return whether rect is completely inside of bitmap */
+	bool IsInside(Rect const& rect, Bitmap const& bitmap) {
+		return rect.x >= 0 && rect.y >= 0 && rect.width > 0 && rect.height > 0 &&
+			rect.x + rect.width <= bitmap.GetWidth() && rect.y + rect.height <= bitmap.GetHeight();
+	}
+}
+
+bool Bitmap::ScaleBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int scale) {
+	Rect dst_rect(x, y, src_rect.width * scale, src_rect.height * scale);
+	if (scale < 1 || (bpp() != 4 && bpp() != 2) || src.pixman_format != pixman_format ||
+			!IsInside(src_rect, src) || !IsInside(dst_rect, *this)) {
+		return false;
+	}
+
+	const int pixel_bytes = bpp();
+	const auto* src_pixels = reinterpret_cast<const uint8_t*>(src.pixels());
+	const int src_pitch = src.pitch();
+	auto* dst_pixels = reinterpret_cast<uint8_t*>(pixels());
+	const int dst_pitch = pitch();
+	const size_t row_bytes = dst_rect.width * pixel_bytes;
+
+	// Every source row is scaled once and copied to the other rows of its block
+	ForEachRow(0, src_rect.height, dst_rect.width * scale, [&](int sy) {
+		auto* src_row = src_pixels + (src_rect.y + sy) * src_pitch + src_rect.x * pixel_bytes;
+		auto* dst_row = dst_pixels + (y + sy * scale) * dst_pitch;
+		auto* dst = dst_row + x * pixel_bytes;
+
+		if (pixel_bytes == 2) {
+			// 16 bit screens of handhelds, no SIMD rows for these
+			ScaleRowN(reinterpret_cast<uint16_t*>(dst), reinterpret_cast<const uint16_t*>(src_row), src_rect.width, scale);
+		} else {
+			auto* dst32 = reinterpret_cast<uint32_t*>(dst);
+			auto* src32 = reinterpret_cast<const uint32_t*>(src_row);
+			switch (scale) {
+				case 1:
+					std::memcpy(dst32, src32, row_bytes);
+					break;
+				case 2:
+					ScaleRow2(dst32, src32, src_rect.width);
+					break;
+				case 3:
+					ScaleRow3(dst32, src32, src_rect.width);
+					break;
+				case 4:
+					ScaleRow4(dst32, src32, src_rect.width);
+					break;
+				default:
+					ScaleRowN(dst32, src32, src_rect.width, scale);
+					break;
+			}
+		}
+
+		for (int i = 1; i < scale; ++i) {
+			std::memcpy(dst_row + i * dst_pitch + x * pixel_bytes, dst, row_bytes);
+		}
+	});
+
+	return true;
+}
+
+bool Bitmap::NearestStretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect) {
+	if ((bpp() != 4 && bpp() != 2) || src.pixman_format != pixman_format ||
+			!IsInside(src_rect, src) || !IsInside(dst_rect, *this)) {
+		return false;
+	}
+
+	if (dst_rect.width % src_rect.width == 0 && dst_rect.height % src_rect.height == 0 &&
+			dst_rect.width / src_rect.width == dst_rect.height / src_rect.height) {
+		return ScaleBlit(dst_rect.x, dst_rect.y, src, src_rect, dst_rect.width / src_rect.width);
+	}
+
+	// Sample the pixel centers, computed once for all rows
+	std::vector<int> columns(dst_rect.width);
+	for (int i = 0; i < dst_rect.width; ++i) {
+		columns[i] = src_rect.x + (2 * i + 1) * src_rect.width / (2 * dst_rect.width);
+	}
+	auto source_row = [&](int dy) {
+		return src_rect.y + (2 * dy + 1) * src_rect.height / (2 * dst_rect.height);
+	};
+
+	const int pixel_bytes = bpp();
+	const auto* src_pixels = reinterpret_cast<const uint8_t*>(src.pixels());
+	const int src_pitch = src.pitch();
+	auto* dst_pixels = reinterpret_cast<uint8_t*>(pixels());
+	const int dst_pitch = pitch();
+
+	ForEachRow(0, dst_rect.height, dst_rect.width, [&](int dy) {
+		auto* dst = dst_pixels + (dst_rect.y + dy) * dst_pitch + dst_rect.x * pixel_bytes;
+		auto* src_row = src_pixels + source_row(dy) * src_pitch;
+		if (pixel_bytes == 2) {
+			MapRow(reinterpret_cast<uint16_t*>(dst), reinterpret_cast<const uint16_t*>(src_row), columns.data(), dst_rect.width);
+		} else {
+			MapRow(reinterpret_cast<uint32_t*>(dst), reinterpret_cast<const uint32_t*>(src_row), columns.data(), dst_rect.width);
+		}
+	});
+
+	return true;
+}
+
 pixman_op_t Bitmap::GetOperator(pixman_image_t* mask) const {
 	if (!mask && (!GetTransparent() || GetImageOpacity() == ImageOpacity::Opaque)) {
 		return PIXMAN_OP_SRC;
@@ -1145,7 +2278,7 @@ void Bitmap::EdgeMirrorBlit(int x, int y, Bitmap const& src, Rect const& src_rec
 	const auto dst_rect = GetRect();
 
 	auto draw = [&](int x, int y) {
-		pixman_image_composite32(src.GetOperator(mask.get()),
+		Composite(src.GetOperator(mask.get()),
 				src.bitmap.get(),
 				mask.get(), bitmap.get(),
 				src_rect.x, src_rect.y,
@@ -21,6 +21,7 @@
 // Headers
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 #include <cassert>
 #include <pixman.h>
@@ -37,6 +38,7 @@
 #include "string_view.h"
 
 struct Transform;
+struct ImageOut;
 
 /**
  * Base Bitmap class.
@@ -173,6 +175,21 @@ public:
 	 */
 	ImageOpacity GetTileOpacity(int x, int y) const;
 
+	/**
+	 * Provides the opacity information of all tiles on a tilemap.
+	 *
+	 * @return tile opacity information, empty when the bitmap is no chipset
+	 */
+	const TileOpacity& GetTileOpacity() const;
+
+	/**
+	 * Marks a chipset as read only and uses the tile opacity information of an
+	 * earlier load of the same image instead of scanning the pixels.
+	 *
+	 * @param opacity tile opacity information
+	 */
+	void SetTileOpacity(TileOpacity opacity);
+
 	/**
 	 * Writes PNG converted bitmap to output stream.
 	 *
@@ -484,6 +501,35 @@ public:
 	 */
 	void Blit2x(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect);
 
+	/**
+	 * Blits source bitmap scaled by an integer factor with nearest neighbour
+	 * sampling and no transparency. Scales 2, 3 and 4 of 32 bit bitmaps use
+	 * SIMD when available.
+	 * Both bitmaps must have the same 32 or 16 bit format and the scaled
+	 * rectangle must be inside of this bitmap.
+	 *
+	 * @param x destination x position.
+	 * @param y destination y position.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rectangle.
+	 * @param scale scale factor.
+	 * @return false when the bitmaps or rectangles are not supported, nothing was drawn then.
+	 */
+	bool ScaleBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int scale);
+
+	/**
+	 * Blits source bitmap stretched to the destination rectangle with nearest
+	 * neighbour sampling and no transparency. The source column of every
+	 * destination column is computed once per call. Uses ScaleBlit for
+	 * integer factors. Same restrictions as ScaleBlit.
+	 *
+	 * @param dst_rect destination rectangle.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rectangle.
+	 * @return false when the bitmaps or rectangles are not supported, nothing was drawn then.
+	 */
+	bool NearestStretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect);
+
 	/**
 	 * Calculates the bounding rectangle of a transformed rectangle.
 	 *
@@ -516,9 +562,63 @@ public:
 					 double zoom_x, double zoom_y, double angle,
 					 int waver_depth, double waver_phase);
 
+	/**
+	 * Blits source bitmap like EffectsBlit and applies the effects a sprite
+	 * would otherwise bake into an effect bitmap in the same pass.
+	 * Pixels are sampled like pixman does for nearest neighbour filtering.
+	 *
+	 * @param x destination x position.
+	 * @param y destination y position.
+	 * @param ox source origin x.
+	 * @param oy source origin y.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rectangle.
+	 * @param effect_rect rectangle of src which is flipped, contains src_rect.
+	 * @param opacity opacity to apply.
+	 * @param zoom_x x scale factor.
+	 * @param zoom_y y scale factor.
+	 * @param angle rotation angle.
+	 * @param waver_depth wave magnitude.
+	 * @param waver_phase wave phase.
+	 * @param tone tone to apply.
+	 * @param flash flash color to blend.
+	 * @param flip_x flip horizontally.
+	 * @param flip_y flip vertically.
+	 * @return false when the pixel formats are not supported, nothing was drawn then.
+	 */
+	bool AffineBlit(int x, int y, int ox, int oy,
+					Bitmap const& src, Rect const& src_rect, Rect const& effect_rect,
+					Opacity const& opacity,
+					double zoom_x, double zoom_y, double angle,
+					int waver_depth, double waver_phase,
+					Tone const& tone, Color const& flash, bool flip_x, bool flip_y);
+
 	static DynamicFormat ChooseFormat(const DynamicFormat& format);
 	static void SetFormat(const DynamicFormat& format);
 
+	/**
+	 * Sets the number of threads used for compositing. Large blits are
+	 * split into horizontal bands of the destination which are composited
+	 * in parallel.
+	 *
+	 * @param threads number of threads including the calling one, 1 disables banding
+	 */
+	static void SetCompositeThreads(int threads);
+
+	/**
+	 * Sets whether large read only images with a palette keep one byte per
+	 * pixel instead of being expanded to the pixel format. Blits read
+	 * through the palette, effects which need the expanded pixels draw the
+	 * image onto an effect bitmap first.
+	 * Only affects images loaded afterwards.
+	 *
+	 * @param enabled true to enable, false to disable (default)
+	 */
+	static void SetIndexedStorage(bool enabled);
+
+	/** @return whether the bitmap stores palette indices instead of pixels */
+	bool IsIndexed() const;
+
 	static DynamicFormat pixel_format;
 	static DynamicFormat opaque_pixel_format;
 	static DynamicFormat image_format;
@@ -533,6 +633,7 @@ public:
 
 	ImageOpacity ComputeImageOpacity() const;
 	ImageOpacity ComputeImageOpacity(Rect rect) const;
+	ImageOpacity ComputeIndexedOpacity(Rect rect) const;
 
 protected:
 	DynamicFormat format;
@@ -541,12 +642,36 @@ protected:
 	TileOpacity tile_opacity;
 	Color bg_color, sh_color;
 
+	/** Palette of an indexed bitmap, format stays the format of the expanded image */
+	std::unique_ptr<pixman_indexed_t> indexed_palette;
+
+	/** Palette of an indexed bitmap in the pixel format */
+	struct PaletteLut;
+	std::shared_ptr<const PaletteLut> indexed_lut;
+
 	/** Bitmap data. */
 	PixmanImagePtr bitmap;
 	pixman_format_code_t pixman_format;
 
 	void Init(int width, int height, void* data, int pitch = 0, bool destroy = true);
-	void ConvertImage(int& width, int& height, void*& pixels, bool transparent);
+	/**
+	 * Stores the palette indices of a decoded image when indexed storage
+	 * applies to it.
+	 *
+	 * @return false when the image must be expanded with ConvertImage
+	 */
+	bool InitIndexed(ImageOut& image, uint32_t flags);
+	void ConvertImage(ImageOut& image, bool transparent);
+
+	/**
+	 * Blits an indexed bitmap by looking up the palette while writing
+	 * instead of compositing through pixman.
+	 *
+	 * @param opacity opacity of the blit
+	 * @param over composite with PIXMAN_OP_OVER instead of PIXMAN_OP_SRC
+	 * @return false when src is not indexed or the blit is not supported
+	 */
+	bool PaletteBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int opacity, bool over);
 
 	static PixmanImagePtr GetSubimage(Bitmap const& src, const Rect& src_rect);
 	static inline void MultiplyAlpha(uint8_t &r, uint8_t &g, uint8_t &b, const uint8_t &a) {
@@ -568,6 +693,9 @@ protected:
 
 	pixman_op_t GetOperator(pixman_image_t* mask = nullptr) const;
 	bool read_only = false;
+
+	/** @return whether the tile opacity information covers the whole image */
+	bool TilesCoverImage() const;
 };
 
 inline ImageOpacity Bitmap::GetImageOpacity() const {
@@ -578,6 +706,14 @@ inline ImageOpacity Bitmap::GetTileOpacity(int x, int y) const {
 	return tile_opacity.Get(x, y);
 }
 
+inline bool Bitmap::IsIndexed() const {
+	return indexed_palette != nullptr;
+}
+
+inline const TileOpacity& Bitmap::GetTileOpacity() const {
+	return tile_opacity;
+}
+
 inline Color Bitmap::GetBackgroundColor() const {
 	return bg_color;
 }
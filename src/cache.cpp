@@ -20,6 +20,7 @@
 #  pragma warning(disable: 4003)
 #endif
 
+#include <algorithm>
 #include <map>
 #include <tuple>
 #include <chrono>
@@ -31,10 +32,14 @@
 #include "exfont.h"
 #include "default_graphics.h"
 #include "bitmap.h"
+#include "options.h"
 #include "output.h"
 #include "player.h"
 #include <lcf/data.h>
 #include "game_clock.h"
+#include "thread_pool.h"
+#include "memory_stats.h"
+#include "translation.h"
 
 #ifdef LOW_MEMORY_DEVICES
 #define CACHE_SIZE_DEF 2
@@ -89,6 +94,15 @@ namespace {
 	// rect, flip_x, flip_y, tone, blend
 	using effect_key_type = std::tuple<BitmapRef, Rect, bool, bool, Tone, Color>;
 	std::map<effect_key_type, std::weak_ptr<Bitmap>> cache_effects;
+	/** Size of cache_effects after the last removal of expired entries */
+	size_t cache_effects_swept = 0;
+
+	/**
+	 * Tile opacity of the loaded chipsets. Kept when the bitmap is freed, so a
+	 * reload of the same chipset does not scan the tiles again.
+	 * Indexed by OpacityKey.
+	 */
+	std::unordered_map<key_type, TileOpacity> chipset_opacity;
 
 	std::string system_name;
 
@@ -97,6 +111,94 @@ namespace {
 	constexpr int cache_limit = CACHE_SIZE_DEF * 1024 * 1024;
 	size_t cache_size = 0;
 
+	template <typename T>
+	void MeasureWeakCache(MemoryStats::Source& source, const T& weak_cache) {
+		size_t bytes = 0;
+		size_t entries = 0;
+		for (auto& kv: weak_cache) {
+			if (auto bitmap = kv.second.lock()) {
+				bytes += bitmap->GetSize();
+				++entries;
+			}
+		}
+		source.SetUsage(bytes, entries);
+	}
+
+	MemoryStats::Source bitmap_stats("Bitmaps", [](MemoryStats::Source& source) {
+		source.SetUsage(cache_size, cache.size());
+	});
+
+	MemoryStats::Source tile_stats("Tiles", [](MemoryStats::Source& source) {
+		MeasureWeakCache(source, cache_tiles);
+	});
+
+	MemoryStats::Source effect_stats("Effects", [](MemoryStats::Source& source) {
+		MeasureWeakCache(source, cache_effects);
+	});
+
+	MemoryStats::Source chipset_opacity_stats("Tile opacity", [](MemoryStats::Source& source) {
+		size_t bytes = 0;
+		for (auto& kv: chipset_opacity) {
+			bytes += kv.first.size() + kv.second.GetWidth() * kv.second.GetHeight();
+		}
+		source.SetUsage(bytes, chipset_opacity.size());
+	});
+
+	/**
+	 * @param key cache key of the image
+	 * @return key of the tile opacity, a translation can replace the chipset
+	 */
+	key_type OpacityKey(const key_type& key) {
+		return key + '\0' + Tr::GetCurrentTranslationId();
+	}
+
+	/**
+	 * @param key cache key of the image
+	 * @param flags Bitmap flags of the image
+	 * @return flags for decoding the image, without the pixel scans of a
+	 * chipset whose tile opacity is already known
+	 */
+	uint32_t DecodeFlags(const key_type& key, uint32_t flags) {
+		if ((flags & Bitmap::Flag_Chipset) && chipset_opacity.find(OpacityKey(key)) != chipset_opacity.end()) {
+			return flags & ~(Bitmap::Flag_Chipset | Bitmap::Flag_ReadOnly);
+		}
+		return flags;
+	}
+
+	/**
+	 * Applies the known tile opacity to a decoded chipset or remembers the
+	 * tile opacity of a chipset which was scanned.
+	 *
+	 * @param key cache key of the image
+	 * @param flags Bitmap flags of the image
+	 * @param bmp decoded image
+	 */
+	void RestoreTileOpacity(const key_type& key, uint32_t flags, Bitmap& bmp) {
+		if (!(flags & Bitmap::Flag_Chipset)) {
+			return;
+		}
+
+		auto opacity_key = OpacityKey(key);
+		auto it = chipset_opacity.find(opacity_key);
+		if (it == chipset_opacity.end()) {
+			chipset_opacity_stats.Miss();
+			chipset_opacity.emplace(std::move(opacity_key), bmp.GetTileOpacity());
+			return;
+		}
+
+		auto& opacity = it->second;
+		if (opacity.GetWidth() == bmp.GetWidth() / TILE_SIZE && opacity.GetHeight() == bmp.GetHeight() / TILE_SIZE) {
+			chipset_opacity_stats.Hit();
+			bmp.SetTileOpacity(opacity);
+			return;
+		}
+
+		// The file changed, scan it again
+		chipset_opacity_stats.Miss();
+		bmp.CheckPixels(flags);
+		opacity = bmp.GetTileOpacity();
+	}
+
 	void FreeBitmapMemory() {
 		auto cur_ticks = Game_Clock::GetFrameTime();
 
@@ -125,6 +227,7 @@ namespace {
 #endif
 
 			cache_size -= it->second.bitmap->GetSize();
+			bitmap_stats.Evict();
 
 			it = cache.erase(it);
 		}
@@ -145,6 +248,8 @@ namespace {
 		return (cache[key] = {bmp, Game_Clock::GetFrameTime()}).bitmap;
 	}
 
+	std::unique_ptr<ThreadPool> decode_pool;
+
 	BitmapRef LoadBitmap(StringView folder_name, StringView filename,
 						 bool transparent, const uint32_t flags) {
 		const auto key = MakeHashKey(folder_name, filename, transparent);
@@ -152,6 +257,8 @@ namespace {
 		auto it = cache.find(key);
 
 		if (it == cache.end()) {
+			bitmap_stats.Miss();
+
 			auto is = FileFinder::OpenImage(folder_name, filename);
 
 			BitmapRef bmp = BitmapRef();
@@ -161,9 +268,11 @@ namespace {
 			if (!is) {
 				Output::Warning("Image not found: {}/{}", folder_name, filename);
 			} else {
-				bmp = Bitmap::Create(std::move(is), transparent, flags);
+				bmp = Bitmap::Create(std::move(is), transparent, DecodeFlags(key, flags));
 				if (!bmp) {
 					Output::Warning("Invalid image: {}/{}", folder_name, filename);
+				} else {
+					RestoreTileOpacity(key, flags, *bmp);
 				}
 			}
 
@@ -172,6 +281,7 @@ namespace {
 			}
 			return nullptr;
 		} else {
+			bitmap_stats.Hit();
 			it->second.last_access = Game_Clock::GetFrameTime();
 			return it->second.bitmap;
 		}
@@ -236,6 +346,13 @@ namespace {
 		{ "Frame", true, 320, 320, 240, 240, DrawCheckerboard<Material::Frame>, true },
 	};
 
+	constexpr uint32_t BitmapFlags(Material::Type type) {
+		return Bitmap::Flag_ReadOnly | (
+			type == Material::Chipset? Bitmap::Flag_Chipset:
+			type == Material::System? Bitmap::Flag_System:
+			0);
+	}
+
 	template<Material::Type T>
 	BitmapRef DrawCheckerboard() {
 		static_assert(Material::REND < T && T < Material::END, "Invalid material.");
@@ -301,10 +418,7 @@ namespace {
 		assert(req != nullptr && req->IsReady());
 #endif
 
-		BitmapRef ret = LoadBitmap(s.directory, f, transparent, Bitmap::Flag_ReadOnly | (
-										 T == Material::Chipset? Bitmap::Flag_Chipset:
-										 T == Material::System? Bitmap::Flag_System:
-										 0));
+		BitmapRef ret = LoadBitmap(s.directory, f, transparent, BitmapFlags(T));
 
 		if (!ret) {
 			return LoadDummyBitmap<T>(s.directory, f, transparent);
@@ -437,6 +551,8 @@ BitmapRef Cache::Tile(StringView filename, int tile_id) {
 	auto it = cache_tiles.find(key);
 
 	if (it == cache_tiles.end() || it->second.expired()) {
+		tile_stats.Miss();
+
 		BitmapRef chipset = Cache::Chipset(filename);
 		Rect rect = Rect(0, 0, 16, 16);
 
@@ -462,7 +578,10 @@ BitmapRef Cache::Tile(StringView filename, int tile_id) {
 		rect.y += sub_tile_id / 6 * 16;
 
 		return(cache_tiles[key] = Bitmap::Create(*chipset, rect)).lock();
-	} else { return it->second.lock(); }
+	} else {
+		tile_stats.Hit();
+		return it->second.lock();
+	}
 }
 
 BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) {
@@ -478,6 +597,8 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 	const auto it = cache_effects.find(key);
 
 	if (it == cache_effects.end() || it->second.expired()) {
+		effect_stats.Miss();
+
 		BitmapRef bitmap_effects;
 
 		auto create = [&rect] () -> BitmapRef {
@@ -511,12 +632,115 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 
 		assert(bitmap_effects && "Effect cache used but no effect applied!");
 
+		if (cache_effects.size() >= 2 * cache_effects_swept + 64) {
+			// Tone fades create a new entry per frame, drop the ones nobody uses anymore
+			for (auto eit = cache_effects.begin(); eit != cache_effects.end();) {
+				if (eit->second.expired()) {
+					effect_stats.Evict();
+					eit = cache_effects.erase(eit);
+				} else {
+					++eit;
+				}
+			}
+			cache_effects_swept = cache_effects.size();
+		}
+
 		return(cache_effects[key] = bitmap_effects).lock();
-	} else { return it->second.lock(); }
+	} else {
+		effect_stats.Hit();
+		return it->second.lock();
+	}
+}
+
+void Cache::Preload(const std::vector<PreloadEntry>& entries) {
+	struct Job {
+		std::string key;
+		Filesystem_Stream::InputStream stream;
+		bool transparent;
+		uint32_t flags;
+		uint32_t decode_flags;
+		BitmapRef bitmap;
+	};
+	std::vector<Job> jobs;
+
+	for (const auto& entry: entries) {
+		Material::Type type =
+			entry.type == PreloadEntry::Chipset ? Material::Chipset :
+			entry.type == PreloadEntry::Panorama ? Material::Panorama :
+			Material::Charset;
+		const Spec& s = spec[type];
+
+		if (entry.filename.empty() || entry.filename == CACHE_DEFAULT_BITMAP) {
+			continue;
+		}
+
+		auto key = MakeHashKey(s.directory, entry.filename, s.transparent);
+		if (cache.find(key) != cache.end() ||
+			std::any_of(jobs.begin(), jobs.end(), [&](const Job& job) { return job.key == key; })) {
+			continue;
+		}
+
+		FileRequestAsync* request = AsyncHandler::RequestFile(s.directory, entry.filename);
+		request->SetGraphicFile(true);
+		request->Start();
+		if (!request->IsReady()) {
+			// Still downloading, loaded by the regular accessor when it arrives
+			continue;
+		}
+
+		// Opening is not thread safe, only the decoding runs on the workers.
+		// Missing and invalid images are reported by the regular accessor.
+		auto is = FileFinder::OpenImage(s.directory, entry.filename);
+		if (is) {
+			auto flags = BitmapFlags(type);
+			auto decode_flags = DecodeFlags(key, flags);
+			jobs.push_back({std::move(key), std::move(is), s.transparent, flags, decode_flags, nullptr});
+		}
+	}
+
+	if (jobs.empty()) {
+		return;
+	}
+
+	auto decode = [&jobs](int i) {
+		auto& job = jobs[i];
+		job.bitmap = Bitmap::Create(std::move(job.stream), job.transparent, job.decode_flags);
+	};
+
+	if (decode_pool) {
+		decode_pool->ParallelFor(static_cast<int>(jobs.size()), decode);
+		// Shows the error screen when a decoding thread failed
+		Output::WriteDeferred();
+	} else {
+		for (int i = 0; i < static_cast<int>(jobs.size()); ++i) {
+			decode(i);
+		}
+	}
+
+	FreeBitmapMemory();
+
+	for (auto& job: jobs) {
+		if (job.bitmap) {
+			RestoreTileOpacity(job.key, job.flags, *job.bitmap);
+			AddToCache(job.key, std::move(job.bitmap));
+		}
+	}
+}
+
+void Cache::SetDecodeThreads(int threads) {
+	if (threads <= 1) {
+		decode_pool.reset();
+		return;
+	}
+
+	// The calling thread decodes too
+	decode_pool.reset(new ThreadPool(threads - 1));
 }
 
 void Cache::Clear() {
+	chipset_opacity.clear();
 	cache_effects.clear();
+	cache_effects_swept = 0;
 	cache.clear();
 	cache_size = 0;
 
@@ -57,6 +57,35 @@ namespace Cache {
 	BitmapRef Tile(StringView filename, int tile_id);
 	BitmapRef SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend);
 
+	/** An image for batch loading with Preload */
+	struct PreloadEntry {
+		enum Type {
+			Charset,
+			Chipset,
+			Panorama
+		};
+
+		Type type;
+		std::string filename;
+	};
+
+	/**
+	 * Decodes all images which are not cached yet concurrently and adds
+	 * them to the cache. The bitmaps are retrieved afterwards with the
+	 * regular accessors, e.g. Charset, without decoding them again.
+	 * Images which are not downloaded yet are skipped.
+	 *
+	 * @param entries images to load
+	 */
+	void Preload(const std::vector<PreloadEntry>& entries);
+
+	/**
+	 * Sets the amount of threads used by Preload.
+	 *
+	 * @param threads number of threads, 1 decodes on the calling thread
+	 */
+	void SetDecodeThreads(int threads);
+
 	void Clear();
 
 	/** @return the configured system bitmap, or nullptr if there is no system */
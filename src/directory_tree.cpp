@@ -22,6 +22,7 @@
 #include "platform.h"
 #include "player.h"
 #include <lcf/reader_util.h>
+#include <algorithm>
 
 #ifdef EP_DEBUG_DIRECTORYTREE
 template <typename... Args>
@@ -37,6 +38,46 @@ namespace {
 	std::string make_key(StringView n) {
 		return lcf::ReaderUtil::Normalize(n);
 	};
+
+	// For ASCII make_key only lowercases, the index relies on this
+	constexpr char fold(char c) {
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+
+	bool is_ascii(StringView s) {
+		return std::all_of(s.begin(), s.end(), [](char c) { return c >= 0x20 && c <= 0x7E; });
+	}
+
+	constexpr uint64_t fnv_offset = 14695981039346656037ull;
+	constexpr uint64_t fnv_prime = 1099511628211ull;
+
+	/** Continues a FNV-1a hash over the ASCII lowercased characters of s */
+	uint64_t hash_key(uint64_t hash, StringView s) {
+		for (char c : s) {
+			hash = (hash ^ static_cast<uint8_t>(fold(c))) * fnv_prime;
+		}
+		return hash;
+	}
+
+	uint64_t hash_dir(StringView dir_key) {
+		return hash_key(hash_key(fnv_offset, dir_key), "/");
+	}
+
+	/** @return whether key equals the lowered name + ext */
+	bool name_equals(StringView key, StringView name, StringView ext) {
+		if (key.size() != name.size() + ext.size()) {
+			return false;
+		}
+		size_t pos = 0;
+		for (StringView part : { name, ext }) {
+			for (char c : part) {
+				if (key[pos++] != fold(c)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
 }
 
 std::unique_ptr<DirectoryTree> DirectoryTree::Create() {
@@ -62,12 +103,14 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 	if (dir_it != dir_cache.end()) {
 		// Already cached
 		DebugLog("ListDirectory Cache Hit: {}", dir_key);
+		cache_stats.Hit();
 		auto file_it = fs_cache.find(dir_key);
 		assert(file_it != fs_cache.end());
 		return &file_it->second;
 	}
 
 	assert(fs_cache.find(dir_key) == fs_cache.end());
+	cache_stats.Miss();
 
 	if (!fs->Exists(fs_path)) {
 		std::string parent_dir, child_dir;
@@ -102,6 +145,8 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 
 	DirectoryListType fs_cache_entry;
 
+	const uint64_t dir_hash = hash_dir(dir_key);
+
 	for (auto& entry : entries) {
 		std::string new_entry_key = make_key(entry.name);
 
@@ -111,7 +156,12 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 				Output::Warning("This can lead to file not found errors. Merge the directories manually in a file browser.");
 			}
 		}
-		fs_cache_entry.emplace(std::make_pair(std::move(new_entry_key), entry));
+
+		auto inserted = fs_cache_entry.emplace(std::make_pair(new_entry_key, entry));
+		if (inserted.second && entry.type == FileType::Regular) {
+			file_index.emplace(hash_key(dir_hash, new_entry_key),
+				IndexedFile{ dir_key, new_entry_key, FileFinder::MakePath(fs_path, entry.name) });
+		}
 	}
 	fs_cache.emplace(dir_key, fs_cache_entry);
 
@@ -122,14 +172,26 @@ void DirectoryTree::ClearCache(StringView path) const {
 	DebugLog("ClearCache: {}", path);
 
 	if (path.empty()) {
+		cache_stats.Evict(fs_cache.size());
 		fs_cache.clear();
 		dir_cache.clear();
+		dir_index.clear();
+		name_index.clear();
+		file_index.clear();
 		return;
 	}
 
 	auto dir_key = make_key(path);
+
+	for (auto it = dir_index.begin(); it != dir_index.end();) {
+		it = (it->second.key == dir_key) ? dir_index.erase(it) : std::next(it);
+	}
+	for (auto it = file_index.begin(); it != file_index.end();) {
+		it = (it->second.dir == dir_key) ? file_index.erase(it) : std::next(it);
+	}
 	auto fs_it = fs_cache.find(dir_key);
 	if (fs_it != fs_cache.end()) {
+		cache_stats.Evict();
 		fs_cache.erase(fs_it);
 	}
 	auto dir_it = dir_cache.find(dir_key);
@@ -138,7 +200,37 @@ void DirectoryTree::ClearCache(StringView path) const {
 	}
 }
 
+void DirectoryTree::MeasureCache(MemoryStats::Source& source) const {
+	// Approximation: String contents and the stored values, the overhead
+	// of the hash map nodes is not included
+	size_t bytes = 0;
+	for (auto& dir: fs_cache) {
+		bytes += dir.first.capacity();
+		for (auto& entry: dir.second) {
+			bytes += sizeof(entry) + entry.first.capacity() + entry.second.name.capacity();
+		}
+	}
+	for (auto& dir: dir_cache) {
+		bytes += sizeof(dir) + dir.first.capacity() + dir.second.capacity();
+	}
+	for (auto* index: { &dir_index, &name_index }) {
+		for (auto& name: *index) {
+			bytes += sizeof(name) + name.second.name.capacity() + name.second.key.capacity();
+		}
+	}
+	for (auto& file: file_index) {
+		bytes += sizeof(file) + file.second.dir.capacity() + file.second.name.capacity() + file.second.path.capacity();
+	}
+
+	source.SetUsage(bytes, fs_cache.size());
+}
+
 std::string DirectoryTree::FindFile(StringView filename, Span<StringView> exts) const {
+	const std::string* found = nullptr;
+	if (FindIndexed(filename, exts, found)) {
+		return found ? *found : "";
+	}
+
 	return FindFile({ ToString(filename), exts });
 }
 
@@ -148,9 +240,9 @@ std::string DirectoryTree::FindFile(StringView directory, StringView filename, S
 
 std::string DirectoryTree::FindFile(const DirectoryTree::Args& args) const {
 	std::string dir, name, canonical_path;
-	// Few games (e.g. Yume2kki) use path traversal (..) in the filenames to point
-	// to files outside of the actual directory.
-	canonical_path = FileFinder::MakeCanonical(args.path, args.canonical_initial_deepness);
+
+	const std::string* found = nullptr;
+	const bool indexed = FindIndexed(args.path, args.exts, found);
 
 	if (args.translate && !Tr::GetCurrentTranslationId().empty()) {
 		// Search in the active language tree but do not translate again and swallow not found warnings
@@ -162,6 +254,22 @@ std::string DirectoryTree::FindFile(const DirectoryTree::Args& args) const {
 		}
 	}
 
+	if (indexed) {
+		if (found) {
+			return *found;
+		}
+		if (args.file_not_found_warning) {
+			// Only canonical paths are indexed
+			std::tie(dir, name) = FileFinder::GetPathAndFilename(args.path);
+			Output::Debug("Cannot find: {}/{}", dir, name);
+		}
+		return "";
+	}
+
+	// Few games (e.g. Yume2kki) use path traversal (..) in the filenames to point
+	// to files outside of the actual directory.
+	canonical_path = FileFinder::MakeCanonical(args.path, args.canonical_initial_deepness);
+
 	std::tie(dir, name) = FileFinder::GetPathAndFilename(canonical_path);
 
 	DebugLog("FindFile: {} | {} | {} | {}", args.path, canonical_path, dir, name);
@@ -179,6 +287,23 @@ std::string DirectoryTree::FindFile(const DirectoryTree::Args& args) const {
 	assert(dir_it != dir_cache.end());
 
 	std::string name_key = make_key(name);
+
+	if (canonical_path == args.path) {
+		// The path is already canonical: Further searches for it can go
+		// through the index. Non-ASCII names need their lowered form
+		// remembered because FindIndexed can only lower ASCII.
+		auto remember = [](std::unordered_multimap<uint64_t, IndexedName>& index, const std::string& name, const std::string& key) {
+			const uint64_t hash = hash_key(fnv_offset, name);
+			auto range = index.equal_range(hash);
+			if (std::none_of(range.first, range.second, [&](const auto& kv) { return kv.second.name == name; })) {
+				index.emplace(hash, IndexedName{ name, key });
+			}
+		};
+		remember(dir_index, dir, dir_key);
+		if (!is_ascii(name)) {
+			remember(name_index, name, name_key);
+		}
+	}
 	if (args.exts.empty()) {
 		auto entry_it = entries->find(name_key);
 		if (entry_it != entries->end() && entry_it->second.type == FileType::Regular) {
@@ -200,3 +325,75 @@ std::string DirectoryTree::FindFile(const DirectoryTree::Args& args) const {
 
 	return "";
 }
+
+bool DirectoryTree::FindIndexed(StringView path, Span<StringView> exts, const std::string*& found) const {
+	found = nullptr;
+
+	StringView dir, name = path;
+	auto slash = path.rfind('/');
+	if (slash != StringView::npos) {
+		dir = path.substr(0, slash);
+		name = path.substr(slash + 1);
+	}
+
+	// Anything FindFile would canonicalize in the filename
+	if (name.empty() || name == "." || name == ".." || name.find('\\') != StringView::npos ||
+		(!Player::escape_symbol.empty() && name.find(StringView(Player::escape_symbol)) != StringView::npos)) {
+		return false;
+	}
+
+	auto lookup = [](const std::unordered_multimap<uint64_t, IndexedName>& index, StringView name) -> const std::string* {
+		auto range = index.equal_range(hash_key(fnv_offset, name));
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second.name == name) {
+				return &it->second.key;
+			}
+		}
+		return nullptr;
+	};
+
+	const std::string* dir_key = lookup(dir_index, dir);
+	if (!dir_key) {
+		return false;
+	}
+
+	// ASCII names are lowered like make_key does, others were lowered before
+	StringView name_key = name;
+	if (!is_ascii(name)) {
+		const std::string* key = lookup(name_index, name);
+		if (!key) {
+			return false;
+		}
+		name_key = *key;
+	}
+
+	const uint64_t name_hash = hash_key(hash_dir(*dir_key), name_key);
+
+	auto find = [&](StringView ext) -> const std::string* {
+		auto range = file_index.equal_range(hash_key(name_hash, ext));
+		for (auto it = range.first; it != range.second; ++it) {
+			const auto& file = it->second;
+			if (file.dir == *dir_key && name_equals(file.name, name_key, ext)) {
+				return &file.path;
+			}
+		}
+		return nullptr;
+	};
+
+	if (exts.empty()) {
+		found = find("");
+	} else {
+		for (const auto& ext : exts) {
+			// FindFile does not lower the extensions
+			if (std::any_of(ext.begin(), ext.end(), [](char c) { return fold(c) != c; })) {
+				return false;
+			}
+			found = find(ext);
+			if (found) {
+				break;
+			}
+		}
+	}
+
+	return true;
+}
@@ -18,11 +18,13 @@
 #ifndef EP_DIRECTORY_TREE_H
 #define EP_DIRECTORY_TREE_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
+#include "memory_stats.h"
 #include "span.h"
 #include "string_view.h"
 
@@ -123,6 +125,18 @@ public:
 	 */
 	std::string FindFile(const DirectoryTree::Args& args) const;
 
+	/**
+	 * Does a case insensitive search for the file without allocating.
+	 * Only directories which were already searched with FindFile using the
+	 * same spelling are indexed, FindFile must be used when this fails.
+	 *
+	 * @param path a path relative to the filesystem root
+	 * @param exts List of file extensions to probe
+	 * @param found Set to the path of the file or nullptr when not found
+	 * @return false when the path can't be handled by the index
+	 */
+	bool FindIndexed(StringView path, Span<StringView> exts, const std::string*& found) const;
+
 	/**
 	 * Enumerates a directory.
 	 *
@@ -134,6 +148,9 @@ public:
 	void ClearCache(StringView path) const;
 
 private:
+	/** Reports the size of the caches to MemoryStats */
+	void MeasureCache(MemoryStats::Source& source) const;
+
 	Filesystem* fs = nullptr;
 
 	/** lowered dir (full path from root) -> <map of> lowered file -> Entry */
@@ -141,6 +158,34 @@ private:
 
 	/** lowered dir -> real dir (both full path from root) */
 	mutable std::unordered_map<std::string, std::string> dir_cache;
+
+	struct IndexedName {
+		/** name as passed to FindFile */
+		std::string name;
+		/** lowered name */
+		std::string key;
+	};
+
+	struct IndexedFile {
+		/** lowered dir */
+		std::string dir;
+		/** lowered filename */
+		std::string name;
+		/** real path of the file */
+		std::string path;
+	};
+
+	/** hash of dir as passed to FindFile -> lowered dir */
+	mutable std::unordered_multimap<uint64_t, IndexedName> dir_index;
+
+	/** hash of non-ASCII filename as passed to FindFile -> lowered filename */
+	mutable std::unordered_multimap<uint64_t, IndexedName> name_index;
+
+	/** hash of lowered dir and filename -> regular file, for all enumerated directories */
+	mutable std::unordered_multimap<uint64_t, IndexedFile> file_index;
+
+	/** Entries are the cached directories */
+	mutable MemoryStats::Source cache_stats{"Directories", [this](MemoryStats::Source& source) { MeasureCache(source); }};
 };
 
 inline bool operator<(const DirectoryTree::Entry& l, const DirectoryTree::Entry& r) {
@@ -33,6 +33,7 @@ DrawableList::~DrawableList() {
 
 void DrawableList::Clear() {
 	_list.clear();
+	_keys.clear();
 	SetClean();
 }
 
@@ -44,16 +45,128 @@ void DrawableList::Sort() {
 	// stable sort to work around a flickering event sprite issue when
 	// the map is scrolling (have same Z value)
 	std::stable_sort(_list.begin(), _list.end(), DrawCmp);
+
+	_keys.resize(_list.size());
+	for (size_t i = 0; i < _list.size(); ++i) {
+		_keys[i] = _list[i]->GetZ();
+	}
+
 	SetClean();
 }
 
+void DrawableList::OnUpdateZ(Drawable* drawable) {
+	if (_dirty) {
+		return;
+	}
+
+	for (auto& m : _moved) {
+		if (m.drawable == drawable) {
+			return;
+		}
+	}
+
+	if (_moved.size() >= max_moved) {
+		SetDirty();
+		return;
+	}
+
+	_moved.push_back({ drawable, drawable->GetZ() });
+}
+
+void DrawableList::ReinsertMoved() {
+	struct Item {
+		Drawable* drawable;
+		int z;
+		size_t old_pos;
+		size_t target;
+	};
+
+	// Locate the moved drawables by their old Z value
+	std::vector<Item> items;
+	items.reserve(_moved.size());
+	for (auto& m : _moved) {
+		auto range = std::equal_range(_keys.begin(), _keys.end(), m.old_z);
+		for (auto it = range.first; it != range.second; ++it) {
+			size_t pos = it - _keys.begin();
+			if (_list[pos] == m.drawable) {
+				items.push_back({ m.drawable, m.drawable->GetZ(), pos, 0 });
+				break;
+			}
+		}
+	}
+	_moved.clear();
+
+	if (items.empty()) {
+		return;
+	}
+
+	std::sort(items.begin(), items.end(), [](const Item& l, const Item& r) {
+		return l.old_pos < r.old_pos;
+	});
+
+	// Take them out, the remaining drawables stay sorted
+	size_t write = items.front().old_pos;
+	size_t next_item = 0;
+	for (size_t read = write; read < _list.size(); ++read) {
+		if (next_item < items.size() && items[next_item].old_pos == read) {
+			++next_item;
+			continue;
+		}
+		_list[write] = _list[read];
+		_keys[write] = _keys[read];
+		++write;
+	}
+	_list.resize(write);
+	_keys.resize(write);
+
+	// A stable sort keeps the old order for equal Z. Of the remaining drawables
+	// with the same Z the ones which were in front of the moved drawable are
+	// exactly those with an index below old_pos - (number of moved drawables in front).
+	for (size_t i = 0; i < items.size(); ++i) {
+		auto& item = items[i];
+		auto lo = std::lower_bound(_keys.begin(), _keys.end(), item.z) - _keys.begin();
+		auto hi = std::upper_bound(_keys.begin() + lo, _keys.end(), item.z) - _keys.begin();
+		size_t before = item.old_pos - i;
+		item.target = std::min<size_t>(std::max<size_t>(before, lo), hi);
+	}
+
+	// Drawables moved to the same gap are ordered by Z, then by their old order
+	std::sort(items.begin(), items.end(), [](const Item& l, const Item& r) {
+		if (l.target != r.target) {
+			return l.target < r.target;
+		}
+		if (l.z != r.z) {
+			return l.z < r.z;
+		}
+		return l.old_pos < r.old_pos;
+	});
+
+	// Merge them back in from the end
+	size_t read = _list.size();
+	_list.resize(_list.size() + items.size());
+	_keys.resize(_list.size());
+	write = _list.size();
+	for (auto it = items.rbegin(); it != items.rend(); ++it) {
+		while (read > it->target) {
+			--read;
+			--write;
+			_list[write] = _list[read];
+			_keys[write] = _keys[read];
+		}
+		--write;
+		_list[write] = it->drawable;
+		_keys[write] = it->z;
+	}
+}
+
 void DrawableList::Append(Drawable* ptr) {
 	assert(ptr != nullptr);
 	assert(_list.end() == std::find(_list.begin(), _list.end(), ptr));
 
-	const bool ordered = _list.empty() || !DrawCmp(ptr, _list.back());
+	const bool ordered = _keys.empty() || ptr->GetZ() >= _keys.back();
 
 	_list.push_back(ptr);
+	_keys.push_back(ptr->GetZ());
 
 	if (!ordered) {
 		SetDirty();
@@ -68,7 +181,14 @@ Drawable* DrawableList::Take(Drawable* ptr) {
 
 	auto ret = *iter;
 	// FIXME: Can we remove this O(N) operation here?
+	_keys.erase(_keys.begin() + (iter - _list.begin()));
 	_list.erase(iter);
+
+	auto moved = std::find_if(_moved.begin(), _moved.end(), [ptr](const Moved& m) { return m.drawable == ptr; });
+	if (moved != _moved.end()) {
+		_moved.erase(moved);
+	}
+
 	return ret;
 
 	// Removing doesn't change sorted order, so not dirty flag.
@@ -84,30 +204,36 @@ void DrawableList::TakeFrom(DrawableList& other) noexcept {
 	}
 
 	_list.insert(_list.end(), olist.begin(), olist.end());
+	_keys.insert(_keys.end(), other._keys.begin(), other._keys.end());
 	olist.clear();
+	other._keys.clear();
 
 	SetDirty();
 	other.SetClean();
 }
 
 void DrawableList::Draw(Bitmap& dst, int min_z, int max_z) {
-	if (IsDirty()) {
+	if (_dirty) {
 		Sort();
-	} else {
-		assert(IsSorted());
+	} else if (!_moved.empty()) {
+		ReinsertMoved();
 	}
 
-	for (auto* drawable : _list) {
-		auto z = drawable->GetZ();
+	for (size_t i = 0; i < _list.size(); ++i) {
+		auto z = _keys[i];
 		if (z < min_z) {
 			continue;
 		}
 		if (z > max_z) {
 			break;
 		}
+
+		auto* drawable = _list[i];
+		// A Z change that was not reported to this list
+		assert(drawable->GetZ() == z);
+
 		if (drawable->IsVisible()) {
 			drawable->Draw(dst);
 		}
 	}
 }
-
@@ -25,6 +25,11 @@
 
 /** A list of Drawable objects. These are used by the graphics engine store and
  * to render all drawable objects.
+ *
+ * The list remembers the Z value of every drawable at the time it was ordered.
+ * When only a few drawables change their Z between two draws they are taken out
+ * and put back at their new place instead of sorting the whole list again. The
+ * result is the same as a stable sort of the previous order.
  */
 class DrawableList {
 	public:
@@ -92,6 +97,14 @@ class DrawableList {
 		/** Mark the list as dirty. It will be sorted the next time Draw() is called */
 		void SetDirty();
 
+		/**
+		 * Notify the list that the Z value of a drawable is about to change.
+		 * Must be called before the new Z value is assigned.
+		 *
+		 * @param drawable the Drawable which Z value changes
+		 */
+		void OnUpdateZ(Drawable* drawable);
+
 		/** @return an iterator to the beginning */
 		iterator begin() const { return _list.begin(); }
 
@@ -132,10 +145,25 @@ class DrawableList {
 		void Draw(Bitmap& dst, int min_z, int max_z);
 
 	private:
+		struct Moved {
+			Drawable* drawable;
+			int old_z;
+		};
+
+		/** Above this amount of moved drawables the whole list is sorted again */
+		static constexpr size_t max_moved = 64;
+
 		std::vector<Drawable*> _list;
+		/** Z value of the drawable at the same index when it was ordered */
+		std::vector<int> _keys;
+		/** Drawables which changed their Z since the list was ordered */
+		std::vector<Moved> _moved;
 		bool _dirty = false;
 
 		void SetClean();
+
+		/** Puts the moved drawables back into order */
+		void ReinsertMoved();
 };
 
 template <typename T>
@@ -149,25 +177,29 @@ void DrawableList::TakeFrom(DrawableList& other, F&& cond) noexcept {
 	if (&other == this) { return; }
 
 	auto& olist = other._list;
+	auto& okeys = other._keys;
 
-	int shift = 0;
-	const auto end = olist.end();
-	for (auto iter = olist.begin(); iter != end - shift;) {
+	size_t shift = 0;
+	const size_t end = olist.size();
+	for (size_t i = 0; i < end - shift;) {
 		if (shift) {
-			*iter = std::move(*(iter + shift));
+			olist[i] = olist[i + shift];
+			okeys[i] = okeys[i + shift];
 		}
 
-		auto* draw = *iter;
+		auto* draw = olist[i];
 
 		if (cond(draw)) {
 			_list.push_back(draw);
+			_keys.push_back(okeys[i]);
 			++shift;
 			continue;
 		}
 
-		++iter;
+		++i;
 	}
 	olist.resize(olist.size() - shift);
+	okeys.resize(okeys.size() - shift);
 
 	SetDirty();
 	if (olist.empty()) {
@@ -176,7 +208,7 @@ void DrawableList::TakeFrom(DrawableList& other, F&& cond) noexcept {
 }
 
 inline bool DrawableList::IsDirty() const {
-	return _dirty;
+	return _dirty || !_moved.empty();
 }
 
 inline void DrawableList::SetDirty() {
@@ -185,6 +217,7 @@ inline void DrawableList::SetDirty() {
 
 inline void DrawableList::SetClean() {
 	_dirty = false;
+	_moved.clear();
 }
 
 inline void DrawableList::Draw(Bitmap& dst) {
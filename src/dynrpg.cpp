@@ -27,8 +27,11 @@
 #include "dynrpg_easyrpg.h"
 
 #include <cstring>
+#include <deque>
 #include <fstream>
+#include <limits>
 #include <map>
+#include <unordered_map>
 
 enum DynRpg_ParseMode {
 	ParseMode_Function,
@@ -48,6 +51,129 @@ namespace {
 
 	// DynRpg Function table
 	dyn_rpg_func dyn_rpg_functions;
+
+	/** Argument of a parsed DynRPG call */
+	struct DynRpgArg {
+		enum class Type {
+			/** Passed unchanged */
+			Literal,
+			/** Value of a variable */
+			Variable,
+			/** Name of an actor */
+			ActorName
+		};
+
+		Type type = Type::Literal;
+		/** Value of a literal, original token of a reference */
+		DynRpg::Arg value;
+		/** Id the reference starts with */
+		int id = 0;
+		/** Variable lookups applied to the id, one per V */
+		int lookups = 0;
+	};
+
+	/** DynRPG comment parsed once and invoked many times */
+	struct DynRpgCall {
+		/** Comment text, viewed by the key in call_cache */
+		std::string command;
+		std::string function_name;
+		dynfunc func = nullptr;
+		std::vector<DynRpgArg> args;
+	};
+
+	struct StringViewHash {
+		size_t operator()(StringView s) const {
+			// FNV-1a
+			uint64_t hash = 0xcbf29ce484222325;
+			for (char c : s) {
+				hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	// Parsed calls indexed by the comment text. Held by shared_ptr because
+	// a nested invocation can clear the cache while the call runs.
+	std::unordered_map<StringView, std::shared_ptr<const DynRpgCall>, StringViewHash> call_cache;
+	// Games with generated comments would grow the cache without bound
+	constexpr size_t call_cache_limit = 1024;
+
+	// Resolved arguments per nesting depth of Invoke, reused between calls.
+	// A deque keeps the buffers of outer invocations in place.
+	std::deque<std::vector<DynRpg::Arg>> arg_stack;
+	size_t invoke_depth = 0;
+
+	/** Parses text that is only an integer like istream >> int would */
+	bool ParseInt(StringView text, int& value) {
+		auto it = text.begin();
+		const bool negative = it != text.end() && *it == '-';
+		if (negative) {
+			++it;
+		}
+		if (it == text.end()) {
+			return false;
+		}
+
+		const int64_t limit = negative ? -int64_t(std::numeric_limits<int>::min()) : std::numeric_limits<int>::max();
+		int64_t result = 0;
+		for (; it != text.end(); ++it) {
+			if (*it < '0' || *it > '9') {
+				return false;
+			}
+			result = result * 10 + (*it - '0');
+			if (result > limit) {
+				return false;
+			}
+		}
+
+		value = static_cast<int>(negative ? -result : result);
+		return true;
+	}
+}
+
+DynRpg::Arg::Arg(std::string text) : text(std::move(text)) {
+	is_int = ParseInt(this->text, number);
+}
+
+void DynRpg::Arg::SetText(StringView new_text) {
+	text.assign(new_text.data(), new_text.size());
+	has_text = true;
+	is_int = ParseInt(text, number);
+}
+
+void DynRpg::Arg::SetInt(int value) {
+	number = value;
+	is_int = true;
+	has_text = false;
+}
+
+const std::string& DynRpg::Arg::GetText() const {
+	if (!has_text) {
+		char buf[12];
+		char* p = buf + sizeof(buf);
+		unsigned int u = number < 0 ? 0u - static_cast<unsigned int>(number) : static_cast<unsigned int>(number);
+		do {
+			*--p = static_cast<char>('0' + u % 10);
+			u /= 10;
+		} while (u != 0);
+		if (number < 0) {
+			*--p = '-';
+		}
+		text.assign(p, buf + sizeof(buf));
+		has_text = true;
+	}
+	return text;
+}
+
+bool DynRpg::Arg::GetInt(int& value) const {
+	if (is_int) {
+		value = number;
+	}
+	return is_int;
+}
+
+bool DynRpg::Arg::empty() const {
+	return !is_int && text.empty();
 }
 
 void DynRpg::RegisterFunction(const std::string& name, dynfunc func) {
@@ -67,12 +193,13 @@ std::string DynRpg::ParseVarArg(StringView func_name, dyn_arg_list args, int ind
 		return "";
 	}
 
-	std::string::iterator text_index, end;
-	std::string text = args[index];
+	std::string::const_iterator text_index, end;
+	const std::string& text = args[index].GetText();
 	text_index = text.begin();
 	end = text.end();
 
-	std::stringstream msg;
+	std::string msg;
+	msg.reserve(text.size());
 
 	for (; text_index != end; ++text_index) {
 		char chr = *text_index;
@@ -84,13 +211,13 @@ std::string DynRpg::ParseVarArg(StringView func_name, dyn_arg_list args, int ind
 
 			if (n == '$') {
 				// $$ = $
-				msg << n;
+				msg += n;
 				++text_index;
 			} else if (n >= '1' && n <= '9') {
 				int i = (int)(n - '0');
 
 				if (i + index < static_cast<int>(args.size())) {
-					msg << args[i + index];
+					msg += args[i + index].GetText();
 				}
 				else {
 					// $-ref out of range
@@ -101,22 +228,21 @@ std::string DynRpg::ParseVarArg(StringView func_name, dyn_arg_list args, int ind
 
 				++text_index;
 			} else {
-				msg << chr;
+				msg += chr;
 			}
 		} else {
-			msg << chr;
+			msg += chr;
 		}
 	}
 
-	return msg.str();
+	return msg;
 }
 
 
-static std::string ParseToken(const std::string& token, const std::string& function_name) {
+static DynRpgArg ParseToken(std::string token) {
 	std::string::iterator text_index, end;
-	std::string text = token;
-	text_index = text.begin();
-	end = text.end();
+	text_index = token.begin();
+	end = token.end();
 
 	char chr = *text_index;
 
@@ -124,8 +250,9 @@ static std::string ParseToken(const std::string& token, const std::string& funct
 
 	bool number_encountered = false;
 
-	std::stringstream var_part;
-	std::stringstream number_part;
+	DynRpgArg arg;
+	bool actor = false;
+	std::string number_part;
 
 	for (;;) {
 		if (text_index != end) {
@@ -133,43 +260,25 @@ static std::string ParseToken(const std::string& token, const std::string& funct
 		}
 
 		if (text_index == end) {
-			// Variable reference
-			std::string tmp = number_part.str();
-			int number = atoi(tmp.c_str());
-			tmp = var_part.str();
-			if (tmp.empty()) {
-				return token;
-			}
-
-			// Convert backwards
-			for (std::string::reverse_iterator it = tmp.rbegin(); it != tmp.rend(); ++it) {
-				if (*it == 'N') {
-					if (!Main_Data::game_actors->ActorExists(number)) {
-						Output::Warning("{}: Invalid actor id {} in {}", function_name, number, token);
-						return "";
-					}
-
-					// N is last
-					return ToString(Main_Data::game_actors->GetActor(number)->GetName());
-				} else {
-					// Variable
-					number = Main_Data::game_variables->Get(number);
-				}
+			if (actor || arg.lookups > 0) {
+				// Reference, resolved on every invocation
+				arg.type = actor ? DynRpgArg::Type::ActorName : DynRpgArg::Type::Variable;
+				arg.id = atoi(number_part.c_str());
+				arg.value = DynRpg::Arg(std::move(token));
+			} else {
+				arg.value = DynRpg::Arg(std::move(token));
 			}
-
-			number_part.str("");
-			number_part << number;
-			return number_part.str();
+			return arg;
 		} else if (number_encountered || (chr >= '0' && chr <= '9')) {
 			number_encountered = true;
-			number_part << chr;
+			number_part += chr;
 		} else if (chr == 'N') {
 			if (!first) {
 				break;
 			}
-			var_part << chr;
+			actor = true;
 		} else if (chr == 'V') {
-			var_part << chr;
+			++arg.lookups;
 		} else {
 			break;
 		}
@@ -179,7 +288,40 @@ static std::string ParseToken(const std::string& token, const std::string& funct
 	}
 
 	// Normal token
-	return Utils::LowerCase(token);
+	arg.lookups = 0;
+	arg.value = DynRpg::Arg(Utils::LowerCase(token));
+	return arg;
+}
+
+static DynRpgArg LiteralArg(std::string text) {
+	DynRpgArg arg;
+	arg.value = DynRpg::Arg(std::move(text));
+	return arg;
+}
+
+static void ResolveArg(const DynRpgArg& arg, const std::string& function_name, DynRpg::Arg& out) {
+	if (arg.type == DynRpgArg::Type::Literal) {
+		out = arg.value;
+		return;
+	}
+
+	int number = arg.id;
+	for (int i = 0; i < arg.lookups; ++i) {
+		number = Main_Data::game_variables->Get(number);
+	}
+
+	if (arg.type == DynRpgArg::Type::Variable) {
+		out.SetInt(number);
+		return;
+	}
+
+	if (!Main_Data::game_actors->ActorExists(number)) {
+		Output::Warning("{}: Invalid actor id {} in {}", function_name, number, arg.value.GetText());
+		out.SetText("");
+		return;
+	}
+
+	out.SetText(Main_Data::game_actors->GetActor(number)->GetName());
 }
 
 void create_all_plugins() {
@@ -192,16 +334,15 @@ void create_all_plugins() {
 	init = true;
 }
 
-std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::string>& args) {
+static std::string ParseCall(StringView command, std::vector<DynRpgArg>& args) {
 	if (command.empty()) {
 		// Not a DynRPG function (empty comment)
 		return "";
 	}
 
-	std::string::iterator text_index, end;
-	std::string text = command;
-	text_index = text.begin();
-	end = text.end();
+	StringView::iterator text_index, end;
+	text_index = command.begin();
+	end = command.end();
 
 	char chr = *text_index;
 
@@ -212,7 +353,6 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 
 	DynRpg_ParseMode mode = ParseMode_Function;
 	std::string function_name;
-	std::string tmp;
 	std::stringstream token;
 
 	++text_index;
@@ -225,6 +365,8 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 
 	// All arguments are passed as string to the DynRpg functions and are
 	// converted to int or float on demand.
+	// Tokens that reference a var or an actor are resolved on every
+	// invocation, everything else only once.
 
 	for (;;) {
 		if (text_index != end) {
@@ -248,16 +390,15 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 				case ParseMode_WaitForArg:
 					if (!args.empty()) {
 						// Found , but no token -> empty arg
-						args.emplace_back("");
+						args.push_back(DynRpgArg());
 					}
 					break;
 				case ParseMode_String:
 					// Unterminated literal, handled like a terminated literal
-					args.emplace_back(token.str());
+					args.push_back(LiteralArg(token.str()));
 					break;
 				case ParseMode_Token:
-					tmp = ParseToken(token.str(), function_name);
-					args.emplace_back(tmp);
+					args.push_back(ParseToken(token.str()));
 					break;
 			}
 
@@ -299,7 +440,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 					}
 					token.str("");
 					// Empty arg
-					args.emplace_back("");
+					args.push_back(DynRpgArg());
 					mode = ParseMode_WaitForArg;
 					break;
 				case ParseMode_WaitForComma:
@@ -307,14 +448,13 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 					break;
 				case ParseMode_WaitForArg:
 					// Empty arg
-					args.emplace_back("");
+					args.push_back(DynRpgArg());
 					break;
 				case ParseMode_String:
 					token << chr;
 					break;
 				case ParseMode_Token:
-					tmp = ParseToken(token.str(), function_name);
-					args.emplace_back(tmp);
+					args.push_back(ParseToken(token.str()));
 					// already on a comma
 					mode = ParseMode_WaitForArg;
 					token.str("");
@@ -349,7 +489,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 						}
 						else {
 							// End of string
-							args.emplace_back(token.str());
+							args.push_back(LiteralArg(token.str()));
 
 							mode = ParseMode_WaitForComma;
 							token.str("");
@@ -371,19 +511,80 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 	return function_name;
 }
 
-bool DynRpg::Invoke(const std::string& command) {
+std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::string>& args) {
+	std::vector<DynRpgArg> parsed_args;
+	std::string function_name = ParseCall(command, parsed_args);
+
+	if (function_name.empty()) {
+		return function_name;
+	}
+
+	DynRpg::Arg value;
+	for (const auto& arg : parsed_args) {
+		ResolveArg(arg, function_name, value);
+		args.push_back(value.GetText());
+	}
+
+	return function_name;
+}
+
+bool DynRpg::Invoke(StringView command) {
 	if (!init) {
 		create_all_plugins();
 	}
 
-	std::vector<std::string> args;
-	std::string function_name = ParseCommand(command, args);
+	if (command.empty() || command.front() != '@') {
+		// Not a DynRPG function, normal comment
+		return true;
+	}
 
-	if (function_name.empty()) {
+	// Comments are parsed once, repeated invocations only resolve the
+	// variable references
+	std::shared_ptr<const DynRpgCall> call;
+	auto it = call_cache.find(command);
+	if (it != call_cache.end()) {
+		call = it->second;
+	} else {
+		auto new_call = std::make_shared<DynRpgCall>();
+		new_call->command = ToString(command);
+		new_call->function_name = ParseCall(command, new_call->args);
+		auto fit = dyn_rpg_functions.find(new_call->function_name);
+		if (fit != dyn_rpg_functions.end()) {
+			new_call->func = fit->second;
+		}
+
+		if (call_cache.size() >= call_cache_limit) {
+			// Parsing again is cheap, start over instead of tracking usage
+			call_cache.clear();
+		}
+		call_cache.emplace(new_call->command, new_call);
+		call = std::move(new_call);
+	}
+
+	if (call->function_name.empty()) {
+		return true;
+	}
+
+	if (!call->func) {
+		// Not a supported function
+		Output::Warning("Unsupported DynRPG function: {}", call->function_name);
 		return true;
 	}
 
-	return Invoke(function_name, args);
+	if (invoke_depth == arg_stack.size()) {
+		arg_stack.emplace_back();
+	}
+	auto& values = arg_stack[invoke_depth];
+	values.resize(call->args.size());
+	for (size_t i = 0; i < call->args.size(); ++i) {
+		ResolveArg(call->args[i], call->function_name, values[i]);
+	}
+
+	++invoke_depth;
+	bool result = call->func(values);
+	--invoke_depth;
+
+	return result;
 }
 
 bool DynRpg::Invoke(const std::string& func, dyn_arg_list args) {
@@ -530,5 +731,7 @@ void DynRpg::Update() {
 void DynRpg::Reset() {
 	init = false;
 	dyn_rpg_functions.clear();
+	call_cache.clear();
+	arg_stack.clear();
 	plugins.clear();
 }
@@ -33,7 +33,55 @@ namespace rpg {
 }
 }
 
-using dyn_arg_list = const Span<std::string>;
+namespace DynRpg {
+	/**
+	 * Argument passed to a DynRPG function.
+	 * Integer literals are parsed once, variable references are stored as
+	 * number and only converted to text when the text is requested.
+	 */
+	class Arg {
+	public:
+		Arg() = default;
+		Arg(std::string text);
+		Arg(const char* text) : Arg(std::string(text)) {}
+
+		/**
+		 * Sets a text, integers are detected.
+		 *
+		 * @param text new text
+		 */
+		void SetText(StringView text);
+
+		/**
+		 * Sets an integer, the text is created on demand.
+		 *
+		 * @param value new value
+		 */
+		void SetInt(int value);
+
+		/** @return the argument as text */
+		const std::string& GetText() const;
+
+		/**
+		 * Retrieves the value of an integer argument.
+		 *
+		 * @param value filled with the value when the argument is an integer
+		 * @return whether the argument is an integer
+		 */
+		bool GetInt(int& value) const;
+
+		/** @return whether the text is empty */
+		bool empty() const;
+
+	private:
+		mutable std::string text;
+		int number = 0;
+		bool is_int = false;
+		mutable bool has_text = true;
+	};
+}
+
+using dyn_arg_list = const Span<const DynRpg::Arg>;
 using dynfunc = bool(*)(dyn_arg_list);
 
 /**
@@ -53,16 +101,22 @@ namespace DynRpg {
 		inline bool parse_arg(StringView func_name, dyn_arg_list args, const int i, float& value, bool& parse_okay) {
 			if (!parse_okay) return false;
 			value = 0.0;
+			int int_value;
+			if (args[i].GetInt(int_value)) {
+				value = static_cast<float>(int_value);
+				parse_okay = true;
+				return parse_okay;
+			}
 			if (args[i].empty()) {
 				parse_okay = true;
 				return parse_okay;
 			}
-			std::istringstream iss(args[i]);
+			std::istringstream iss(args[i].GetText());
 			iss.imbue(std::locale::classic());
 			iss >> value;
 			parse_okay = !iss.fail();
 			if (!parse_okay) {
-				Output::Warning("{}: Arg {} ({}) is not numeric", func_name, i, args[i]);
+				Output::Warning("{}: Arg {} ({}) is not numeric", func_name, i, args[i].GetText());
 				parse_okay = false;
 			}
 			return parse_okay;
@@ -72,15 +126,19 @@ namespace DynRpg {
 		inline bool parse_arg(StringView func_name, dyn_arg_list args, const int i, int& value, bool& parse_okay) {
 			if (!parse_okay) return false;
 			value = 0;
+			if (args[i].GetInt(value)) {
+				parse_okay = true;
+				return parse_okay;
+			}
 			if (args[i].empty()) {
 				parse_okay = true;
 				return parse_okay;
 			}
-			std::istringstream iss(args[i]);
+			std::istringstream iss(args[i].GetText());
 			iss >> value;
 			parse_okay = !iss.fail();
 			if (!parse_okay) {
-				Output::Warning("{}: Arg {} ({}) is not an integer", func_name, i, args[i]);
+				Output::Warning("{}: Arg {} ({}) is not an integer", func_name, i, args[i].GetText());
 				parse_okay = false;
 			}
 			return parse_okay;
@@ -89,7 +147,7 @@ namespace DynRpg {
 		template <>
 		inline bool parse_arg(StringView, dyn_arg_list args, const int i, std::string& value, bool& parse_okay) {
 			if (!parse_okay) return false;
-			value = args[i];
+			value = args[i].GetText();
 			parse_okay = true;
 			return parse_okay;
 		}
@@ -104,7 +162,16 @@ namespace DynRpg {
 	bool HasFunction(const std::string& name);
 	std::string ParseVarArg(StringView func_name, dyn_arg_list args, int index, bool& parse_okay);
 	std::string ParseCommand(const std::string& command, std::vector<std::string>& params);
-	bool Invoke(const std::string& command);
+	/**
+	 * Parses and executes a DynRPG comment.
+	 * The parsed call is cached, executing the same comment again only
+	 * resolves the variable and actor references.
+	 * Functions may invoke further comments.
+	 *
+	 * @param command comment text
+	 * @return false when the interpreter must wait
+	 */
+	bool Invoke(StringView command);
 	bool Invoke(const std::string& func, dyn_arg_list args);
 	void Update();
 	void Reset();
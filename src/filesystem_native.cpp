@@ -27,6 +27,60 @@
 #include "system.h"
 #include "output.h"
 #include "platform.h"
+#include "filesystem_stream.h"
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__) && \
+	!defined(_3DS) && !defined(PSP2) && !defined(__SWITCH__) && !defined(GEKKO)
+#  define EP_FILESYSTEM_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#ifdef EP_FILESYSTEM_MMAP
+namespace {
+	/** Smaller files are read through a filebuf, mapping them is not worth the syscalls */
+	constexpr off_t mmap_min_size = 32 * 1024;
+
+	/** Read-only stream buffer over a memory mapped file */
+	class MappedStreamBuf : public Filesystem_Stream::InputMemoryStreamBuf {
+	public:
+		MappedStreamBuf(void* addr, size_t size) :
+			InputMemoryStreamBuf(Span<uint8_t>(static_cast<uint8_t*>(addr), size)), addr(addr), size(size) {}
+
+		~MappedStreamBuf() override {
+			munmap(addr, size);
+		}
+
+	private:
+		void* addr;
+		size_t size;
+	};
+
+	std::streambuf* CreateMappedStreambuffer(const std::string& path) {
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return nullptr;
+		}
+
+		std::streambuf* buf = nullptr;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= mmap_min_size) {
+			void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (addr != MAP_FAILED) {
+				// Assets are usually read from start to end
+				madvise(addr, st.st_size, MADV_SEQUENTIAL);
+				buf = new MappedStreamBuf(addr, st.st_size);
+			}
+		}
+
+		// The mapping stays valid after closing the file
+		close(fd);
+		return buf;
+	}
+}
+#endif
 
 NativeFilesystem::NativeFilesystem(std::string base_path, FilesystemView parent_fs) : Filesystem(std::move(base_path), parent_fs) {
 }
@@ -48,6 +102,15 @@ int64_t NativeFilesystem::GetFilesize(StringView path) const {
 }
 
 std::streambuf* NativeFilesystem::CreateInputStreambuffer(StringView path, std::ios_base::openmode mode) const {
+#ifdef EP_FILESYSTEM_MMAP
+	if ((mode & std::ios_base::out) == 0) {
+		auto* mapped_buf = CreateMappedStreambuffer(ToString(path));
+		if (mapped_buf) {
+			return mapped_buf;
+		}
+	}
+#endif
+
 	auto* buf = new std::filebuf();
 	buf->open(
 #ifdef _MSC_VER
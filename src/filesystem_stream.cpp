@@ -45,6 +45,14 @@ StringView Filesystem_Stream::InputStream::GetName() const {
 	return name;
 }
 
+Span<const uint8_t> Filesystem_Stream::InputStream::GetUnreadMemory() const {
+	auto* buf = dynamic_cast<InputMemoryStreamBuf*>(rdbuf());
+	if (!buf) {
+		return {};
+	}
+	return buf->GetUnread();
+}
+
 Filesystem_Stream::OutputStream::OutputStream(std::streambuf* sb, FilesystemView fs, std::string name) :
 	std::ostream(sb), fs(std::move(fs)), name(std::move(name)) {};
 
@@ -80,6 +88,10 @@ Filesystem_Stream::InputMemoryStreamBuf::InputMemoryStreamBuf(Span<uint8_t> buff
 	setg(cbuffer, cbuffer, cbuffer + buffer.size());
 }
 
+Span<const uint8_t> Filesystem_Stream::InputMemoryStreamBuf::GetUnread() const {
+	return Span<const uint8_t>(reinterpret_cast<const uint8_t*>(gptr()), egptr() - gptr());
+}
+
 std::streambuf::pos_type Filesystem_Stream::InputMemoryStreamBuf::seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
 	std::streambuf::pos_type off;
 	if (dir == std::ios_base::beg) {
@@ -38,6 +38,15 @@ namespace Filesystem_Stream {
 
 		StringView GetName() const;
 
+		/**
+		 * Returns the unread data of the stream without copying it.
+		 * Only available when the stream is backed by memory, e.g. a memory
+		 * mapped file or a file from an archive.
+		 *
+		 * @return unread data or an empty span when not backed by memory
+		 */
+		Span<const uint8_t> GetUnreadMemory() const;
+
 		template <typename T>
 		bool ReadIntoObj(T& obj);
 
@@ -71,6 +80,9 @@ namespace Filesystem_Stream {
 		InputMemoryStreamBuf(InputMemoryStreamBuf const& other) = delete;
 		InputMemoryStreamBuf const& operator=(InputMemoryStreamBuf const& other) = delete;
 
+		/** @return data between the read position and the end of the buffer */
+		Span<const uint8_t> GetUnread() const;
+
 	protected:
 		std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
 		std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode mode) override;
@@ -290,9 +290,12 @@ std::streambuf* ZipFilesystem::CreateInputStreambuffer(StringView path, std::ios
 	if (it != zip_entries.end() && !it->second.is_directory) {
 		auto pool_it = input_pool.find(path_normalized);
 		if (pool_it != input_pool.end()) {
+			input_pool_stats.Hit();
 			return new Filesystem_Stream::InputMemoryStreamBuf(pool_it->second);
 		}
 
+		input_pool_stats.Miss();
+
 		auto zip_file = GetParent().OpenInputStream(GetPath());
 		zip_file.seekg(it->second.fileoffset);
 		StorageMethod method;
@@ -303,6 +306,7 @@ std::streambuf* ZipFilesystem::CreateInputStreambuffer(StringView path, std::ios
 			if (method == StorageMethod::Plain) {
 				auto data = std::vector<uint8_t>(it->second.filesize);
 				zip_file.read(reinterpret_cast<char*>(data.data()), data.size());
+				input_pool_stats.Allocate(data.size());
 				input_pool[path_normalized] = std::move(data);
 				return new Filesystem_Stream::InputMemoryStreamBuf(input_pool[path_normalized]);
 			} else if (method == StorageMethod::Deflate) {
@@ -326,6 +330,7 @@ std::streambuf* ZipFilesystem::CreateInputStreambuffer(StringView path, std::ios
 					Output::Warning("ZipFS: zlib failed for {}: {}", path_normalized, zlib_stream.msg);
 					return nullptr;
 				}
+				input_pool_stats.Allocate(dec_buf.size());
 				input_pool[path_normalized] = std::move(dec_buf);
 				return new Filesystem_Stream::InputMemoryStreamBuf(input_pool[path_normalized]);
 			} else {
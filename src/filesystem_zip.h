@@ -20,6 +20,7 @@
 
 #include "filesystem.h"
 #include "filesystem_stream.h"
+#include "memory_stats.h"
 #include <fstream>
 #include <memory>
 #include <unordered_map>
@@ -69,6 +70,7 @@ private:
 	static bool ReadLocalHeader(std::istream& zipfile, uint32_t& offset, StorageMethod& method, uint32_t& compressed_size);
 
 	mutable std::unordered_map<std::string, std::vector<uint8_t>> input_pool;
+	mutable MemoryStats::Source input_pool_stats{"Zip files"};
 	std::unordered_map<std::string, ZipEntry> zip_entries;
 	std::string encoding;
 };
@@ -43,9 +43,14 @@
 #include "cache.h"
 #include "player.h"
 #include "compiler.h"
+#include "memory_stats.h"
 
 // Static variables.
 namespace {
+	// Glyphs are not cached: Every rendered glyph is a miss, the entries
+	// are the bitmaps the bitmap fonts render their glyphs into
+	MemoryStats::Source glyph_stats("Glyphs");
+
     template <typename T>
 	BitmapFontGlyph const* find_glyph(const T& glyphset, char32_t code) {
 		auto iter = std::lower_bound(std::begin(glyphset), std::end(glyphset), code);
@@ -101,12 +106,16 @@ namespace {
 		using function_type = BitmapFontGlyph const*(*)(char32_t);
 
 		BitmapFont(const std::string& name, function_type func);
+		~BitmapFont() override;
 
 		Rect GetSize(StringView txt) const override;
 		Rect GetSize(char32_t ch) const override;
 
 		GlyphRet Glyph(char32_t code) override;
 
+		/** Frees the bitmap the glyphs are rendered into */
+		void ReleaseGlyphBitmap();
+
 	private:
 		function_type func;
 		BitmapRef glyph_bm;
@@ -178,6 +187,17 @@ BitmapFont::BitmapFont(const std::string& name, function_type func)
 	: Font(name, HEIGHT, false, false), func(func)
 {}
 
+BitmapFont::~BitmapFont() {
+	ReleaseGlyphBitmap();
+}
+
+void BitmapFont::ReleaseGlyphBitmap() {
+	if (glyph_bm) {
+		glyph_stats.Release(glyph_bm->GetSize());
+		glyph_bm.reset();
+	}
+}
+
 Rect BitmapFont::GetSize(char32_t ch) const {
 	size_t units = 0;
 	if (EP_LIKELY(!Utils::IsControlCharacter(ch))) {
@@ -206,12 +226,14 @@ Rect BitmapFont::GetSize(StringView txt) const {
 Font::GlyphRet BitmapFont::Glyph(char32_t code) {
 	if (EP_UNLIKELY(!glyph_bm)) {
 		glyph_bm = Bitmap::Create(nullptr, FULL_WIDTH, HEIGHT, 0, DynamicFormat(8,8,0,8,0,8,0,8,0,PF::Alpha));
+		glyph_stats.Allocate(glyph_bm->GetSize());
 	}
 	if (EP_UNLIKELY(Utils::IsControlCharacter(code))) {
 		return { glyph_bm, Rect(0, 0, 0, HEIGHT) };
 	}
 	auto glyph = func(code);
 	auto width = glyph->is_full? FULL_WIDTH : HALF_WIDTH;
+	glyph_stats.Miss();
 
 	glyph_bm->Clear();
 	uint8_t* data = reinterpret_cast<uint8_t*>(glyph_bm->pixels());
@@ -268,6 +290,8 @@ Font::GlyphRet FTFont::Glyph(char32_t glyph) {
 		Output::Error("Couldn't render FreeType character {:#x}", uint32_t(glyph));
 	}
 
+	glyph_stats.Miss();
+
 	FT_Bitmap const& ft_bitmap = face_->glyph->bitmap;
 	assert(face_->glyph->bitmap.pixel_mode == FT_PIXEL_MODE_MONO);
 
@@ -380,6 +404,10 @@ FontRef Font::Create(const std::string& name, int size, bool bold, bool italic)
 }
 
 void Font::Dispose() {
+	for (auto& font: { gothic, mincho, rmg2000, ttyp0 }) {
+		static_cast<BitmapFont&>(*font).ReleaseGlyphBitmap();
+	}
+
 #ifdef HAVE_FREETYPE
 	for(face_cache_type::const_iterator i = face_cache.begin(); i != face_cache.end(); ++i) {
 		if(i->second.expired()) { continue; }
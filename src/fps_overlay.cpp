@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include "fps_overlay.h"
@@ -24,6 +25,7 @@
 #include "input.h"
 #include "font.h"
 #include "drawable_mgr.h"
+#include "player.h"
 
 using namespace std::chrono_literals;
 
@@ -45,6 +47,9 @@ void FpsOverlay::UpdateText() {
 
 bool FpsOverlay::Update() {
 	int mod = static_cast<int>(Game_Clock::GetGameSpeedFactor());
+	if (mod > 1) {
+		mod = std::max(mod, logic_speed);
+	}
 	if (mod != last_speed_mod) {
 		speedup_dirty = true;
 		last_speed_mod = mod;
@@ -57,6 +62,12 @@ bool FpsOverlay::Update() {
 	}
 	last_refresh_time = now;
 
+	// Logic frames run since the last refresh, relative to the target rate
+	int logic_frames = Player::GetFrames();
+	auto logic_fps = (logic_frames - last_logic_frames) / std::chrono::duration<double>(dt).count();
+	logic_speed = Utils::RoundTo<int>(logic_fps / Game_Clock::GetTargetGameFps());
+	last_logic_frames = logic_frames;
+
 	UpdateText();
 
 	return true;
@@ -70,6 +70,9 @@ private:
 	std::string text;
 
 	int last_speed_mod = 1;
+	/** Measured game speed, exceeds the speed factor in turbo mode */
+	int logic_speed = 1;
+	int last_logic_frames = 0;
 	bool speedup_dirty = true;
 	bool fps_dirty = true;
 	bool draw_fps = true;
@@ -108,6 +108,7 @@ Game_Actor::Game_Actor(int actor_id) {
 
 void Game_Actor::SetSaveData(lcf::rpg::SaveActor save) {
 	data = std::move(save);
+	InvalidateStats();
 
 	if (Player::IsRPG2k()) {
 		data.two_weapon = dbActor->two_weapon;
@@ -311,6 +312,7 @@ int Game_Actor::SetEquipment(int equip_type, int new_item_id) {
 	}
 
 	data.equipped[equip_type - 1] = (short)new_item_id;
+	InvalidateStats();
 
 	AdjustEquipmentStates(old_item, false, false);
 	AdjustEquipmentStates(new_item, true, false);
@@ -725,6 +727,7 @@ void Game_Actor::ChangeExp(int exp, PendingMessage* pm) {
 
 void Game_Actor::SetLevel(int _level) {
 	data.level = Utils::Clamp(_level, 1, GetMaxLevel());
+	InvalidateStats();
 	// Ensure current HP/SP remain clamped if new Max HP/SP is less.
 	SetHp(GetHp());
 	SetSp(GetSp());
@@ -822,13 +825,7 @@ bool Game_Actor::IsEquipmentFixed() const {
 		return true;
 	}
 
-	for (auto state_id: GetInflictedStates()) {
-		auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, state_id);
-		if (state && state->cursed) {
-			return true;
-		}
-	}
-	return false;
+	return GetStateSet().Any(StateSet::Flag_Cursed);
 }
 
 const lcf::rpg::Skill* Game_Actor::GetRandomSkill() const {
@@ -1000,6 +997,7 @@ void Game_Actor::ChangeClass(int new_class_id,
 	data.agility_mod = 0;
 
 	data.class_id = new_class_id;
+	InvalidateStats();
 	data.changed_battle_commands = true; // Any change counts as a battle commands change.
 
 	// The class settings are not applied when the actor has a class on startup
@@ -1128,21 +1126,25 @@ int Game_Actor::SetSp(int sp) {
 void Game_Actor::SetBaseAtk(int atk) {
 	int new_attack_mod = data.attack_mod + (atk - GetBaseAtk());
 	data.attack_mod = ClampStatMod(new_attack_mod, this);
+	InvalidateStats();
 }
 
 void Game_Actor::SetBaseDef(int def) {
 	int new_defense_mod = data.defense_mod + (def - GetBaseDef());
 	data.defense_mod = ClampStatMod(new_defense_mod, this);
+	InvalidateStats();
 }
 
 void Game_Actor::SetBaseSpi(int spi) {
 	int new_spirit_mod = data.spirit_mod + (spi - GetBaseSpi());
 	data.spirit_mod = ClampStatMod(new_spirit_mod, this);
+	InvalidateStats();
 }
 
 void Game_Actor::SetBaseAgi(int agi) {
 	int new_agility_mod = data.agility_mod + (agi - GetBaseAgi());
 	data.agility_mod = ClampStatMod(new_agility_mod, this);
+	InvalidateStats();
 }
 
 Game_Actor::RowType Game_Actor::GetBattleRow() const {
@@ -1023,6 +1023,8 @@ inline const std::vector<int16_t>& Game_Actor::GetStates() const {
 }
 
 inline std::vector<int16_t>& Game_Actor::GetStates() {
+	// Caller can modify the states
+	InvalidateStats();
 	return data.status;
 }
 
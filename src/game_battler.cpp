@@ -53,14 +53,15 @@ bool Game_Battler::HasState(int state_id) const {
 }
 
 std::vector<int16_t> Game_Battler::GetInflictedStates() const {
-	auto& states = GetStates();
-	std::vector<int16_t> inf_states;
-	for (size_t i = 0; i < states.size(); ++i) {
-		if (states[i] > 0) {
-			inf_states.push_back(i + 1);
-		}
+	return GetStateSet().GetIds();
+}
+
+const StateSet& Game_Battler::GetStateSet() const {
+	if (!state_set_valid) {
+		state_set.Build(GetStates());
+		state_set_valid = true;
 	}
-	return inf_states;
+	return state_set;
 }
 
 PermanentStates Game_Battler::GetPermanentStates() const {
@@ -68,49 +69,23 @@ PermanentStates Game_Battler::GetPermanentStates() const {
 }
 
 bool Game_Battler::EvadesAllPhysicalAttacks() const {
-	for (auto state_id: GetInflictedStates()) {
-		auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, state_id);
-		if (state && state->avoid_attacks) {
-			return true;
-		}
-	}
-	return false;
+	return GetStateSet().Any(StateSet::Flag_AvoidAttacks);
 }
 
 lcf::rpg::State::Restriction Game_Battler::GetSignificantRestriction() const {
-	return State::GetSignificantRestriction(GetStates());
+	return GetStateSet().GetSignificantRestriction();
 }
 
 bool Game_Battler::CanAct() const {
-	const auto& states = GetStates();
-	for (size_t i = 0; i < states.size(); ++i) {
-		if (states[i] > 0) {
-			const auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, i + 1);
-			assert(state);
-			if (state->restriction == lcf::rpg::State::Restriction_do_nothing) {
-				return false;
-			}
-		}
-	}
-	return true;
+	return !GetStateSet().Any(StateSet::Flag_RestrictionDoNothing);
 }
 
 bool Game_Battler::CanActOrRecoverable() const {
-	const auto& states = GetStates();
-	for (size_t i = 0; i < states.size(); ++i) {
-		if (states[i] > 0) {
-			const auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, i + 1);
-			assert(state);
-			if (state->restriction == lcf::rpg::State::Restriction_do_nothing && state->auto_release_prob == 0) {
-				return false;
-			}
-		}
-	}
-	return true;
+	return !GetStateSet().Any(StateSet::Flag_DoNothingForever);
 }
 
 const lcf::rpg::State* Game_Battler::GetSignificantState() const {
-	return State::GetSignificantState(GetStates());
+	return GetStateSet().GetSignificantState();
 }
 
 int Game_Battler::GetStateRate(int state_id, int rate) const {
@@ -129,7 +104,7 @@ bool Game_Battler::IsSkillUsable(int skill_id) const {
 		return false;
 	}
 
-	for (auto state_id: GetInflictedStates()) {
+	for (auto state_id: GetStateSet().GetIds()) {
 		const auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, state_id);
 		if (state) {
 			if (state->restrict_skill && skill->physical_rate >= state->restrict_skill_level) {
@@ -501,18 +476,10 @@ bool Game_Battler::HasFullSp() const {
 	return GetMaxSp() == GetSp();
 }
 
-static int AdjustParam(int base, int mod, int maxval, Span<const int16_t> states, bool lcf::rpg::State::*adj) {
+static int AdjustParam(int base, int mod, int maxval, const StateSet& states, uint32_t half_flag, uint32_t dbl_flag) {
 	auto value = Utils::Clamp(base + mod, 1, maxval);
-	bool half = false;
-	bool dbl = false;
-	for (auto i: states) {
-		const auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, i);
-		assert(state);
-		if (state->*adj) {
-			half |= (state->affect_type == lcf::rpg::State::AffectType_half);
-			dbl |= (state->affect_type == lcf::rpg::State::AffectType_double);
-		}
-	}
+	bool half = states.Any(half_flag);
+	bool dbl = states.Any(dbl_flag);
 	if (dbl != half) {
 		if (dbl) {
 			value *= 2;
@@ -528,35 +495,69 @@ static int AdjustParam(int base, int mod, int maxval, Span<const int16_t> states
 }
 
 int Game_Battler::CalcValueAfterAtkStates(int value) const {
-	return AdjustParam(value, 0, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_attack);
+	return AdjustParam(value, 0, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_AtkHalf, StateSet::Flag_AtkDouble);
 }
 
 int Game_Battler::CalcValueAfterDefStates(int value) const {
-	return AdjustParam(value, 0, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_defense);
+	return AdjustParam(value, 0, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_DefHalf, StateSet::Flag_DefDouble);
 }
 
 int Game_Battler::CalcValueAfterSpiStates(int value) const {
-	return AdjustParam(value, 0, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_spirit);
+	return AdjustParam(value, 0, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_SpiHalf, StateSet::Flag_SpiDouble);
 }
 
 int Game_Battler::CalcValueAfterAgiStates(int value) const {
-	return AdjustParam(value, 0, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_agility);
+	return AdjustParam(value, 0, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_AgiHalf, StateSet::Flag_AgiDouble);
+}
+
+template <typename F>
+int Game_Battler::GetCachedStat(CachedStat stat, Weapon weapon, F&& calc) const {
+	const int weapon_idx = weapon - WeaponAll;
+	if (weapon_idx < 0 || weapon_idx >= cached_weapon_count) {
+		return calc();
+	}
+
+	const uint32_t bit = 1u << (stat * cached_weapon_count + weapon_idx);
+	int& value = stat_cache[stat][weapon_idx];
+	if ((stat_cache_valid & bit) == 0) {
+		value = calc();
+		stat_cache_valid |= bit;
+	}
+#ifdef EP_DEBUG_STAT_CACHE
+	else {
+		const int expected = calc();
+		if (value != expected) {
+			Output::Warning("Stat cache of {} out of date (Stat {}, Weapon {}): {} != {}", GetName(), static_cast<int>(stat), static_cast<int>(weapon), value, expected);
+			value = expected;
+		}
+	}
+#endif
+
+	return value;
 }
 
 int Game_Battler::GetAtk(Weapon weapon) const {
-	return AdjustParam(GetBaseAtk(weapon), atk_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_attack);
+	return GetCachedStat(CachedStat_Atk, weapon, [&]() {
+		return AdjustParam(GetBaseAtk(weapon), atk_modifier, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_AtkHalf, StateSet::Flag_AtkDouble);
+	});
 }
 
 int Game_Battler::GetDef(Weapon weapon) const {
-	return AdjustParam(GetBaseDef(weapon), def_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_defense);
+	return GetCachedStat(CachedStat_Def, weapon, [&]() {
+		return AdjustParam(GetBaseDef(weapon), def_modifier, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_DefHalf, StateSet::Flag_DefDouble);
+	});
 }
 
 int Game_Battler::GetSpi(Weapon weapon) const {
-	return AdjustParam(GetBaseSpi(weapon), spi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_spirit);
+	return GetCachedStat(CachedStat_Spi, weapon, [&]() {
+		return AdjustParam(GetBaseSpi(weapon), spi_modifier, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_SpiHalf, StateSet::Flag_SpiDouble);
+	});
 }
 
 int Game_Battler::GetAgi(Weapon weapon) const {
-	return AdjustParam(GetBaseAgi(weapon), agi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_agility);
+	return GetCachedStat(CachedStat_Agi, weapon, [&]() {
+		return AdjustParam(GetBaseAgi(weapon), agi_modifier, MaxStatBattleValue(), GetStateSet(), StateSet::Flag_AgiHalf, StateSet::Flag_AgiDouble);
+	});
 }
 
 int Game_Battler::GetDisplayX() const {
@@ -604,14 +605,7 @@ std::vector<int16_t> Game_Battler::BattleStateHeal() {
 }
 
 bool Game_Battler::HasReflectState() const {
-	for (int16_t i : GetInflictedStates()) {
-		// States are guaranteed to be valid
-		if (lcf::ReaderUtil::GetElement(lcf::Data::states, i)->reflect_magic) {
-			return true;
-		}
-	}
-
-	return false;
+	return GetStateSet().Any(StateSet::Flag_ReflectMagic);
 }
 
 void Game_Battler::ResetBattle() {
@@ -627,6 +621,7 @@ void Game_Battler::ResetBattle() {
 	def_modifier = 0;
 	spi_modifier = 0;
 	agi_modifier = 0;
+	InvalidateStats();
 	frame_counter = Rand::GetRandomNumber(0, 63);
 	battle_combo_command_id = -1;
 	battle_combo_times = 1;
@@ -670,15 +665,8 @@ int Game_Battler::CanShiftAttributeRate(int attribute_id, int shift) const {
 }
 
 int Game_Battler::GetHitChanceModifierFromStates() const {
-	int modifier = 100;
-	// Modify hit chance for each state the source has
-	for (const auto id : GetInflictedStates()) {
-		auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, id);
-		if (state) {
-			modifier = std::min<int>(modifier, state->reduce_hit_ratio);
-		}
-	}
-	return modifier;
+	// Lowest hit ratio of all states the source has
+	return GetStateSet().GetReduceHitRatio();
 }
 
 void Game_Battler::ShakeOnce(int strength, int speed, int frames) {
@@ -93,6 +93,14 @@ public:
 	 */
 	std::vector<int16_t> GetInflictedStates() const;
 
+	/**
+	 * Gets the summary of the inflicted states.
+	 * Rebuilt on demand after the states changed.
+	 *
+	 * @return state summary
+	 */
+	const StateSet& GetStateSet() const;
+
 	/** @return permenant states that cannot be removed */
 	virtual PermanentStates GetPermanentStates() const;
 
@@ -372,6 +380,14 @@ public:
 	 */
 	int GetAgi(Weapon weapon = Game_Battler::WeaponAll) const;
 
+	/**
+	 * Drops the cached results of GetAtk, GetDef, GetSpi, GetAgi and the
+	 * state summary.
+	 * Must be called whenever a value they depend on changes
+	 * (equipment, states, level, class, modifiers).
+	 */
+	void InvalidateStats() const;
+
 	/**
 	 * Gets the maximum HP for the current level.
 	 *
@@ -931,6 +947,31 @@ protected:
 		double current_level = 0.0;
 	};
 	FlashData flash;
+
+private:
+	enum CachedStat {
+		CachedStat_Atk,
+		CachedStat_Def,
+		CachedStat_Spi,
+		CachedStat_Agi,
+		CachedStat_Count
+	};
+	static constexpr int cached_weapon_count = WeaponSecondary - WeaponAll + 1;
+
+	/**
+	 * Returns the cached stat or calculates and caches it.
+	 * With EP_DEBUG_STAT_CACHE defined the cached value is compared against
+	 * a recalculation on every call.
+	 */
+	template <typename F>
+	int GetCachedStat(CachedStat stat, Weapon weapon, F&& calc) const;
+
+	mutable int stat_cache[CachedStat_Count][cached_weapon_count] = {};
+	/** One bit per entry of stat_cache */
+	mutable uint32_t stat_cache_valid = 0;
+
+	mutable StateSet state_set;
+	mutable bool state_set_valid = false;
 };
 
 inline Color Game_Battler::GetFlashColor() const {
@@ -950,20 +991,29 @@ inline bool Game_Battler::Exists() const {
 	return !IsHidden() && !IsDead() && IsInParty();
 }
 
+inline void Game_Battler::InvalidateStats() const {
+	stat_cache_valid = 0;
+	state_set_valid = false;
+}
+
 inline void Game_Battler::SetAtkModifier(int modifier) {
 	atk_modifier = modifier;
+	InvalidateStats();
 }
 
 inline void Game_Battler::SetDefModifier(int modifier) {
 	def_modifier = modifier;
+	InvalidateStats();
 }
 
 inline void Game_Battler::SetSpiModifier(int modifier) {
 	spi_modifier = modifier;
+	InvalidateStats();
 }
 
 inline void Game_Battler::SetAgiModifier(int modifier) {
 	agi_modifier = modifier;
+	InvalidateStats();
 }
 
 inline bool Game_Battler::IsCharged() const {
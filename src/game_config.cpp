@@ -102,6 +102,20 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			video.fps_render_window.Set(false);
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--turbo-fps")) {
+			if (arg.ParseValue(0, li_value)) {
+				video.turbo_fps.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--show-memory")) {
+			video.show_memory.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-show-memory")) {
+			video.show_memory.Set(false);
+			continue;
+		}
 		if (cp.ParseNext(arg, 0, "--window")) {
 			video.fullscreen.Set(false);
 			continue;
@@ -116,6 +130,40 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 0, "--pipelined-render")) {
+			video.pipelined_render.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-pipelined-render")) {
+			video.pipelined_render.Set(false);
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--render-threads")) {
+			if (arg.ParseValue(0, li_value)) {
+				video.render_threads.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--indexed-bitmaps")) {
+			video.indexed_bitmaps.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-indexed-bitmaps")) {
+			video.indexed_bitmaps.Set(false);
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--se-cache-size")) {
+			if (arg.ParseValue(0, li_value)) {
+				audio.se_cache_size.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--memory-log")) {
+			if (arg.ParseValue(0, li_value)) {
+				player.memory_log.Set(li_value);
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--autobattle-algo")) {
 			std::string svalue;
 			if (arg.ParseValue(0, svalue)) {
@@ -159,6 +207,9 @@ void Game_Config::LoadFromConfig(const std::string& path) {
 	if (ini.HasValue("player", "enemyai-algo")) {
 		player.enemyai_algo.Set(ini.GetString("player", "enemyai-algo", "RPG_RT"));
 	}
+	if (ini.HasValue("player", "memory-log")) {
+		player.memory_log.Set(ini.GetInteger("player", "memory-log", 0));
+	}
 
 	/** VIDEO SECTION */
 
@@ -174,15 +225,34 @@ void Game_Config::LoadFromConfig(const std::string& path) {
 	if (ini.HasValue("video", "fps-render-window")) {
 		video.fps_render_window.Set(ini.GetBoolean("video", "fps-render-window", false));
 	}
+	if (ini.HasValue("video", "turbo-fps")) {
+		video.turbo_fps.Set(ini.GetInteger("video", "turbo-fps", 0));
+	}
+	if (ini.HasValue("video", "show-memory")) {
+		video.show_memory.Set(ini.GetBoolean("video", "show-memory", false));
+	}
 	if (ini.HasValue("video", "fps-limit")) {
 		video.fps_limit.Set(ini.GetInteger("video", "fps-limit", 0));
 	}
 	if (ini.HasValue("video", "window-zoom")) {
 		video.window_zoom.Set(ini.GetInteger("video", "window-zoom", 0));
 	}
+	if (ini.HasValue("video", "pipelined-render")) {
+		video.pipelined_render.Set(ini.GetBoolean("video", "pipelined-render", false));
+	}
+	if (ini.HasValue("video", "render-threads")) {
+		video.render_threads.Set(ini.GetInteger("video", "render-threads", 1));
+	}
+	if (ini.HasValue("video", "indexed-bitmaps")) {
+		video.indexed_bitmaps.Set(ini.GetBoolean("video", "indexed-bitmaps", false));
+	}
 
 	/** AUDIO SECTION */
 
+	if (ini.HasValue("audio", "se-cache-size")) {
+		audio.se_cache_size.Set(ini.GetInteger("audio", "se-cache-size", 0));
+	}
+
 	/** INPUT SECTION */
 }
 
@@ -198,6 +268,9 @@ void Game_Config::WriteToConfig(const std::string& path) const {
 	of << "[player]\n";
 	of << "autobattle-algo=" << player.autobattle_algo.Get() << "\n";
 	of << "enemyai-algo=" << player.enemyai_algo.Get() << "\n";
+	if (player.memory_log.Enabled()) {
+		of << "memory-log=" << player.memory_log.Get() << "\n";
+	}
 	of << "\n";
 
 	/** VIDEO SECTION */
@@ -215,16 +288,38 @@ void Game_Config::WriteToConfig(const std::string& path) const {
 	if (video.fps_render_window.Enabled()) {
 		of << "fps-render-window=" << int(video.fps_render_window.Get()) << "\n";
 	}
+	if (video.turbo_fps.Enabled()) {
+		of << "turbo-fps=" << video.turbo_fps.Get() << "\n";
+	}
+	if (video.show_memory.Enabled()) {
+		of << "show-memory=" << int(video.show_memory.Get()) << "\n";
+	}
 	if (video.fps_limit.Enabled()) {
 		of << "fps-limit=" << video.fps_limit.Get() << "\n";
 	}
 	if (video.window_zoom.Enabled()) {
 		of << "window-zoom=" << video.window_zoom.Get() << "\n";
 	}
+	if (video.pipelined_render.Enabled()) {
+		of << "pipelined-render=" << int(video.pipelined_render.Get()) << "\n";
+	}
+	if (video.render_threads.Enabled()) {
+		of << "render-threads=" << video.render_threads.Get() << "\n";
+	}
+	if (video.indexed_bitmaps.Enabled()) {
+		of << "indexed-bitmaps=" << int(video.indexed_bitmaps.Get()) << "\n";
+	}
 	of << "\n";
 
 	/** AUDIO SECTION */
 
+	// 0 is the platform default and not written
+	if (audio.se_cache_size.Enabled() && audio.se_cache_size.Get() > 0) {
+		of << "[audio]\n";
+		of << "se-cache-size=" << audio.se_cache_size.Get() << "\n";
+		of << "\n";
+	}
+
 	/** INPUT SECTION */
 }
 
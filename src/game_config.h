@@ -26,6 +26,8 @@ class CmdlineParser;
 struct Game_ConfigPlayer {
 	StringConfigParam autobattle_algo{ "RPG_RT" };
 	StringConfigParam enemyai_algo{ "RPG_RT" };
+	/** Interval in seconds of the memory usage log line, 0 disables it */
+	RangeConfigParam<int> memory_log{ 0, 0, 3600 };
 };
 
 struct Game_ConfigVideo {
@@ -33,11 +35,20 @@ struct Game_ConfigVideo {
 	BoolConfigParam fullscreen{ true };
 	BoolConfigParam show_fps{ false };
 	BoolConfigParam fps_render_window{ false };
+	BoolConfigParam show_memory{ false };
+	/** Frames drawn per second in turbo fast forward, 0 disables turbo */
+	RangeConfigParam<int> turbo_fps{ 0, 0, std::numeric_limits<int>::max() };
 	RangeConfigParam<int> fps_limit{ DEFAULT_FPS, 0, std::numeric_limits<int>::max() };
 	RangeConfigParam<int> window_zoom{ 2, 1, std::numeric_limits<int>::max() };
+	BoolConfigParam pipelined_render{ false };
+	RangeConfigParam<int> render_threads{ 1, 1, 64 };
+	/** Keep large paletted images at one byte per pixel */
+	BoolConfigParam indexed_bitmaps{ false };
 };
 
 struct Game_ConfigAudio {
+	/** SE cache size in MB, 0 uses the platform default */
+	RangeConfigParam<int> se_cache_size{ 0, 0, 1024 };
 };
 
 struct Game_ConfigInput {
@@ -113,6 +113,8 @@ void Game_Enemy::Transform(int new_enemy_id) {
 		enemy = &dummy;
 	}
 
+	InvalidateStats();
+
 	auto* sprite = GetEnemyBattleSprite();
 	if (sprite) {
 		sprite->Refresh();
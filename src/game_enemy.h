@@ -318,6 +318,8 @@ inline const std::vector<int16_t>& Game_Enemy::GetStates() const {
 }
 
 inline std::vector<int16_t>& Game_Enemy::GetStates() {
+	// Caller can modify the states
+	InvalidateStats();
 	return states;
 }
 
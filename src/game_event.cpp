@@ -169,6 +169,7 @@ void Game_Event::RefreshPage() {
 	SetPaused(false);
 	const auto* old_page = page;
 	page = new_page;
+	Game_Map::TranslateEventPage(GetId(), page->ID);
 
 	SetSpriteGraphic(ToString(page->character_name), page->character_index);
 
@@ -630,6 +631,7 @@ const lcf::rpg::EventPage* Game_Event::GetPage(int page) const {
 	if (page <= 0 || page - 1 >= static_cast<int>(event->pages.size())) {
 		return nullptr;
 	}
+	Game_Map::TranslateEventPage(GetId(), page);
 	return &event->pages[page - 1];
 }
 
@@ -1912,16 +1912,21 @@ bool Game_Interpreter::CommandComment(const lcf::rpg::EventCommand &com) {
 		const auto& list = frame.commands;
 		auto& index = frame.current_command;
 
+		auto is_continuation = [&list](size_t i) {
+			const auto& cmd = list[i];
+			return cmd.code == static_cast<uint32_t>(Cmd::Comment_2) &&
+				!cmd.string.empty() && cmd.string[0] != '@';
+		};
+
+		if (index + 1 >= static_cast<int>(list.size()) || !is_continuation(index + 1)) {
+			// Single line, no need to build a new string
+			return DynRpg::Invoke(com.string);
+		}
+
 		std::string command = ToString(com.string);
 		// Concat everything that is not another command or a new comment block
-		for (size_t i = index + 1; i < list.size(); ++i) {
-			const auto& cmd = list[i];
-			if (cmd.code == static_cast<uint32_t>(Cmd::Comment_2) &&
-					!cmd.string.empty() && cmd.string[0] != '@') {
-				command += ToString(cmd.string);
-			} else {
-				break;
-			}
+		for (size_t i = index + 1; i < list.size() && is_continuation(i); ++i) {
+			command += ToString(list[i].string);
 		}
 
 		return DynRpg::Invoke(command);
@@ -21,6 +21,7 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <tuple>
 
 #include "async_handler.h"
 #include "system.h"
@@ -77,6 +78,7 @@ namespace {
 }
 
 namespace Game_Map {
+void PreloadSounds();
 void SetupCommon();
 }
 
@@ -313,8 +315,8 @@ void Game_Map::SetupCommon() {
 		std::stringstream ss;
 		ss << "map" << std::setfill('0') << std::setw(4) << GetMapId() << ".po";
 
-		// Translate all messages for this map
-		Player::translation.RewriteMapMessages(ss.str(), *map);
+		// Messages are translated when an event page is used
+		Player::translation.SelectMapMessages(ss.str());
 	}
 	SetNeedRefresh(true);
 
@@ -336,6 +338,41 @@ void Game_Map::SetupCommon() {
 	for (const auto& ev : map->events) {
 		events.emplace_back(GetMapId(), &ev);
 	}
+
+	PreloadSounds();
+}
+
+void Game_Map::PreloadSounds() {
+	using Cmd = lcf::rpg::EventCommand::Code;
+	using MoveCode = lcf::rpg::MoveCommand::Code;
+
+	std::vector<lcf::rpg::Sound> sounds;
+	for (const auto& ev : map->events) {
+		for (const auto& page : ev.pages) {
+			for (const auto& com : page.event_commands) {
+				if (static_cast<Cmd>(com.code) == Cmd::PlaySound && com.parameters.size() >= 2) {
+					lcf::rpg::Sound sound;
+					sound.name = ToString(com.string);
+					sound.tempo = com.parameters[1];
+					sounds.push_back(std::move(sound));
+				}
+			}
+			for (const auto& move_command : page.move_route.move_commands) {
+				if (static_cast<MoveCode>(move_command.command_id) == MoveCode::play_sound_effect) {
+					lcf::rpg::Sound sound;
+					sound.name = ToString(move_command.parameter_string);
+					sound.tempo = move_command.parameter_b;
+					sounds.push_back(std::move(sound));
+				}
+			}
+		}
+	}
+
+	auto key = [](const lcf::rpg::Sound& sound) { return std::tie(sound.name, sound.tempo); };
+	std::sort(sounds.begin(), sounds.end(), [&](const auto& l, const auto& r) { return key(l) < key(r); });
+	sounds.erase(std::unique(sounds.begin(), sounds.end(), [&](const auto& l, const auto& r) { return key(l) == key(r); }), sounds.end());
+
+	Main_Data::game_system->SePreload(std::move(sounds));
 }
 
 void Game_Map::PrepareSave(lcf::rpg::Save& save) {
@@ -922,6 +959,10 @@ int Game_Map::CheckEvent(int x, int y) {
 }
 
 void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
+	if (!actx.IsActive() && !is_preupdate) {
+		Main_Data::game_system->UpdateSePreload();
+	}
+
 	if (GetNeedRefresh()) {
 		Refresh();
 	}
@@ -1388,6 +1429,20 @@ int Game_Map::GetHighestEventId() {
 	return id;
 }
 
+void Game_Map::TranslateEventPage(int event_id, int page_id) {
+	if (!Player::translation.HasMapMessages()) {
+		return;
+	}
+
+	auto it = std::find_if(map->events.begin(), map->events.end(),
+			[&event_id](const lcf::rpg::Event& ev) {return ev.ID == event_id;});
+	if (it == map->events.end() || page_id <= 0 || page_id > static_cast<int>(it->pages.size())) {
+		return;
+	}
+
+	Player::translation.RewriteEventPageMessages(event_id, it->pages[page_id - 1]);
+}
+
 Game_Event* Game_Map::GetEvent(int event_id) {
 	auto it = std::find_if(events.begin(), events.end(),
 			[&event_id](Game_Event& ev) {return ev.GetId() == event_id;});
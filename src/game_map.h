@@ -486,6 +486,16 @@ namespace Game_Map {
 	 */
 	Game_Event* GetEvent(int event_id);
 
+	/**
+	 * Applies the translation of the current map to the Messages and Choices
+	 * of an event page. Pages are translated when they are used instead of
+	 * on map load.
+	 *
+	 * @param event_id event ID
+	 * @param page_id page ID (starting from 1)
+	 */
+	void TranslateEventPage(int event_id, int page_id);
+
 	/**
 	 * Gets common events list.
 	 *
@@ -16,6 +16,7 @@
  */
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include "bitmap.h"
 #include "options.h"
@@ -58,6 +59,18 @@ void SyncCurrentToFinish(lcf::rpg::SavePicture& data) {
 	}
 }
 
+static bool IsAtFinish(const lcf::rpg::SavePicture& data) {
+	return data.current_x == data.finish_x
+		&& data.current_y == data.finish_y
+		&& data.current_red == data.finish_red
+		&& data.current_green == data.finish_green
+		&& data.current_blue == data.finish_blue
+		&& data.current_sat == data.finish_sat
+		&& data.current_magnify == data.finish_magnify
+		&& data.current_top_trans == data.finish_top_trans
+		&& data.current_bot_trans == data.finish_bot_trans;
+}
+
 Game_Pictures::Picture::Picture(lcf::rpg::SavePicture save)
 	: data(std::move(save))
 {
@@ -76,6 +89,15 @@ void Game_Pictures::InitGraphics() {
 void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 {
 	pictures.clear();
+	active.clear();
+	motion.pictures.clear();
+	motion.time_left.clear();
+	for (auto& v: motion.current) {
+		v.clear();
+	}
+	for (auto& v: motion.finish) {
+		v.clear();
+	}
 
 	frame_counter = save.empty() ? 0 : save.back().frames;
 
@@ -91,6 +113,13 @@ void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 	pictures.reserve(num_pictures);
 	for (int i = 0; i < num_pictures; ++i) {
 		pictures.emplace_back(std::move(save[i]));
+		auto& pic = pictures.back();
+		if (pic.needs_update) {
+			active.push_back(i);
+		} else {
+			pic.idle_map_updates = map_updates;
+			pic.idle_battle_updates = battle_updates;
+		}
 	}
 }
 
@@ -102,6 +131,16 @@ std::vector<lcf::rpg::SavePicture> Game_Pictures::GetSaveData() const {
 
 	for (auto& pic: pictures) {
 		save.push_back(pic.data);
+		if (!pic.needs_update && Player::IsRPG2k3E()) {
+			// Frame counter of pictures which are not updated
+			auto& frames = save.back().frames;
+			if (pic.IsOnMap()) {
+				frames += map_updates - pic.idle_map_updates;
+			}
+			if (pic.IsOnBattle()) {
+				frames += battle_updates - pic.idle_battle_updates;
+			}
+		}
 	}
 
 	// RPG_RT Save game data always has a constant number of pictures
@@ -144,6 +183,8 @@ Game_Pictures::Picture& Game_Pictures::GetPicture(int id) {
 		pictures.reserve(id);
 		while (static_cast<int>(pictures.size()) < id) {
 			pictures.emplace_back(pictures.size() + 1);
+			pictures.back().idle_map_updates = map_updates;
+			pictures.back().idle_battle_updates = battle_updates;
 		}
 	}
 	return pictures[id - 1];
@@ -154,8 +195,22 @@ Game_Pictures::Picture* Game_Pictures::GetPicturePtr(int id) {
 		? &pictures[id - 1] : nullptr;
 }
 
+void Game_Pictures::Activate(Picture& pic) {
+	if (pic.needs_update) {
+		return;
+	}
+	pic.needs_update = true;
+
+	const int index = pic.data.ID - 1;
+	active.insert(std::lower_bound(active.begin(), active.end(), index), index);
+}
+
+// Pictures which do not need updates were never shown, the functions
+// iterating over the active pictures would not change them.
+
 void Game_Pictures::OnMapChange() {
-	for (auto& pic: pictures) {
+	for (int index: active) {
+		auto& pic = pictures[index];
 		if (pic.data.flags.erase_on_map_change) {
 			pic.Erase();
 		}
@@ -163,7 +218,8 @@ void Game_Pictures::OnMapChange() {
 }
 
 void Game_Pictures::OnBattleEnd() {
-	for (auto& pic: pictures) {
+	for (int index: active) {
+		auto& pic = pictures[index];
 		if (pic.data.flags.erase_on_battle_end) {
 			pic.Erase();
 		}
@@ -171,7 +227,7 @@ void Game_Pictures::OnBattleEnd() {
 }
 
 bool Game_Pictures::Picture::Show(const ShowParams& params) {
-	needs_update = true;
+	++revision;
 
 	data.name = params.name;
 	data.use_transparent_color = params.use_transparent_color;
@@ -230,6 +286,7 @@ bool Game_Pictures::Picture::Show(const ShowParams& params) {
 
 void Game_Pictures::Show(int id, const ShowParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	if (pic.Show(params)) {
 		RequestPictureSprite(pic);
 	}
@@ -238,6 +295,7 @@ void Game_Pictures::Show(int id, const ShowParams& params) {
 void Game_Pictures::Picture::Move(const MoveParams& params) {
 	const bool ignore_position = Player::IsLegacy() && data.fixed_to_map;
 
+	++revision;
 	SetNonEffectParams(params, !ignore_position);
 	data.time_left = params.duration * DEFAULT_FPS / 10;
 
@@ -284,6 +342,7 @@ void Game_Pictures::Move(int id, const MoveParams& params) {
 }
 
 void Game_Pictures::Picture::Erase() {
+	++revision;
 	request_id = {};
 	data.name.clear();
 	if (sprite) {
@@ -316,6 +375,7 @@ void Game_Pictures::RequestPictureSprite(Picture& pic) {
 
 void Game_Pictures::Picture::OnPictureSpriteReady() {
 	auto bitmap = Cache::Picture(data.name, data.use_transparent_color);
+	++revision;
 
 	sprite->SetBitmap(bitmap);
 	sprite->OnPictureShow();
@@ -349,18 +409,21 @@ void Game_Pictures::Picture::OnMapScrolled(int dx16, int dy16) {
 		data.finish_y = data.finish_y - dy;
 		data.current_y = data.current_y - dy;
 		data.start_y = data.start_y - dy;
+
+		motion_synced = false;
+		++revision;
 	}
 }
 
 void Game_Pictures::OnMapScrolled(int dx, int dy) {
-	for (auto& pic: pictures) {
-		pic.OnMapScrolled(dx, dy);
+	for (int index: active) {
+		pictures[index].OnMapScrolled(dx, dy);
 	}
 }
 
-void Game_Pictures::Picture::Update(bool is_battle) {
+bool Game_Pictures::Picture::Update(bool is_battle) {
 	if ((is_battle && !IsOnBattle()) || (!is_battle && !IsOnMap())) {
-		return;
+		return false;
 	}
 
 	if (Player::IsRPG2k3E()) {
@@ -368,7 +431,7 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 	}
 
 	if (!needs_update) {
-		return;
+		return false;
 	}
 
 	if (data.time_left > 0) {
@@ -379,18 +442,12 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 		return (finish - current) / dt + current;
 	};
 
-	if (data.time_left <= 0) {
+	const bool moving = data.time_left > 0;
+	bool changed = moving;
+
+	if (!moving && !IsAtFinish(data)) {
 		SyncCurrentToFinish<false>(data);
-	} else {
-		data.current_x = interpolate(data.current_x, data.finish_x);
-		data.current_y = interpolate(data.current_y, data.finish_y);
-		data.current_red = interpolate(data.current_red, data.finish_red);
-		data.current_green = interpolate(data.current_green, data.finish_green);
-		data.current_blue = interpolate(data.current_blue, data.finish_blue);
-		data.current_sat = interpolate(data.current_sat, data.finish_sat);
-		data.current_magnify = interpolate(data.current_magnify, data.finish_magnify);
-		data.current_top_trans = interpolate(data.current_top_trans, data.finish_top_trans);
-		data.current_bot_trans = interpolate(data.current_bot_trans, data.finish_bot_trans);
+		changed = true;
 	}
 
 	// When a move picture disables rotation effect, we continue rotating
@@ -406,11 +463,13 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 			if (et >= data.time_left && data.current_rotation >= 256.0) {
 				data.current_rotation = 0;
 			}
+			changed = true;
 		}
 	}
 
 	if (data.effect_mode != lcf::rpg::SavePicture::Effect_none) {
 		data.current_effect_power = interpolate(data.current_effect_power, data.finish_effect_power);
+		changed = true;
 	}
 
 	// Update rotation
@@ -437,17 +496,137 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 				Erase();
 			}
 		}
+		changed = true;
 	}
+
+	if (changed) {
+		++revision;
+	}
+
+	return moving;
 }
 
 void Game_Pictures::Update(bool is_battle) {
 	++frame_counter;
-	for (auto& pic: pictures) {
-		pic.Update(is_battle);
+	++(is_battle ? battle_updates : map_updates);
+
+	for (int index: active) {
+		auto& pic = pictures[index];
+		if (pic.Update(is_battle)) {
+			if (pic.motion_slot < 0 || !pic.motion_synced) {
+				LoadMotion(pic);
+			}
+			motion.time_left[pic.motion_slot] = static_cast<double>(pic.data.time_left + 1);
+		} else if (pic.motion_slot >= 0) {
+			RemoveMotion(pic);
+		}
+	}
+
+	UpdateMotion();
+}
+
+void Game_Pictures::LoadMotion(Picture& pic) {
+	if (pic.motion_slot < 0) {
+		pic.motion_slot = static_cast<int>(motion.pictures.size());
+		motion.pictures.push_back(pic.data.ID - 1);
+		motion.time_left.push_back(0.0);
+		for (auto& v: motion.current) {
+			v.push_back(0.0);
+		}
+		for (auto& v: motion.finish) {
+			v.push_back(0.0);
+		}
+	}
+
+	const int i = pic.motion_slot;
+	const auto& data = pic.data;
+	auto& cur = motion.current;
+	auto& fin = motion.finish;
+	cur[0][i] = data.current_x;
+	fin[0][i] = data.finish_x;
+	cur[1][i] = data.current_y;
+	fin[1][i] = data.finish_y;
+	cur[2][i] = data.current_red;
+	fin[2][i] = data.finish_red;
+	cur[3][i] = data.current_green;
+	fin[3][i] = data.finish_green;
+	cur[4][i] = data.current_blue;
+	fin[4][i] = data.finish_blue;
+	cur[5][i] = data.current_sat;
+	fin[5][i] = data.finish_sat;
+	cur[6][i] = data.current_magnify;
+	fin[6][i] = data.finish_magnify;
+	cur[7][i] = data.current_top_trans;
+	fin[7][i] = data.finish_top_trans;
+	cur[8][i] = data.current_bot_trans;
+	fin[8][i] = data.finish_bot_trans;
+	pic.motion_synced = true;
+}
+
+void Game_Pictures::RemoveMotion(Picture& pic) {
+	// The last slot takes the place of the removed one
+	const int i = pic.motion_slot;
+	const int last = static_cast<int>(motion.pictures.size()) - 1;
+	if (i != last) {
+		motion.pictures[i] = motion.pictures[last];
+		motion.time_left[i] = motion.time_left[last];
+		for (auto& v: motion.current) {
+			v[i] = v[last];
+		}
+		for (auto& v: motion.finish) {
+			v[i] = v[last];
+		}
+		pictures[motion.pictures[i]].motion_slot = i;
+	}
+
+	motion.pictures.pop_back();
+	motion.time_left.pop_back();
+	for (auto& v: motion.current) {
+		v.pop_back();
+	}
+	for (auto& v: motion.finish) {
+		v.pop_back();
+	}
+	pic.motion_slot = -1;
+}
+
+void Game_Pictures::UpdateMotion() {
+	const size_t n = motion.pictures.size();
+	if (n == 0) {
+		return;
+	}
+
+	auto& cur = motion.current;
+	auto& fin = motion.finish;
+
+	// Same operations as a per picture interpolation, the compiler can
+	// vectorize them because the fields are stored contiguously
+	const double* dt = motion.time_left.data();
+	for (int f = 0; f < num_motion_fields; ++f) {
+		double* c = cur[f].data();
+		const double* e = fin[f].data();
+		for (size_t i = 0; i < n; ++i) {
+			c[i] = (e[i] - c[i]) / dt[i] + c[i];
+		}
+	}
+
+	// Sprites and savegames read the picture data
+	for (size_t i = 0; i < n; ++i) {
+		auto& data = pictures[motion.pictures[i]].data;
+		data.current_x = cur[0][i];
+		data.current_y = cur[1][i];
+		data.current_red = cur[2][i];
+		data.current_green = cur[3][i];
+		data.current_blue = cur[4][i];
+		data.current_sat = cur[5][i];
+		data.current_magnify = cur[6][i];
+		data.current_top_trans = cur[7][i];
+		data.current_bot_trans = cur[8][i];
 	}
 }
 
 void Game_Pictures::Picture::SetNonEffectParams(const Params& params, bool set_positions) {
+	motion_synced = false;
 	if (set_positions) {
 		data.finish_x = params.position_x;
 		data.finish_y = params.position_y;
@@ -19,8 +19,10 @@
 #define EP_GAME_PICTURE_H
 
 // Headers
+#include <array>
 #include <string>
 #include <deque>
+#include <vector>
 #include "async_handler.h"
 #include <lcf/rpg/savepicture.h>
 #include "sprite_picture.h"
@@ -93,8 +95,25 @@ public:
 		lcf::rpg::SavePicture data;
 		FileRequestBinding request_id;
 		bool needs_update = false;
-
-		void Update(bool is_battle);
+		/** Incremented whenever data used for drawing changed */
+		int revision = 0;
+		/** Map and battle update count when the picture was created, used while it does not need updates */
+		int idle_map_updates = 0;
+		int idle_battle_updates = 0;
+		/** Slot in the motion arrays while moving, -1 otherwise */
+		int motion_slot = -1;
+		/** False when the position, zoom, transparency or tone was changed outside of the motion arrays */
+		bool motion_synced = false;
+
+		/**
+		 * Updates the picture except for the interpolation of the
+		 * position, zoom, transparency and tone, which Game_Pictures
+		 * does for all moving pictures at once.
+		 *
+		 * @param is_battle whether the battle pictures are updated
+		 * @return true when the picture is moving and must be interpolated
+		 */
+		bool Update(bool is_battle);
 
 		bool IsOnMap() const;
 		bool IsOnBattle() const;
@@ -116,10 +135,32 @@ public:
 private:
 	void RequestPictureSprite(Picture& pic);
 	void OnPictureSpriteReady(int id);
+	void Activate(Picture& pic);
+	void LoadMotion(Picture& pic);
+	void RemoveMotion(Picture& pic);
+	void UpdateMotion();
 
 	std::vector<Picture> pictures;
+	/** Indices of the pictures which need updates, ascending */
+	std::vector<int> active;
 	std::deque<Sprite_Picture> sprites;
 	int frame_counter = 0;
+	int map_updates = 0;
+	int battle_updates = 0;
+
+	static constexpr int num_motion_fields = 9;
+
+	/**
+	 * Structure of arrays of the moving pictures, interpolated in one pass.
+	 * A picture keeps its slot until it stops moving.
+	 */
+	struct Motion {
+		/** Index of the picture of each slot */
+		std::vector<int> pictures;
+		std::vector<double> time_left;
+		std::array<std::vector<double>, num_motion_fields> current;
+		std::array<std::vector<double>, num_motion_fields> finish;
+	} motion;
 };
 
 inline bool Game_Pictures::Picture::IsOnMap() const {
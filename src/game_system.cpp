@@ -16,10 +16,12 @@
  */
 
 // Headers
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include "game_system.h"
 #include "async_handler.h"
+#include "game_clock.h"
 #include "game_battle.h"
 #include "audio.h"
 #include "baseui.h"
@@ -187,6 +189,47 @@ void Game_System::SePlay(const lcf::rpg::Animation &animation) {
 	}
 }
 
+void Game_System::SePreload(std::vector<lcf::rpg::Sound> sounds) {
+	se_preload = std::move(sounds);
+	// Decoded from the back
+	std::reverse(se_preload.begin(), se_preload.end());
+}
+
+void Game_System::UpdateSePreload() {
+	// Spread decoding over several frames to not stall the map start
+	constexpr auto budget = std::chrono::milliseconds(2);
+
+	const auto start = Game_Clock::now();
+	auto it = se_preload.end();
+	while (it != se_preload.begin()) {
+		--it;
+		const auto& se = *it;
+
+		if (!se.name.empty() && se.name != "(OFF)" && !StringView(se.name).ends_with(".script")) {
+			FileRequestAsync* request = AsyncHandler::RequestFile("Sound", se.name);
+			request->Start();
+			if (!request->IsReady()) {
+				// Still downloading, try again next frame
+				continue;
+			}
+
+			Filesystem_Stream::InputStream stream;
+			if (!IsStopSoundFilename(se.name, stream) && stream) {
+				int tempo = Utils::Clamp<int32_t>(se.tempo, 50, 200);
+				if (!Audio().SE_Preload(std::move(stream), tempo)) {
+					se_preload.clear();
+					return;
+				}
+			}
+		}
+
+		it = se_preload.erase(it);
+		if (Game_Clock::now() - start >= budget) {
+			return;
+		}
+	}
+}
+
 StringView Game_System::GetSystemName() {
 	return !data.graphics_name.empty() ?
 		StringView(data.graphics_name) : StringView(lcf::Data::system.system_name);
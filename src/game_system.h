@@ -21,6 +21,7 @@
 // Headers
 #include <string>
 #include <map>
+#include <vector>
 #include <lcf/rpg/animation.h>
 #include <lcf/rpg/music.h>
 #include <lcf/rpg/sound.h>
@@ -145,6 +146,21 @@ public:
 	 */
 	void SePlay(const lcf::rpg::Animation& animation);
 
+	/**
+	 * Queues sounds for decoding into the SE cache so that playing them
+	 * has no delay. Replaces the sounds queued before.
+	 *
+	 * @param sounds sounds to preload, only name and tempo are used.
+	 */
+	void SePreload(std::vector<lcf::rpg::Sound> sounds);
+
+	/**
+	 * Decodes queued sounds until the time budget of the frame is spent.
+	 * Sounds that are still downloading stay queued. Preloading stops
+	 * when the cache is full.
+	 */
+	void UpdateSePreload();
+
 	/** @return system graphic filename.  */
 	StringView GetSystemName();
 
@@ -495,6 +511,7 @@ private:
 	FileRequestBinding music_request_id;
 	FileRequestBinding system_request_id;
 	std::map<std::string, FileRequestBinding> se_request_ids;
+	std::vector<lcf::rpg::Sound> se_preload;
 	Color bg_color = Color{ 0, 0, 0, 255 };
 	bool bgm_pending = false;
 };
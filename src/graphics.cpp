@@ -19,12 +19,17 @@
 #include <sstream>
 #include <chrono>
 #include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "graphics.h"
 #include "cache.h"
 #include "output.h"
 #include "player.h"
 #include "fps_overlay.h"
+#include "memory_overlay.h"
+#include "memory_stats.h"
 #include "message_overlay.h"
 #include "transition.h"
 #include "scene.h"
@@ -44,6 +49,19 @@ namespace Graphics {
 
 	std::unique_ptr<MessageOverlay> message_overlay;
 	std::unique_ptr<FpsOverlay> fps_overlay;
+	std::unique_ptr<MemoryOverlay> memory_overlay;
+
+	struct RenderThread {
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool requested = false;
+		bool quit = false;
+		BitmapRef back_surface;
+	};
+	std::unique_ptr<RenderThread> render_thread;
+
+	void RenderThreadMain(RenderThread& rt);
 }
 
 unsigned SecondToFrame(float const second) {
@@ -56,9 +74,13 @@ void Graphics::Init() {
 
 	message_overlay.reset(new MessageOverlay());
 	fps_overlay.reset(new FpsOverlay());
+	memory_overlay.reset(new MemoryOverlay());
 }
 
 void Graphics::Quit() {
+	SetPipelined(false);
+
+	memory_overlay.reset();
 	fps_overlay.reset();
 	message_overlay.reset();
 
@@ -73,7 +95,11 @@ void Graphics::Update() {
 	if (fps_overlay->Update()) {
 		UpdateTitle();
 	}
+	Output::WriteDeferred();
 	message_overlay->Update();
+	memory_overlay->Update();
+
+	MemoryStats::Update();
 }
 
 void Graphics::UpdateTitle() {
@@ -109,6 +135,82 @@ void Graphics::Draw(Bitmap& dst) {
 	LocalDraw(dst, min_z, max_z);
 }
 
+void Graphics::SetPipelined(bool enabled) {
+	if (enabled == IsPipelined()) {
+		return;
+	}
+
+	if (!enabled) {
+		{
+			std::lock_guard<std::mutex> lock(render_thread->mutex);
+			render_thread->quit = true;
+		}
+		render_thread->cv.notify_all();
+		render_thread->thread.join();
+		render_thread.reset();
+		return;
+	}
+
+	if (!DisplayUi->IsDisplaySurfaceSwappable()) {
+		Output::Debug("Pipelined rendering is not supported by this display");
+		return;
+	}
+
+	render_thread.reset(new RenderThread());
+	render_thread->thread = std::thread(RenderThreadMain, std::ref(*render_thread));
+	Output::Debug("Pipelined rendering enabled");
+}
+
+bool Graphics::IsPipelined() {
+	return render_thread != nullptr;
+}
+
+void Graphics::DrawPipelined() {
+	auto& rt = *render_thread;
+
+	// The UI recreates the display surface when the display mode changes,
+	// the back buffer must follow or the swap exchanges different sizes.
+	auto& disp = DisplayUi->GetDisplaySurface();
+	if (!rt.back_surface
+			|| rt.back_surface->width() != disp->width()
+			|| rt.back_surface->height() != disp->height()) {
+		rt.back_surface = Bitmap::Create(disp->width(), disp->height(), Color(0, 0, 0, 255));
+	}
+
+	// Composite the new frame into the back buffer ...
+	{
+		std::lock_guard<std::mutex> lock(rt.mutex);
+		rt.requested = true;
+	}
+	rt.cv.notify_all();
+
+	// ... while the previous frame is presented.
+	DisplayUi->UpdateDisplay();
+
+	std::unique_lock<std::mutex> lock(rt.mutex);
+	rt.cv.wait(lock, [&rt]() { return !rt.requested; });
+	DisplayUi->SwapDisplaySurface(rt.back_surface);
+}
+
+void Graphics::RenderThreadMain(RenderThread& rt) {
+	std::unique_lock<std::mutex> lock(rt.mutex);
+	while (true) {
+		rt.cv.wait(lock, [&rt]() { return rt.requested || rt.quit; });
+		if (rt.quit) {
+			return;
+		}
+
+		// The main thread only presents until the frame is done,
+		// so the drawables can be accessed without locking.
+		lock.unlock();
+		Draw(*rt.back_surface);
+		lock.lock();
+
+		rt.requested = false;
+		rt.cv.notify_all();
+	}
+}
+
 void Graphics::LocalDraw(Bitmap& dst, int min_z, int max_z) {
 	auto& drawable_list = DrawableMgr::GetLocalList();
 
@@ -135,6 +237,10 @@ std::shared_ptr<Scene> Graphics::UpdateSceneCallback() {
 	return prev_scene;
 }
 
+void Graphics::SetShowMemory(bool enabled) {
+	memory_overlay->SetDrawMemory(enabled);
+}
+
 MessageOverlay& Graphics::GetMessageOverlay() {
 	return *message_overlay;
 }
@@ -50,10 +50,36 @@ namespace Graphics {
 
 	void Draw(Bitmap& dst);
 
+	/**
+	 * Enables or disables pipelined rendering.
+	 * In pipelined mode the frame is composited on a render thread into
+	 * a back buffer while the previously composited frame is presented.
+	 * Only enabled when the UI supports swapping the display surface.
+	 *
+	 * @param enabled whether to enable pipelined rendering
+	 */
+	void SetPipelined(bool enabled);
+
+	/** @return whether pipelined rendering is active */
+	bool IsPipelined();
+
+	/**
+	 * Composites the current frame on the render thread and presents
+	 * the previous one. The presented frame is one frame behind.
+	 */
+	void DrawPipelined();
+
 	void LocalDraw(Bitmap& dst, int min_z, int max_z);
 
 	std::shared_ptr<Scene> UpdateSceneCallback();
 
+	/**
+	 * Enables or disables the overlay showing the memory held by the caches.
+	 *
+	 * @param enabled whether to show the memory overlay
+	 */
+	void SetShowMemory(bool enabled);
+
 	/**
 	 * Returns a handle to the message overlay.
 	 * Only used by Output to put messages.
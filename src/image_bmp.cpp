@@ -84,9 +84,8 @@ ImageBMP::BitmapHeader ImageBMP::ParseHeader(const uint8_t*& ptr, uint8_t const*
 	return hdr;
 }
 
-bool ImageBMP::ReadBMP(const uint8_t* data, unsigned len, bool transparent,
-					   int& width, int& height, void*& pixels) {
-	pixels = nullptr;
+bool ImageBMP::ReadBMP(const uint8_t* data, unsigned len, bool transparent, ImageOut& output) {
+	output.pixels = nullptr;
 
 	if (len < 64) {
 		Output::Warning("Not a valid BMP file.");
@@ -121,74 +120,80 @@ bool ImageBMP::ReadBMP(const uint8_t* data, unsigned len, bool transparent,
 		return false;
 	}
 
-	auto* palette = ptr;
+	// bitmap scan lines need to be aligned to 32 bit boundaries, add padding if needed
+	int line_width = (hdr.depth == 4) ? (hdr.w + 1) >> 1 : hdr.w;
+	int padding = (-line_width)&3;
 
-	auto get_palette = [&](int idx) {
-		return palette + idx * hdr.palette_size;
-	};
+	if (hdr.w <= 0 || bits_offset > len || (len - bits_offset) / (line_width + padding) < (unsigned)hdr.h) {
+		Output::Warning("BMP image data is truncated.");
+		return false;
+	}
+
+	// The palette is stored as BGR(X)
+	output.ClearPalette();
+	int num_colors = std::min<int>(hdr.num_colors, (e - ptr) / hdr.palette_size);
+	for (int i = 0; i < num_colors; i++) {
+		const uint8_t* color = ptr + i * hdr.palette_size;
+		output.palette[i][0] = color[2];
+		output.palette[i][1] = color[1];
+		output.palette[i][2] = color[0];
+	}
+	output.indexed = true;
 
 	// Ensure no palette entry is an exact duplicate of the transparent color at #0
-	for (int i = 1; i < hdr.num_colors; i++) {
-		auto* p = get_palette(i);
-		if (p[0] == palette[0] && p[1] == palette[1] && p[2] == palette[2]) {
-			// FIXME: Remove the need for this const_cast
-			const_cast<uint8_t*>(p)[0] ^= 1;
+	auto* key = output.palette[0];
+	for (int i = 1; i < num_colors; i++) {
+		auto* p = output.palette[i];
+		if (p[0] == key[0] && p[1] == key[1] && p[2] == key[2]) {
+			p[2] ^= 1;
 		}
 	}
+	if (transparent) {
+		key[3] = 0;
+	}
 
 	const uint8_t* src_pixels = &data[bits_offset];
 
-	// bitmap scan lines need to be aligned to 32 bit boundaries, add padding if needed
-	int line_width = (hdr.depth == 4) ? (hdr.w + 1) >> 1 : hdr.w;
-	int padding = (-line_width)&3;
-
-	pixels = malloc(hdr.w * hdr.h * 4);
-	if (!pixels) {
+	// The indices are expanded by the Bitmap directly into its pixel format
+	output.pixels = malloc(hdr.w * hdr.h);
+	if (!output.pixels) {
 		Output::Warning("Error allocating BMP pixel buffer.");
 		return false;
 	}
 
-	uint8_t* dst = (uint8_t*) pixels;
+	uint8_t* dst = (uint8_t*) output.pixels;
 	for (int y = 0; y < hdr.h; y++) {
 		const uint8_t* src = src_pixels + (vflip ? hdr.h - 1 - y : y) * (line_width + padding);
+		if (hdr.depth == 8) {
+			memcpy(dst, src, hdr.w);
+			dst += hdr.w;
+			continue;
+		}
+
+		// split up packed pixels
 		for (int x = 0; x < hdr.w; x += 2) {
 			uint8_t pix = *src++;
-			uint8_t pix2 = 0;
-			const uint8_t* color;
-
-			// split up packed pixel
-			if (hdr.depth == 4) {
-				pix2 = pix & 15;
-				pix >>= 4;
-			}
-
-			color = get_palette(pix);
-			*dst++ = color[2];
-			*dst++ = color[1];
-			*dst++ = color[0];
-			*dst++ = (transparent && pix == 0) ? 0 : 255;
+			*dst++ = pix >> 4;
 
 			// end of line
 			if (x + 1 == hdr.w)
 				break;
 
-			pix = (hdr.depth == 8) ? *src++ : pix2;
-
-			color = get_palette(pix);
-			*dst++ = color[2];
-			*dst++ = color[1];
-			*dst++ = color[0];
-			*dst++ = (transparent && pix == 0) ? 0 : 255;
+			*dst++ = pix & 15;
 		}
 	}
 
-	width = hdr.w;
-	height = hdr.h;
+	output.width = hdr.w;
+	output.height = hdr.h;
 	return true;
 }
 
-bool ImageBMP::ReadBMP(Filesystem_Stream::InputStream& stream, bool transparent,
-					int& width, int& height, void*& pixels) {
+bool ImageBMP::ReadBMP(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output) {
+	auto memory = stream.GetUnreadMemory();
+	if (!memory.empty()) {
+		return ReadBMP(memory.data(), (unsigned) memory.size(), transparent, output);
+	}
+
 	std::vector<uint8_t> buffer = Utils::ReadStream(stream);
-	return ReadBMP(&buffer.front(), (unsigned) buffer.size(), transparent, width, height, pixels);
+	return ReadBMP(&buffer.front(), (unsigned) buffer.size(), transparent, output);
 }
@@ -19,6 +19,7 @@
 #define EP_IMAGE_BMP_H
 
 #include "filesystem_stream.h"
+#include "image_out.h"
 
 namespace ImageBMP {
 	struct BitmapHeader {
@@ -32,8 +33,8 @@ namespace ImageBMP {
 		int palette_size = 0;
 	};
 
-	bool ReadBMP(const uint8_t* data, unsigned len, bool transparent, int& width, int& height, void*& pixels);
-	bool ReadBMP(Filesystem_Stream::InputStream& stream, bool transparent, int& width, int& height, void*& pixels);
+	bool ReadBMP(const uint8_t* data, unsigned len, bool transparent, ImageOut& output);
+	bool ReadBMP(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output);
 
 	BitmapHeader ParseHeader(const uint8_t*& ptr, uint8_t const* e);
 }
@@ -0,0 +1,52 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_IMAGE_OUT_H
+#define EP_IMAGE_OUT_H
+
+#include <cstdint>
+
+/**
+ * Result of an image decoder.
+ *
+ * Paletted images are not expanded by the decoders: pixels then contains
+ * one palette index per pixel and the Bitmap expands them directly into
+ * its own pixel format.
+ */
+struct ImageOut {
+	int width = 0;
+	int height = 0;
+	/** Pixel data allocated with malloc: RGBA8 or palette indices */
+	void* pixels = nullptr;
+	/** Whether pixels contains palette indices instead of RGBA8 */
+	bool indexed = false;
+	/**
+	 * RGBA8 palette of indexed images. When the image is transparent
+	 * entry 0 already has an alpha of 0.
+	 */
+	uint8_t palette[256][4] = {};
+
+	/** Fills the palette with opaque black */
+	void ClearPalette() {
+		for (auto& color : palette) {
+			color[0] = color[1] = color[2] = 0;
+			color[3] = 255;
+		}
+	}
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <csetjmp>
+#include <algorithm>
 #include <vector>
 
 #include "output.h"
@@ -38,6 +39,22 @@ static void read_data_istream(png_structp png_ptr, png_bytep data, png_size_t le
 	}
 }
 
+namespace {
+	struct MemoryReader {
+		const uint8_t* pos;
+		const uint8_t* end;
+	};
+}
+
+static void read_data_memory(png_structp png_ptr, png_bytep data, png_size_t length) {
+	auto* reader = reinterpret_cast<MemoryReader*>(png_get_io_ptr(png_ptr));
+	if (static_cast<png_size_t>(reader->end - reader->pos) < length) {
+		png_error(png_ptr, "Unexpected end of file");
+	}
+	memcpy(data, reader->pos, length);
+	reader->pos += length;
+}
+
 static void on_png_warning(png_structp, png_const_charp warn_msg) {
 	Output::Debug("libpng: {}", warn_msg);
 }
@@ -46,26 +63,30 @@ static void on_png_error(png_structp, png_const_charp error_msg) {
 	Output::Warning("libpng: {}", error_msg);
 }
 
-static bool ReadPNGWithReadFunction(png_voidp,png_rw_ptr, bool, int&, int&, void*&);
-static void ReadPalettedData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint32_t*);
+static bool ReadPNGWithReadFunction(png_voidp,png_rw_ptr, bool, ImageOut&);
+static bool ReadPalettedData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, ImageOut&);
 static void ReadGrayData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint32_t*);
 static void ReadGrayAlphaData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
 static void ReadRGBData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
 static void ReadRGBAData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
 
-bool ImagePNG::ReadPNG(const void* buffer, bool transparent,
-	int& width, int& height, void*& pixels) {
-	return ReadPNGWithReadFunction((png_voidp)&buffer, read_data, transparent, width, height, pixels);
+bool ImagePNG::ReadPNG(const void* buffer, bool transparent, ImageOut& output) {
+	return ReadPNGWithReadFunction((png_voidp)&buffer, read_data, transparent, output);
 }
 
-bool ImagePNG::ReadPNG(Filesystem_Stream::InputStream& stream, bool transparent,
-	int& width, int& height, void*& pixels) {
-	return ReadPNGWithReadFunction(&stream, read_data_istream, transparent, width, height, pixels);
+bool ImagePNG::ReadPNG(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output) {
+	auto memory = stream.GetUnreadMemory();
+	if (!memory.empty()) {
+		// Read directly from the mapped file instead of going through the stream
+		MemoryReader reader = { memory.data(), memory.data() + memory.size() };
+		return ReadPNGWithReadFunction(&reader, read_data_memory, transparent, output);
+	}
+
+	return ReadPNGWithReadFunction(&stream, read_data_istream, transparent, output);
 }
 
-static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool transparent,
-					   int& width, int& height, void*& pixels) {
-	pixels = nullptr;
+static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool transparent, ImageOut& output) {
+	output.pixels = nullptr;
 
 	png_struct *png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, on_png_error, on_png_warning);
 	if (png_ptr == NULL) {
@@ -93,80 +114,81 @@ static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool tra
 	png_get_IHDR(png_ptr, info_ptr, &w, &h,
 				 &bit_depth, &color_type, NULL, NULL, NULL);
 
-	pixels = malloc(w * h * 4);
-	if (!pixels) {
+	// Paletted images are expanded by the Bitmap directly into its pixel format
+	const int bpp = (color_type == PNG_COLOR_TYPE_PALETTE) ? 1 : 4;
+	output.pixels = malloc(w * h * bpp);
+	if (!output.pixels) {
 		Output::Warning("Error allocating PNG pixel buffer.");
 		return false;
 	}
 
 	switch (color_type) {
 		case PNG_COLOR_TYPE_PALETTE:
-			ReadPalettedData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)pixels);
+			if (!ReadPalettedData(png_ptr, info_ptr, w, h, transparent, output)) {
+				png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+				return false;
+			}
 			break;
 		case PNG_COLOR_TYPE_GRAY:
-			ReadGrayData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)pixels);
+			ReadGrayData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)output.pixels);
 			break;
 		case PNG_COLOR_TYPE_GRAY_ALPHA:
-			ReadGrayAlphaData(png_ptr, info_ptr, w, h, (uint32_t*)pixels);
+			ReadGrayAlphaData(png_ptr, info_ptr, w, h, (uint32_t*)output.pixels);
 			break;
 		case PNG_COLOR_TYPE_RGB:
-			ReadRGBData(png_ptr, info_ptr, w, h, (uint32_t*)pixels);
+			ReadRGBData(png_ptr, info_ptr, w, h, (uint32_t*)output.pixels);
 			break;
 		case PNG_COLOR_TYPE_RGB_ALPHA:
-			ReadRGBAData(png_ptr, info_ptr, w, h, (uint32_t*)pixels);
+			ReadRGBAData(png_ptr, info_ptr, w, h, (uint32_t*)output.pixels);
 			break;
 	}
 
 	png_read_end(png_ptr, NULL);
 	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 
-	width = w;
-	height = h;
+	output.width = w;
+	output.height = h;
 	return true;
 }
 
-static void ReadPalettedData(
+static bool ReadPalettedData(
 	png_struct* png_ptr, png_info* info_ptr,
 	png_uint_32 w, png_uint_32 h,
 	bool transparent,
-	uint32_t* pixels
+	ImageOut& output
 ) {
 	// For transparent images, all the colors are opaque, except the
-	// color with index 0. So we'll need to do index->RGB conversion
-	// on our own.
+	// color with index 0. The indices are kept as they are and the
+	// Bitmap applies the palette.
 	png_set_packing(png_ptr);
 	png_read_update_info(png_ptr, info_ptr);
 
+	output.ClearPalette();
+	output.indexed = true;
+
 	if (!png_get_valid(png_ptr, info_ptr, PNG_INFO_PLTE)) {
 		Output::Warning("Palette PNG without PLTE block");
-		return;
+		return false;
 	}
 
 	png_colorp palette;
 	int num_palette;
 	png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
 
+	for (int i = 0; i < std::min(num_palette, 256); i++) {
+		output.palette[i][0] = palette[i].red;
+		output.palette[i][1] = palette[i].green;
+		output.palette[i][2] = palette[i].blue;
+	}
+	if (transparent) {
+		output.palette[0][3] = 0;
+	}
+
 	for (png_uint_32 y = 0; y < h; y++) {
-		// We read the indices (w bytes) into the end of the pixel
-		// data for this row (4w bytes), then scan over them
-		// converting them into RGBA values. Putting them at the end
-		// gives us enough room that we don't overwrite an index
-		// we'll need later with an RGBA value.
-
-		uint32_t* beginning_of_row = pixels + y * w;
-
-		uint8_t* indices = (uint8_t*)beginning_of_row + w * 3;
-		png_read_row(png_ptr, (png_bytep)indices, NULL);
-
-		uint32_t* dst = beginning_of_row;
-		for (png_uint_32 x = 0; x < w; x++, dst++) {
-			uint8_t idx = indices[x];
-			png_color& color = palette[idx];
-			uint8_t alpha = (idx == 0 && transparent) ? 0 : 255;
-			uint8_t rgba[4] = { color.red, color.green, color.blue, alpha };
-			*dst = *(uint32_t*)rgba;
-		}
+		png_read_row(png_ptr, (png_bytep)output.pixels + y * w, NULL);
 	}
+
+	return true;
 }
 
 static void ReadGrayData(
@@ -19,10 +19,11 @@
 #define EP_IMAGE_PNG_H
 
 #include "filesystem_stream.h"
+#include "image_out.h"
 
 namespace ImagePNG {
-	bool ReadPNG(const void* buffer, bool transparent, int& width, int& height, void*& pixels);
-	bool ReadPNG(Filesystem_Stream::InputStream& is, bool transparent, int& width, int& height, void*& pixels);
+	bool ReadPNG(const void* buffer, bool transparent, ImageOut& output);
+	bool ReadPNG(Filesystem_Stream::InputStream& is, bool transparent, ImageOut& output);
 	bool WritePNG(Filesystem_Stream::OutputStream& os, uint32_t width, uint32_t height, uint32_t* data);
 }
 
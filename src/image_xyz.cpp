@@ -24,9 +24,8 @@
 #include "output.h"
 #include "image_xyz.h"
 
-bool ImageXYZ::ReadXYZ(const uint8_t* data, unsigned len, bool transparent,
-					   int& width, int& height, void*& pixels) {
-	pixels = nullptr;
+bool ImageXYZ::ReadXYZ(const uint8_t* data, unsigned len, bool transparent, ImageOut& output) {
+	output.pixels = nullptr;
 
 	if (len < 8) {
 		Output::Warning("Not a valid XYZ file.");
@@ -47,32 +46,36 @@ bool ImageXYZ::ReadXYZ(const uint8_t* data, unsigned len, bool transparent,
 	}
 	const uint8_t (*palette)[3] = (const uint8_t(*)[3]) &dst_buffer.front();
 
-	pixels = malloc(w * h * 4);
-	if (!pixels) {
+	// The indices are expanded by the Bitmap directly into its pixel format
+	output.pixels = malloc(w * h);
+	if (!output.pixels) {
 		Output::Warning("Error allocating XYZ pixel buffer.");
 		return false;
 	}
+	memcpy(output.pixels, &dst_buffer[768], w * h);
 
-	uint8_t* dst = (uint8_t*) pixels;
-	const uint8_t* src = (const uint8_t*) &dst_buffer[768];
-	for (int y = 0; y < h; y++) {
-		for (int x = 0; x < w; x++) {
-			uint8_t pix = *src++;
-			const uint8_t* color = palette[pix];
-			*dst++ = color[0];
-			*dst++ = color[1];
-			*dst++ = color[2];
-			*dst++ = (transparent && pix == 0) ? 0 : 255;
-		}
+	for (int i = 0; i < 256; i++) {
+		output.palette[i][0] = palette[i][0];
+		output.palette[i][1] = palette[i][1];
+		output.palette[i][2] = palette[i][2];
+		output.palette[i][3] = 255;
 	}
+	if (transparent) {
+		output.palette[0][3] = 0;
+	}
+	output.indexed = true;
 
-	width = w;
-	height = h;
+	output.width = w;
+	output.height = h;
 	return true;
 }
 
-bool ImageXYZ::ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent,
-					   int& width, int& height, void*& pixels) {
+bool ImageXYZ::ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output) {
+	auto memory = stream.GetUnreadMemory();
+	if (!memory.empty()) {
+		return ReadXYZ(memory.data(), (unsigned) memory.size(), transparent, output);
+	}
+
 	std::vector<uint8_t> buffer = Utils::ReadStream(stream);
-	return ReadXYZ(&buffer.front(), (unsigned) buffer.size(), transparent, width, height, pixels);
+	return ReadXYZ(&buffer.front(), (unsigned) buffer.size(), transparent, output);
 }
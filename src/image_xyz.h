@@ -20,10 +20,11 @@
 
 #include <cstdio>
 #include "filesystem_stream.h"
+#include "image_out.h"
 
 namespace ImageXYZ {
-	bool ReadXYZ(const uint8_t* data, unsigned len, bool transparent, int& width, int& height, void*& pixels);
-	bool ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent, int& width, int& height, void*& pixels);
+	bool ReadXYZ(const uint8_t* data, unsigned len, bool transparent, ImageOut& output);
+	bool ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output);
 }
 
 #endif
@@ -341,6 +341,16 @@ bool Input::IsRecording() {
 	return source->IsRecording();
 }
 
+void Input::RecordKeyframe() {
+	assert(source);
+	source->RecordKeyframe();
+}
+
+std::string Input::SeekReplay(int frame) {
+	assert(source);
+	return source->Seek(frame);
+}
+
 Input::KeyStatus Input::GetMask() {
 	assert(source);
 	return source->GetMask();
@@ -280,6 +280,21 @@ namespace Input {
 	/** @return If the input is recorded */
 	bool IsRecording();
 
+	/**
+	 * Called after each logical frame to write periodic
+	 * state keyframes to binary input recordings.
+	 */
+	void RecordKeyframe();
+
+	/**
+	 * Restores a binary input replay to the last state
+	 * keyframe at or before the given frame.
+	 *
+	 * @param frame frame to seek to
+	 * @return LSD data of the keyframe or empty when seeking failed
+	 */
+	std::string SeekReplay(int frame);
+
 	/** Buttons press time (in frames). */
 	extern std::array<int, BUTTON_COUNT> press_time;
 
@@ -19,6 +19,7 @@
 #include <cstring>
 #include <cerrno>
 #include <ctime>
+#include <sstream>
 
 #include "baseui.h"
 #include "input_source.h"
@@ -26,8 +27,107 @@
 #include "output.h"
 #include "game_system.h"
 #include "main_data.h"
+#include "rand.h"
+#include "scene.h"
+#include "scene_save.h"
+#include "transition.h"
 #include "version.h"
 
+namespace {
+	/*
+	 * Binary input log format:
+	 *
+	 * Header: magic, format version, button name table
+	 * Records: a tag byte followed by the payload
+	 *  'B': zigzag frame delta, number of toggled buttons, toggled button indices
+	 *  'K': frame, pressed buttons, RNG state, LSD savegame data
+	 *  'R': frame, the frame counter went backwards (savegame loaded, new game)
+	 *  RecordingData tags: length prefixed string
+	 * All integers are stored as unsigned LEB128 varints.
+	 */
+	constexpr char binary_magic[4] = { 'E', 'P', 'R', 'B' };
+	constexpr int binary_version = 1;
+	constexpr char binary_extension[] = ".eprb";
+	constexpr char record_buttons = 'B';
+	constexpr char record_keyframe = 'K';
+	constexpr char record_rewind = 'R';
+
+	void WriteVarint(std::ostream& os, uint32_t value) {
+		while (value >= 0x80) {
+			os.put(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		os.put(static_cast<char>(value));
+	}
+
+	bool ReadVarint(std::istream& is, uint32_t& value) {
+		value = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			int c = is.get();
+			if (c == EOF) {
+				return false;
+			}
+			value |= static_cast<uint32_t>(c & 0x7F) << shift;
+			if ((c & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void WriteString(std::ostream& os, StringView str) {
+		WriteVarint(os, str.size());
+		os.write(str.data(), str.size());
+	}
+
+	bool ReadString(std::istream& is, std::string& str) {
+		uint32_t len;
+		if (!ReadVarint(is, len)) {
+			return false;
+		}
+		str.resize(len);
+		return bool(is.read(&str[0], len));
+	}
+
+	bool SkipString(std::istream& is) {
+		uint32_t len;
+		return ReadVarint(is, len) && is.ignore(len);
+	}
+
+	void WriteButtons(std::ostream& os, const std::bitset<Input::BUTTON_COUNT>& buttons) {
+		WriteVarint(os, buttons.count());
+		for (size_t i = 0; i < buttons.size(); ++i) {
+			if (buttons[i]) {
+				WriteVarint(os, i);
+			}
+		}
+	}
+
+	bool ReadButtons(std::istream& is, std::vector<int>& buttons) {
+		uint32_t count;
+		if (!ReadVarint(is, count)) {
+			return false;
+		}
+		buttons.resize(count);
+		for (auto& b: buttons) {
+			uint32_t idx;
+			if (!ReadVarint(is, idx)) {
+				return false;
+			}
+			b = static_cast<int>(idx);
+		}
+		return true;
+	}
+
+	uint32_t ZigZag(int32_t value) {
+		return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+	}
+
+	int32_t UnZigZag(uint32_t value) {
+		return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+	}
+}
+
 std::unique_ptr<Input::Source> Input::Source::Create(
 		Input::ButtonMappingArray buttons,
 		Input::DirectionMappingArray directions,
@@ -36,15 +136,28 @@ std::unique_ptr<Input::Source> Input::Source::Create(
 	if (!replay_from_path.empty()) {
 		auto path = replay_from_path.c_str();
 
-		auto log_src = std::make_unique<Input::LogSource>(path, std::move(buttons), std::move(directions));
+		auto bin_file = FileFinder::Root().OpenInputStream(path, std::ios::in | std::ios::binary);
+		if (bin_file && BinaryLogSource::IsBinaryLog(bin_file)) {
+			auto bin_src = std::make_unique<Input::BinaryLogSource>(std::move(bin_file), std::move(buttons), std::move(directions));
 
-		if (*log_src) {
-			return log_src;
-		}
-		Output::Warning("Failed to open file for input replaying: {}", path);
+			if (*bin_src) {
+				return bin_src;
+			}
+			Output::Warning("Failed to open file for input replaying: {}", path);
 
-		buttons = std::move(log_src->GetButtonMappings());
-		directions = std::move(log_src->GetDirectionMappings());
+			buttons = std::move(bin_src->GetButtonMappings());
+			directions = std::move(bin_src->GetDirectionMappings());
+		} else {
+			auto log_src = std::make_unique<Input::LogSource>(path, std::move(buttons), std::move(directions));
+
+			if (*log_src) {
+				return log_src;
+			}
+			Output::Warning("Failed to open file for input replaying: {}", path);
+
+			buttons = std::move(log_src->GetButtonMappings());
+			directions = std::move(log_src->GetDirectionMappings());
+		}
 	}
 
 	return std::make_unique<Input::UiSource>(std::move(buttons), std::move(directions));
@@ -147,13 +260,29 @@ bool Input::Source::InitRecording(const std::string& record_to_path) {
 	if (!record_to_path.empty()) {
 		auto path = record_to_path.c_str();
 
-		record_log = std::make_unique<Filesystem_Stream::OutputStream>(FileFinder::Root().OpenOutputStream(path, std::ios::out | std::ios::trunc));
+		record_binary = StringView(record_to_path).ends_with(binary_extension);
+
+		auto mode = std::ios::out | std::ios::trunc;
+		if (record_binary) {
+			mode |= std::ios::binary;
+		}
+		record_log = std::make_unique<Filesystem_Stream::OutputStream>(FileFinder::Root().OpenOutputStream(path, mode));
 
 		if (!record_log) {
 			Output::Error("Failed to open file {} for input recording : {}", path, strerror(errno));
 			return false;
 		}
 
+		if (record_binary) {
+			record_log->write(binary_magic, sizeof(binary_magic));
+			WriteVarint(*record_log, binary_version);
+			WriteVarint(*record_log, BUTTON_COUNT);
+			for (const auto& name: Input::kButtonNames) {
+				WriteString(*record_log, name);
+			}
+			return true;
+		}
+
 		*record_log << "H EasyRPG Player Recording\n";
 		*record_log << "V 2 " PLAYER_VERSION "\n";
 
@@ -171,6 +300,11 @@ bool Input::Source::InitRecording(const std::string& record_to_path) {
 }
 
 void Input::Source::Record() {
+	if (record_binary) {
+		RecordBinary();
+		return;
+	}
+
 	if (record_log) {
 		const auto& buttons = GetPressedNonSystemButtons();
 		if (buttons.any()) {
@@ -198,12 +332,301 @@ void Input::Source::Record() {
 	}
 }
 
+void Input::Source::RecordBinary() {
+	if (!record_log || !Main_Data::game_system) {
+		return;
+	}
+
+	// Only the first update of a logical frame contains the game buttons
+	int cur_frame = Main_Data::game_system->GetFrameCounter();
+	if (cur_frame == last_written_frame) {
+		return;
+	}
+
+	if (cur_frame < last_written_frame) {
+		// The replay counts these to order the records of the same frame
+		// number before and after the rewind
+		record_log->put(record_rewind);
+		WriteVarint(*record_log, cur_frame);
+		recorded_frame = cur_frame;
+		// Start the new timeline with a keyframe
+		last_keyframe = -1;
+	}
+	last_written_frame = cur_frame;
+
+	const auto buttons = GetPressedNonSystemButtons();
+	const auto changed = buttons ^ recorded_buttons;
+	if (changed.none()) {
+		return;
+	}
+
+	record_log->put(record_buttons);
+	WriteVarint(*record_log, ZigZag(cur_frame - recorded_frame));
+	WriteButtons(*record_log, changed);
+
+	recorded_buttons = buttons;
+	recorded_frame = cur_frame;
+}
+
+void Input::Source::RecordKeyframe() {
+	if (!record_binary || !record_log || !Main_Data::game_system) {
+		return;
+	}
+
+	int cur_frame = Main_Data::game_system->GetFrameCounter();
+	if (last_keyframe >= 0 && cur_frame - last_keyframe < keyframe_interval) {
+		return;
+	}
+
+	// Savegames can only restore the map scene
+	if (!Scene::instance || Scene::instance->type != Scene::Map
+			|| Scene::IsAsyncPending() || Transition::instance().IsActive()) {
+		return;
+	}
+
+	std::stringstream save_data;
+	Scene_Save::WriteSaveData(save_data, false);
+
+	std::stringstream rng_state;
+	rng_state << Rand::GetRNG();
+
+	record_log->put(record_keyframe);
+	WriteVarint(*record_log, cur_frame);
+	WriteButtons(*record_log, recorded_buttons);
+	WriteString(*record_log, rng_state.str());
+	WriteString(*record_log, save_data.str());
+
+	// Button deltas after a keyframe are relative to it
+	recorded_frame = cur_frame;
+	last_keyframe = cur_frame;
+}
+
+std::string Input::Source::Seek(int) {
+	Output::Warning("Seeking is only supported by binary input logs");
+	return {};
+}
+
 void Input::Source::AddRecordingData(Input::RecordingData type, StringView data) {
-	if (record_log) {
-		*record_log << static_cast<char>(type) << " " << data << "\n";
+	if (!record_log) {
+		return;
+	}
+
+	if (record_binary) {
+		record_log->put(static_cast<char>(type));
+		WriteString(*record_log, data);
+		return;
 	}
+
+	*record_log << static_cast<char>(type) << " " << data << "\n";
 }
 
 void Input::LogSource::UpdateSystem() {
 	// input log does not record actions outside of logical frames.
 }
+
+Input::BinaryLogSource::BinaryLogSource(Filesystem_Stream::InputStream log_file, ButtonMappingArray buttons, DirectionMappingArray directions)
+	: Source(std::move(buttons), std::move(directions)),
+	log_file(std::move(log_file))
+{
+	auto& is = this->log_file;
+
+	is.ignore(sizeof(binary_magic));
+
+	uint32_t ver, button_count;
+	if (!ReadVarint(is, ver) || ver != binary_version) {
+		Output::Warning("Unsupported binary input log version {}", ver);
+		return;
+	}
+
+	if (!ReadVarint(is, button_count)) {
+		return;
+	}
+
+	button_map.resize(button_count, -1);
+	for (auto& mapped: button_map) {
+		std::string name;
+		if (!ReadString(is, name)) {
+			return;
+		}
+		auto it = std::find(Input::kButtonNames.begin(), Input::kButtonNames.end(), name);
+		if (it != Input::kButtonNames.end()) {
+			mapped = std::distance(Input::kButtonNames.begin(), it);
+		} else {
+			Output::Debug("Input log: Unknown button {}", name);
+		}
+	}
+
+	// Index all keyframes for seeking
+	const auto records_start = is.tellg();
+	int kf_rewinds = 0;
+	for (int tag = is.get(); tag != EOF; tag = is.get()) {
+		if (tag == record_buttons) {
+			uint32_t delta;
+			std::vector<int> changes;
+			if (!ReadVarint(is, delta) || !ReadButtons(is, changes)) {
+				break;
+			}
+		} else if (tag == record_rewind) {
+			uint32_t frame;
+			if (!ReadVarint(is, frame)) {
+				break;
+			}
+			++kf_rewinds;
+		} else if (tag == record_keyframe) {
+			Keyframe kf;
+			kf.offset = is.tellg();
+			kf.rewinds = kf_rewinds;
+			uint32_t kf_frame;
+			std::vector<int> pressed;
+			if (!ReadVarint(is, kf_frame) || !ReadButtons(is, pressed) || !SkipString(is) || !SkipString(is)) {
+				break;
+			}
+			kf.frame = static_cast<int>(kf_frame);
+			// After a rewind the frames of the abandoned timeline are reached
+			// again, seeking uses the last time a frame was reached
+			while (!keyframes.empty() && keyframes.back().frame >= kf.frame) {
+				keyframes.pop_back();
+			}
+			keyframes.push_back(kf);
+		} else if (!SkipString(is)) {
+			break;
+		}
+	}
+	Output::Debug("Input log: {} keyframes", keyframes.size());
+
+	is.clear();
+	is.seekg(records_start);
+
+	valid = bool(is);
+	ReadNext();
+}
+
+bool Input::BinaryLogSource::IsBinaryLog(std::istream& is) {
+	char magic[sizeof(binary_magic)] = {};
+	is.read(magic, sizeof(magic));
+	bool res = is && std::equal(std::begin(magic), std::end(magic), std::begin(binary_magic));
+	is.clear();
+	is.seekg(0, std::ios::beg);
+	return res;
+}
+
+bool Input::BinaryLogSource::ReadNext() {
+	auto& is = log_file;
+
+	for (int tag = is.get(); tag != EOF; tag = is.get()) {
+		if (tag == record_buttons) {
+			uint32_t delta;
+			if (!ReadVarint(is, delta) || !ReadButtons(is, next_changes)) {
+				break;
+			}
+			next_frame += UnZigZag(delta);
+			has_next = true;
+			return true;
+		} else if (tag == record_keyframe) {
+			uint32_t kf_frame;
+			std::vector<int> pressed;
+			if (!ReadVarint(is, kf_frame) || !ReadButtons(is, pressed) || !SkipString(is) || !SkipString(is)) {
+				break;
+			}
+			next_frame = static_cast<int>(kf_frame);
+		} else if (tag == record_rewind) {
+			uint32_t frame;
+			if (!ReadVarint(is, frame)) {
+				break;
+			}
+			next_frame = static_cast<int>(frame);
+			++next_rewinds;
+		} else if (!SkipString(is)) {
+			break;
+		}
+	}
+
+	has_next = false;
+	return false;
+}
+
+void Input::BinaryLogSource::Update() {
+	if (!Main_Data::game_system) {
+		return;
+	}
+
+	int cur_frame = Main_Data::game_system->GetFrameCounter();
+
+	// Restored at the first frame simulated after a keyframe, after the savegame finished loading
+	if (cur_frame == rng_restore_frame) {
+		std::istringstream(rng_state) >> Rand::GetRNG();
+		rng_state.clear();
+		rng_restore_frame = -1;
+	}
+
+	// Detected like the recording does, records of an earlier timeline
+	// are due independent of their frame number
+	if (rng_restore_frame < 0) {
+		if (last_frame >= 0 && cur_frame < last_frame) {
+			++rewinds;
+		}
+		last_frame = cur_frame;
+	}
+
+	// Frames can be skipped while the game is not updated, apply all due records
+	while (has_next && (next_rewinds < rewinds || (next_rewinds == rewinds && next_frame <= cur_frame))) {
+		for (int idx: next_changes) {
+			if (idx >= 0 && idx < static_cast<int>(button_map.size()) && button_map[idx] >= 0) {
+				replay_buttons.flip(button_map[idx]);
+			}
+		}
+		ReadNext();
+	}
+
+	pressed_buttons = replay_buttons;
+
+	if (!has_next) {
+		Player::exit_flag = true;
+	}
+
+	Record();
+}
+
+void Input::BinaryLogSource::UpdateSystem() {
+	// input log does not record actions outside of logical frames.
+}
+
+std::string Input::BinaryLogSource::Seek(int frame) {
+	auto it = std::upper_bound(keyframes.begin(), keyframes.end(), frame,
+			[](int f, const Keyframe& kf) { return f < kf.frame; });
+	if (it == keyframes.begin()) {
+		Output::Warning("Input log: No keyframe before frame {}", frame);
+		return {};
+	}
+	--it;
+
+	auto& is = log_file;
+	is.clear();
+	is.seekg(it->offset);
+
+	uint32_t kf_frame;
+	std::vector<int> pressed;
+	std::string save_data;
+	if (!ReadVarint(is, kf_frame) || !ReadButtons(is, pressed) || !ReadString(is, rng_state) || !ReadString(is, save_data)) {
+		Output::Warning("Input log: Corrupted keyframe at frame {}", it->frame);
+		return {};
+	}
+
+	replay_buttons.reset();
+	for (int idx: pressed) {
+		if (idx >= 0 && idx < static_cast<int>(button_map.size()) && button_map[idx] >= 0) {
+			replay_buttons[button_map[idx]] = true;
+		}
+	}
+
+	next_frame = it->frame;
+	next_rewinds = it->rewinds;
+	rewinds = it->rewinds;
+	last_frame = -1;
+	rng_restore_frame = it->frame + 1;
+	ReadNext();
+
+	Output::Debug("Input log: Seeking to keyframe at frame {}", it->frame);
+
+	return save_data;
+}
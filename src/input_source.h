@@ -21,6 +21,8 @@
 #include <bitset>
 #include <fstream>
 #include <memory>
+#include <string>
+#include <vector>
 #include "filesystem_stream.h"
 #include "input_buttons.h"
 #include "keys.h"
@@ -95,13 +97,32 @@ namespace Input {
 
 		bool InitRecording(const std::string& record_to_path);
 
+		/**
+		 * Called once after each logical frame. Writes a state keyframe
+		 * to binary recordings every keyframe_interval frames.
+		 */
+		void RecordKeyframe();
+
+		/**
+		 * Restores the replay position to the last state keyframe at or
+		 * before frame. Only supported by binary input logs.
+		 *
+		 * @param frame frame to seek to
+		 * @return LSD data of the keyframe or empty when no keyframe was found
+		 */
+		virtual std::string Seek(int frame);
+
 		Point GetMousePosition() const { return mouse_pos; }
 
 		const KeyStatus& GetMask() const { return keymask; }
 		KeyStatus& GetMask() { return keymask; }
 
+		/** Amount of logical frames between two keyframes of binary recordings */
+		static constexpr int keyframe_interval = 3600;
+
 	protected:
 		void Record();
+		void RecordBinary();
 
 		std::bitset<BUTTON_COUNT> pressed_buttons;
 		ButtonMappingArray button_mappings;
@@ -113,6 +134,11 @@ namespace Input {
 		Point mouse_pos;
 
 		int last_written_frame = -1;
+
+		bool record_binary = false;
+		std::bitset<BUTTON_COUNT> recorded_buttons;
+		int recorded_frame = 0;
+		int last_keyframe = -1;
 	};
 
 	/**
@@ -149,6 +175,58 @@ namespace Input {
 		std::vector<std::string> keys;
 	};
 
+	/**
+	 * Source that replays button presses from a binary log file.
+	 *
+	 * The log stores button changes delta-encoded against the previous
+	 * state and periodic keyframes containing the savegame and RNG state,
+	 * which allows starting the replay at a later frame.
+	 * When the frame counter goes backwards, e.g. by loading a savegame,
+	 * seeking uses the keyframes of the latest timeline.
+	 */
+	class BinaryLogSource : public Source {
+	public:
+		BinaryLogSource(Filesystem_Stream::InputStream log_file, ButtonMappingArray buttons, DirectionMappingArray directions);
+
+		void Update() override;
+		void UpdateSystem() override;
+		std::string Seek(int frame) override;
+
+		operator bool() const { return valid; }
+
+		/** @return Whether the file starts with the binary log magic */
+		static bool IsBinaryLog(std::istream& is);
+
+	private:
+		struct Keyframe {
+			int frame = 0;
+			/** Rewinds of the frame counter before the keyframe */
+			int rewinds = 0;
+			std::streampos offset;
+		};
+
+		bool ReadNext();
+
+		Filesystem_Stream::InputStream log_file;
+		bool valid = false;
+		/** Maps button indices of the file to the current InputButton */
+		std::vector<int> button_map;
+		std::vector<Keyframe> keyframes;
+		std::bitset<BUTTON_COUNT> replay_buttons;
+
+		bool has_next = false;
+		int next_frame = 0;
+		int next_rewinds = 0;
+		std::vector<int> next_changes;
+
+		/** Frame of the last update and rewinds of the frame counter seen so far */
+		int last_frame = -1;
+		int rewinds = 0;
+
+		int rng_restore_frame = -1;
+		std::string rng_state;
+	};
+
 	extern std::unique_ptr<Source> source;
 }
 
@@ -0,0 +1,92 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "memory_overlay.h"
+#include "memory_stats.h"
+#include "bitmap.h"
+#include "font.h"
+#include "drawable_mgr.h"
+
+using namespace std::chrono_literals;
+
+static constexpr auto refresh_frequency = 1s;
+
+MemoryOverlay::MemoryOverlay() :
+	Drawable(Priority_Overlay + 100, Drawable::Flags::Global)
+{
+	DrawableMgr::Register(this);
+}
+
+void MemoryOverlay::UpdateText() {
+	auto stats = MemoryStats::Collect();
+
+	lines.clear();
+	lines.push_back("Memory: " + MemoryStats::FormatBytes(MemoryStats::GetTotalBytes(stats)));
+	for (auto& s: stats) {
+		lines.push_back(MemoryStats::FormatStats(s));
+	}
+	dirty = true;
+}
+
+void MemoryOverlay::Update() {
+	if (!draw_memory) {
+		return;
+	}
+
+	auto now = Game_Clock::GetFrameTime();
+	if (!lines.empty() && now - last_refresh_time < refresh_frequency) {
+		return;
+	}
+	last_refresh_time = now;
+
+	UpdateText();
+}
+
+void MemoryOverlay::Draw(Bitmap& dst) {
+	if (!draw_memory || lines.empty()) {
+		return;
+	}
+
+	if (dirty) {
+		int width = 0;
+		int line_height = 0;
+		for (auto& line: lines) {
+			Rect rect = Font::Default()->GetSize(line);
+			width = std::max(width, rect.width);
+			line_height = std::max(line_height, rect.height);
+		}
+		int height = line_height * static_cast<int>(lines.size());
+
+		if (!memory_bitmap || memory_bitmap->GetWidth() < width + 1 || memory_bitmap->GetHeight() < height) {
+			memory_bitmap = Bitmap::Create(width + 1, height, true);
+		}
+		memory_bitmap->Clear();
+
+		memory_rect = Rect(0, 0, width + 1, height);
+		memory_bitmap->FillRect(memory_rect, Color(0, 0, 0, 128));
+		for (size_t i = 0; i < lines.size(); ++i) {
+			memory_bitmap->TextDraw(1, static_cast<int>(i) * line_height, Color(255, 255, 255, 255), lines[i]);
+		}
+
+		dirty = false;
+	}
+
+	// Below the FPS counter
+	dst.Blit(1, 16, *memory_bitmap, memory_rect, 255);
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MEMORY_OVERLAY_H
+#define EP_MEMORY_OVERLAY_H
+
+#include <string>
+#include <vector>
+#include "drawable.h"
+#include "memory_management.h"
+#include "rect.h"
+#include "game_clock.h"
+
+/**
+ * MemoryOverlay class.
+ * Shows the memory held by the caches below the FPS counter.
+ */
+class MemoryOverlay : public Drawable {
+public:
+	MemoryOverlay();
+
+	void Draw(Bitmap& dst) override;
+
+	/**
+	 * Update the memory overlay.
+	 * The statistics are collected once per second.
+	 */
+	void Update();
+
+	/**
+	 * Set whether we will render the memory usage.
+	 *
+	 * @param value true if we want to draw to screen
+	 */
+	void SetDrawMemory(bool value);
+
+private:
+	void UpdateText();
+
+	BitmapRef memory_bitmap;
+	Game_Clock::time_point last_refresh_time;
+
+	/** Rect to draw on screen */
+	Rect memory_rect;
+
+	std::vector<std::string> lines;
+
+	bool dirty = true;
+	bool draw_memory = false;
+};
+
+inline void MemoryOverlay::SetDrawMemory(bool value) {
+	draw_memory = value;
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <mutex>
+
+#include "memory_stats.h"
+#include "game_clock.h"
+#include "output.h"
+
+namespace {
+	struct Registry {
+		std::mutex mutex;
+		std::vector<MemoryStats::Source*> sources;
+	};
+
+	// Function local to be available for sources in other translation units
+	// during static initialization and destruction
+	Registry& GetRegistry() {
+		static Registry registry;
+		return registry;
+	}
+
+	std::chrono::seconds log_interval{0};
+	Game_Clock::time_point last_log_time;
+}
+
+MemoryStats::Source::Source(std::string name, measure_fn measure)
+	: name(std::move(name)), measure(std::move(measure)) {
+	auto& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.sources.push_back(this);
+}
+
+MemoryStats::Source::~Source() {
+	auto& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	auto& sources = registry.sources;
+	sources.erase(std::remove(sources.begin(), sources.end(), this), sources.end());
+}
+
+MemoryStats::Stats MemoryStats::Source::Read() {
+	if (measure) {
+		measure(*this);
+	}
+
+	Stats stats;
+	stats.name = name;
+	stats.bytes = bytes.load(std::memory_order_relaxed);
+	stats.entries = entries.load(std::memory_order_relaxed);
+	stats.hits = hits.load(std::memory_order_relaxed);
+	stats.misses = misses.load(std::memory_order_relaxed);
+	stats.evictions = evictions.load(std::memory_order_relaxed);
+	return stats;
+}
+
+std::vector<MemoryStats::Stats> MemoryStats::Collect() {
+	auto& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	std::vector<Stats> result;
+	for (auto* source: registry.sources) {
+		auto stats = source->Read();
+
+		auto it = std::find_if(result.begin(), result.end(), [&](const Stats& s) { return s.name == stats.name; });
+		if (it == result.end()) {
+			result.push_back(std::move(stats));
+			continue;
+		}
+
+		it->bytes += stats.bytes;
+		it->entries += stats.entries;
+		it->hits += stats.hits;
+		it->misses += stats.misses;
+		it->evictions += stats.evictions;
+	}
+
+	return result;
+}
+
+size_t MemoryStats::GetTotalBytes(const std::vector<Stats>& stats) {
+	size_t total = 0;
+	for (auto& s: stats) {
+		total += s.bytes;
+	}
+	return total;
+}
+
+std::string MemoryStats::FormatBytes(size_t bytes) {
+	if (bytes < 1024) {
+		return std::to_string(bytes) + "B";
+	}
+	if (bytes < 1024 * 1024) {
+		return std::to_string((bytes + 512) / 1024) + "K";
+	}
+	auto tenths = (bytes * 10 + 512 * 1024) / (1024 * 1024);
+	return std::to_string(tenths / 10) + "." + std::to_string(tenths % 10) + "M";
+}
+
+std::string MemoryStats::FormatStats(const Stats& stats) {
+	std::string line = stats.name + ": " + FormatBytes(stats.bytes) + " / " + std::to_string(stats.entries);
+
+	auto lookups = stats.hits + stats.misses;
+	if (lookups > 0) {
+		line += ", hit " + std::to_string(stats.hits * 100 / lookups) + "%";
+	}
+	if (stats.evictions > 0) {
+		line += ", evict " + std::to_string(stats.evictions);
+	}
+
+	return line;
+}
+
+void MemoryStats::SetLogInterval(int seconds) {
+	log_interval = std::chrono::seconds(std::max(seconds, 0));
+	last_log_time = Game_Clock::GetFrameTime();
+}
+
+void MemoryStats::Update() {
+	if (log_interval.count() == 0) {
+		return;
+	}
+
+	auto now = Game_Clock::GetFrameTime();
+	if (now - last_log_time < log_interval) {
+		return;
+	}
+	last_log_time = now;
+
+	auto stats = Collect();
+
+	std::string line = "Memory: " + FormatBytes(GetTotalBytes(stats));
+	for (auto& s: stats) {
+		line += " | " + FormatStats(s);
+	}
+	Output::Debug("{}", line);
+}
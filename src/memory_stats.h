@@ -0,0 +1,201 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MEMORY_STATS_H
+#define EP_MEMORY_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Registry of the memory held by caches and pools.
+ * Every cache owns a Source and reports its live bytes, entry count and
+ * hit/miss/eviction counters through it. The sources are read by the
+ * memory overlay, the debug scene and a periodic log line.
+ */
+namespace MemoryStats {
+	/** Counters of all sources of the same name, summed up */
+	struct Stats {
+		std::string name;
+		size_t bytes = 0;
+		size_t entries = 0;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+	};
+
+	/**
+	 * A memory consumer reporting to the registry.
+	 * Registers itself on construction and unregisters on destruction.
+	 * The counters can be updated from any thread.
+	 */
+	class Source {
+	public:
+		/**
+		 * Function called before the usage is read, for caches which cannot
+		 * track their usage incrementally. Must call SetUsage.
+		 */
+		using measure_fn = std::function<void(Source&)>;
+
+		/**
+		 * @param name name shown to the user, sources of the same name are summed up
+		 * @param measure optional function to update the usage
+		 */
+		explicit Source(std::string name, measure_fn measure = nullptr);
+		~Source();
+
+		Source(const Source&) = delete;
+		Source& operator=(const Source&) = delete;
+
+		/**
+		 * Lookups found a cached entry.
+		 *
+		 * @param count number of lookups
+		 */
+		void Hit(uint64_t count = 1);
+
+		/**
+		 * Lookups did not find a cached entry.
+		 *
+		 * @param count number of lookups
+		 */
+		void Miss(uint64_t count = 1);
+
+		/**
+		 * Entries were removed to free memory.
+		 *
+		 * @param count number of removed entries
+		 */
+		void Evict(size_t count = 1);
+
+		/**
+		 * An entry was added.
+		 *
+		 * @param bytes size of the entry
+		 */
+		void Allocate(size_t bytes);
+
+		/**
+		 * An entry was removed.
+		 *
+		 * @param bytes size of the entry
+		 */
+		void Release(size_t bytes);
+
+		/**
+		 * Replaces the usage.
+		 *
+		 * @param bytes live bytes
+		 * @param entries number of entries
+		 */
+		void SetUsage(size_t bytes, size_t entries);
+
+		/** @return name of the source */
+		const std::string& GetName() const;
+
+		/** @return current counters, calls the measure function first */
+		Stats Read();
+
+	private:
+		std::string name;
+		measure_fn measure;
+		std::atomic<size_t> bytes{0};
+		std::atomic<size_t> entries{0};
+		std::atomic<uint64_t> hits{0};
+		std::atomic<uint64_t> misses{0};
+		std::atomic<uint64_t> evictions{0};
+	};
+
+	/**
+	 * Reads all registered sources. Sources of the same name are summed up,
+	 * the order is the order of the first registration of a name.
+	 *
+	 * @return counters of all sources
+	 */
+	std::vector<Stats> Collect();
+
+	/**
+	 * @param stats counters returned by Collect
+	 * @return sum of the live bytes
+	 */
+	size_t GetTotalBytes(const std::vector<Stats>& stats);
+
+	/**
+	 * Formats a byte count for display, e.g. "512B", "12K" or "3.4M".
+	 *
+	 * @param bytes byte count
+	 * @return formatted string
+	 */
+	std::string FormatBytes(size_t bytes);
+
+	/**
+	 * Formats the counters of a source as one line.
+	 *
+	 * @param stats counters of a source
+	 * @return formatted line
+	 */
+	std::string FormatStats(const Stats& stats);
+
+	/**
+	 * Sets how often the memory usage is written to the log.
+	 *
+	 * @param seconds interval in seconds, 0 disables logging
+	 */
+	void SetLogInterval(int seconds);
+
+	/**
+	 * Writes the memory usage to the log when the log interval elapsed.
+	 * Called once per frame.
+	 */
+	void Update();
+}
+
+inline void MemoryStats::Source::Hit(uint64_t count) {
+	hits.fetch_add(count, std::memory_order_relaxed);
+}
+
+inline void MemoryStats::Source::Miss(uint64_t count) {
+	misses.fetch_add(count, std::memory_order_relaxed);
+}
+
+inline void MemoryStats::Source::Evict(size_t count) {
+	evictions.fetch_add(count, std::memory_order_relaxed);
+}
+
+inline void MemoryStats::Source::Allocate(size_t nbytes) {
+	bytes.fetch_add(nbytes, std::memory_order_relaxed);
+	entries.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void MemoryStats::Source::Release(size_t nbytes) {
+	bytes.fetch_sub(nbytes, std::memory_order_relaxed);
+	entries.fetch_sub(1, std::memory_order_relaxed);
+}
+
+inline void MemoryStats::Source::SetUsage(size_t nbytes, size_t nentries) {
+	bytes.store(nbytes, std::memory_order_relaxed);
+	entries.store(nentries, std::memory_order_relaxed);
+}
+
+inline const std::string& MemoryStats::Source::GetName() const {
+	return name;
+}
+
+#endif
@@ -19,6 +19,7 @@
 #define EP_OPACITY_H
 
 #include <cassert>
+#include <algorithm>
 #include <climits>
 #include <memory>
 
@@ -83,6 +84,11 @@ class TileOpacity {
 		/** Initialize with num_tiles tiles */
 		explicit TileOpacity(int w, int h);
 
+		TileOpacity(const TileOpacity& o);
+		TileOpacity& operator=(const TileOpacity& o);
+		TileOpacity(TileOpacity&&) noexcept = default;
+		TileOpacity& operator=(TileOpacity&&) noexcept = default;
+
 		/** Get ImageOpacity for tile at x, y */
 		ImageOpacity Get(int x, int y) const;
 
@@ -92,6 +98,15 @@ class TileOpacity {
 		/** @return true if no tile opacities stored */
 		bool Empty() const;
 
+		/** @return number of tiles per row */
+		int GetWidth() const;
+
+		/** @return number of tile rows */
+		int GetHeight() const;
+
+		/** @return ImageOpacity of the area covered by all tiles */
+		ImageOpacity GetCombined() const;
+
 	private:
 		std::unique_ptr<uint8_t[]> _p;
 		int _w = 0;
@@ -105,6 +120,21 @@ inline TileOpacity::TileOpacity(int w, int h)
 	assert(_h >= 0);
 }
 
+inline TileOpacity::TileOpacity(const TileOpacity& o)
+	: _p(o.Empty() ? nullptr : new uint8_t[o._w * o._h]), _w(o._w), _h(o._h)
+{
+	if (_p) {
+		std::copy(o._p.get(), o._p.get() + _w * _h, _p.get());
+	}
+}
+
+inline TileOpacity& TileOpacity::operator=(const TileOpacity& o) {
+	if (this != &o) {
+		*this = TileOpacity(o);
+	}
+	return *this;
+}
+
 inline ImageOpacity TileOpacity::Get(int x, int y) const {
 	assert(x >= 0);
 	assert(y >= 0);
@@ -127,4 +157,26 @@ inline bool TileOpacity::Empty() const {
 	return _w * _h == 0;
 }
 
+inline int TileOpacity::GetWidth() const {
+	return _w;
+}
+
+inline int TileOpacity::GetHeight() const {
+	return _h;
+}
+
+inline ImageOpacity TileOpacity::GetCombined() const {
+	if (Empty()) {
+		return ImageOpacity::Partial;
+	}
+
+	auto first = _p[0];
+	for (int i = 1; i < _w * _h; ++i) {
+		if (_p[i] != first) {
+			return ImageOpacity::Partial;
+		}
+	}
+	return static_cast<ImageOpacity>(first);
+}
+
 #endif
@@ -25,6 +25,7 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <mutex>
 
 #include "graphics.h"
 #include "output.h"
@@ -93,6 +94,20 @@ namespace {
 		LogLevel lvl = {};
 	} last_message;
 
+	/** Thread which is allowed to write the log and show messages */
+	const std::thread::id main_thread_id = std::this_thread::get_id();
+
+	/** Messages logged by other threads, written by WriteDeferred */
+	struct DeferredMessage {
+		LogLevel lvl;
+		std::string msg;
+		Color color;
+	};
+	std::mutex deferred_mutex;
+	std::vector<DeferredMessage> deferred_messages;
+	/** First error reported by another thread through ErrorOrDeferStr */
+	std::string deferred_error;
+
 #ifdef GEKKO
 	/* USBGecko Debugging on Wii */
 	bool usbgecko = false;
@@ -135,6 +150,23 @@ void Output::IgnorePause(bool const val) {
 }
 
 static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Color()) {
+	if (std::this_thread::get_id() != main_thread_id) {
+		if (lvl == LogLevel::Error) {
+			// Errors terminate the Player before the main thread writes the buffer
+#ifdef __ANDROID__
+			__android_log_print(ANDROID_LOG_ERROR, "EasyRPG Player", "%s", msg.c_str());
+#else
+			std::cerr << GetLogPrefix(lvl) << msg << std::endl;
+#endif
+			return;
+		}
+
+		// The log file and the message overlay are not thread safe
+		std::lock_guard<std::mutex> lock(deferred_mutex);
+		deferred_messages.push_back({lvl, msg, c});
+		return;
+	}
+
 	const char* prefix = GetLogPrefix(lvl);
 	// Skip logging to file in the browser
 #ifndef EMSCRIPTEN
@@ -283,6 +315,13 @@ void Output::ToggleLog() {
 
 void Output::ErrorStr(std::string const& err) {
 	WriteLog(LogLevel::Error, err);
+
+	if (std::this_thread::get_id() != main_thread_id) {
+		// The error screen can only be shown by the main thread and exit()
+		// would destroy the thread pools, which join the calling thread.
+		std::_Exit(EXIT_FAILURE);
+	}
+
 	static bool recursive_call = false;
 	if (!recursive_call && DisplayUi) {
 		recursive_call = true;
@@ -308,6 +347,35 @@ void Output::ErrorStr(std::string const& err) {
 	exit(EXIT_FAILURE);
 }
 
+void Output::ErrorOrDeferStr(std::string const& err) {
+	if (std::this_thread::get_id() == main_thread_id) {
+		ErrorStr(err);
+	}
+
+	std::lock_guard<std::mutex> lock(deferred_mutex);
+	if (deferred_error.empty()) {
+		deferred_error = err;
+	}
+}
+
+void Output::WriteDeferred() {
+	std::vector<DeferredMessage> messages;
+	std::string error;
+	{
+		std::lock_guard<std::mutex> lock(deferred_mutex);
+		messages.swap(deferred_messages);
+		error.swap(deferred_error);
+	}
+
+	for (auto& message: messages) {
+		WriteLog(message.lvl, message.msg, message.color);
+	}
+
+	if (!error.empty()) {
+		ErrorStr(error);
+	}
+}
+
 void Output::WarningStr(std::string const& warn) {
 	if (log_level < LogLevel::Warning) {
 		return;
@@ -87,6 +87,15 @@ namespace Output {
 	 */
 	void ToggleLog();
 
+	/**
+	 * Writes the messages which were logged by worker threads.
+	 * These are only buffered because the log and the message
+	 * overlay must be accessed from the main thread.
+	 * Called once per frame by Graphics::Update.
+	 * An error reported by ErrorOrDeferStr is raised afterwards.
+	 */
+	void WriteDeferred();
+
 	/**
 	 * Ignores pause in Warning and Error.
 	 *
@@ -144,6 +153,25 @@ namespace Output {
 	 */
 	[[noreturn]] void ErrorStr(std::string const& err);
 
+	/**
+	 * Raises an error message with formatted string. On other threads
+	 * than the main thread the error is raised by the next WriteDeferred.
+	 *
+	 * @param fmtstr the format string
+	 * @param args formatting arguments
+	 */
+	template <typename FmtStr, typename... Args>
+	void ErrorOrDefer(FmtStr&& fmtstr, Args&&... args);
+
+	/**
+	 * Raises an error message. On other threads than the main thread the
+	 * error is raised by the next WriteDeferred and the function returns,
+	 * the caller must handle the failure.
+	 *
+	 * @param err error to display.
+	 */
+	void ErrorOrDeferStr(std::string const& err);
+
 	/**
 	 * Prints a debug message to the console.
 	 *
@@ -179,6 +207,11 @@ inline void Output::Error(FmtStr&& fmtstr, Args&&... args) {
 	ErrorStr(fmt::format(std::forward<FmtStr>(fmtstr), std::forward<Args>(args)...));
 }
 
+template <typename FmtStr, typename... Args>
+inline void Output::ErrorOrDefer(FmtStr&& fmtstr, Args&&... args) {
+	ErrorOrDeferStr(fmt::format(std::forward<FmtStr>(fmtstr), std::forward<Args>(args)...));
+}
+
 template <typename FmtStr, typename... Args>
 inline void Output::Warning(FmtStr&& fmtstr, Args&&... args) {
 	WarningStr(fmt::format(std::forward<FmtStr>(fmtstr), std::forward<Args>(args)...));
@@ -44,6 +44,7 @@
 
 #include "async_handler.h"
 #include "audio.h"
+#include "audio_secache.h"
 #include "cache.h"
 #include "rand.h"
 #include "cmdline_parser.h"
@@ -72,6 +73,7 @@
 #include <lcf/lmt/reader.h>
 #include <lcf/lsd/reader.h>
 #include "main_data.h"
+#include "memory_stats.h"
 #include "output.h"
 #include "player.h"
 #include <lcf/reader_lcf.h>
@@ -83,6 +85,7 @@
 #include "version.h"
 #include "game_quit.h"
 #include "scene_title.h"
+#include "state.h"
 #include "instrumentation.h"
 #include "transition.h"
 #include <lcf/scope_guard.h>
@@ -123,6 +126,7 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	int replay_seek_frame;
 	std::string command_line;
 	int speed_modifier = 3;
 	int speed_modifier_plus = 10;
@@ -142,6 +146,17 @@ namespace {
 	FileRequestBinding system_request_id;
 	FileRequestBinding save_request_id;
 	FileRequestBinding map_request_id;
+
+	// Overwritten by --turbo-fps, zero disables turbo
+	Game_Clock::duration turbo_present_time{};
+
+	/**
+	 * Turbo fast forward: The game is simulated as fast as possible and
+	 * drawn only when the present time elapsed.
+	 */
+	bool IsTurbo() {
+		return turbo_present_time > Game_Clock::duration() && Input::IsSystemPressed(Input::FAST_FORWARD_PLUS);
+	}
 }
 
 void Player::Init(int argc, char *argv[]) {
@@ -208,6 +223,18 @@ void Player::Init(int argc, char *argv[]) {
 	Input::Init(std::move(buttons), std::move(directions), replay_input_path, record_input_path);
 	Input::AddRecordingData(Input::RecordingData::CommandLine, command_line);
 
+	if (cfg.audio.se_cache_size.Get() > 0) {
+		AudioSeCache::SetCacheLimit(static_cast<size_t>(cfg.audio.se_cache_size.Get()) * 1024 * 1024);
+	}
+
+	Bitmap::SetCompositeThreads(cfg.video.render_threads.Get());
+	Bitmap::SetIndexedStorage(cfg.video.indexed_bitmaps.Get());
+	Cache::SetDecodeThreads(cfg.video.render_threads.Get());
+	Graphics::SetPipelined(cfg.video.pipelined_render.Get());
+	Graphics::SetShowMemory(cfg.video.show_memory.Get());
+	SetTurboFps(cfg.video.turbo_fps.Get());
+	MemoryStats::SetLogInterval(cfg.player.memory_log.Get());
+
 	player_config = std::move(cfg.player);
 }
 
@@ -244,17 +271,14 @@ void Player::MainLoop() {
 
 	Player::UpdateInput();
 
-	int num_updates = 0;
-	while (Game_Clock::NextGameTimeStep()) {
-		if (num_updates > 0) {
+	int num_updates = UpdateLogicFrames(frame_time, [](int frame) {
+		if (frame > 0) {
 			Player::UpdateInput();
 		}
 
 		Scene::old_instances.clear();
 		Scene::instance->MainFunction();
-
-		++num_updates;
-	}
+	});
 	if (num_updates == 0) {
 		// If no logical frames ran, we need to update the system keys only.
 		Input::UpdateSystem();
@@ -301,6 +325,26 @@ void Player::Resume() {
 	Game_Clock::ResetFrame(Game_Clock::now());
 }
 
+int Player::UpdateLogicFrames(Game_Clock::time_point frame_time, const std::function<void(int)>& logic_frame) {
+	// In turbo mode the frames between two presents are simulated without
+	// drawing them, the presents are still limited by the frame limiter
+	auto in_turbo_time = [&]() {
+		return IsTurbo() && Game_Clock::now() < frame_time + turbo_present_time
+			&& Scene::instance->type != Scene::Null;
+	};
+
+	int num_updates = 0;
+	while (Game_Clock::NextGameTimeStep() || in_turbo_time()) {
+		logic_frame(num_updates);
+		++num_updates;
+	}
+	return num_updates;
+}
+
+void Player::SetTurboFps(int fps) {
+	turbo_present_time = fps > 0 ? Game_Clock::TimeStepFromFps(fps) : Game_Clock::duration();
+}
+
 void Player::UpdateInput() {
 	// Input Logic:
 	if (Input::IsSystemTriggered(Input::TOGGLE_FPS)) {
@@ -380,11 +424,19 @@ void Player::Update(bool update_scene) {
 		}
 
 		Scene::instance->Update();
+
+		if (Scene::instance == old_instance) {
+			Input::RecordKeyframe();
+		}
 	}
 }
 
 void Player::Draw() {
 	Graphics::Update();
+	if (Graphics::IsPipelined()) {
+		Graphics::DrawPipelined();
+		return;
+	}
 	Graphics::Draw(*DisplayUi->GetDisplaySurface());
 	DisplayUi->UpdateDisplay();
 }
@@ -413,6 +465,10 @@ void Player::Exit() {
 	Player::ResetGameObjects();
 	Font::Dispose();
 	DynRpg::Reset();
+	Bitmap::SetCompositeThreads(1);
+	Cache::SetDecodeThreads(1);
+	// Needs the message overlay, which is destroyed by Graphics::Quit
+	Output::WriteDeferred();
 	Graphics::Quit();
 	Output::Quit();
 	FileFinder::Quit();
@@ -443,6 +499,7 @@ Game_Config Player::ParseCommandLine(int argc, char *argv[]) {
 	reset_flag = false;
 	new_game_flag = false;
 	load_game_id = -1;
+	replay_seek_frame = -1;
 	party_x_position = -1;
 	party_y_position = -1;
 	start_map_id = -1;
@@ -627,6 +684,12 @@ Game_Config Player::ParseCommandLine(int argc, char *argv[]) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--replay-seek")) {
+			if (arg.ParseValue(0, li_value)) {
+				replay_seek_frame = li_value;
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--encoding")) {
 			if (arg.NumValues() > 0) {
 				forced_encoding = arg.Value(0);
@@ -1001,6 +1064,8 @@ void Player::LoadDatabase() {
 			FileExtGuesser::GuessAndAddLmuExtension(FileFinder::Game(), *meta, fileext_map);
 		}
 	}
+
+	StateSet::LoadFlagTable();
 }
 
 static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
@@ -1018,6 +1083,17 @@ static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
 
 void Player::LoadSavegame(const std::string& save_name, int save_id) {
 	Output::Debug("Loading Save {}", save_name);
+
+	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
+	if (!save_stream) {
+		Output::Error("Error loading {}", save_name);
+		return;
+	}
+
+	LoadSavegame(save_stream, save_id);
+}
+
+void Player::LoadSavegame(std::istream& save_stream, int save_id) {
 	Main_Data::game_system->BgmFade(800);
 
 	// We erase the screen now before loading the saved game. This prevents an issue where
@@ -1030,12 +1106,6 @@ void Player::LoadSavegame(const std::string& save_name, int save_id) {
 		static_cast<Scene_Title*>(title_scene.get())->OnGameStart();
 	}
 
-	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
-	if (!save_stream) {
-		Output::Error("Error loading {}", save_name);
-		return;
-	}
-
 	std::unique_ptr<lcf::rpg::Save> save = lcf::LSD_Reader::Load(save_stream, encoding);
 
 	if (!save.get()) {
@@ -1273,15 +1343,29 @@ Options:
       --fullscreen         Start in fullscreen mode.
       --show-fps           Enable frames per second counter.
       --fps-render-window  Render the frames per second counter in windowed mode.
+      --show-memory        Show the memory held by the caches on the screen.
       --fps-limit          Set a custom frames per second limit. The default is 60 FPS.
                            Set to 0 to run with unlimited frames per second.
                            This option is not supported on all platforms.
       --no-vsync           Disable vertical sync and use fps-limit. Even without
                            this option, vsync may not be supported on all platforms.
+      --turbo-fps N        Holding the fast forward plus key runs the game as fast
+                           as possible and only draws N frames per second.
+                           The default is 0 (fast forward plus is not a turbo).
+      --pipelined-render   Composite the next frame on a render thread while the
+                           current frame is presented. Adds one frame of latency.
+      --render-threads N   Split large blits into bands composited by N threads
+                           and decode the images of a map with N threads.
+                           The default is 1 (no splitting).
+      --indexed-bitmaps    Keep large paletted images at one byte per pixel.
+                           Saves memory but blitting them is slower.
+      --se-cache-size N    Keep up to N MB of decoded sound effects in memory.
       --enable-mouse       Use mouse click for decision and scroll wheel for lists
       --enable-touch       Use one/two finger tap for decision/cancel
       --hide-title         Hide the title background image and center the
                            command menu.
+      --memory-log N       Write the memory held by the caches to the log
+                           every N seconds.
       --load-game-id N     Skip the title scene and load SaveN.lsd
                            (N is padded to two digits).
       --new-game           Skip the title scene and start a new game directly.
@@ -1290,6 +1374,11 @@ Options:
       --record-input PATH  Record all button input to a log file at PATH.
       --replay-input PATH  Replays button presses from an input log generated by
                            --record-input.
+                           Logs recorded to a PATH ending in ".eprb" use a
+                           compact binary format with periodic state keyframes.
+      --replay-seek N      When replaying a binary input log, restore the last
+                           state keyframe before frame N instead of replaying
+                           from the start.
       --save-path PATH     Instead of storing save files in the game directory
                            they are stored in PATH. The directory must exist.
                            When using the game browser all games will share
@@ -26,6 +26,7 @@
 #include "game_config.h"
 #include <vector>
 #include <memory>
+#include <functional>
 
 /**
  * Player namespace.
@@ -71,6 +72,24 @@ namespace Player {
 	 */
 	void MainLoop();
 
+	/**
+	 * Runs the logic frames of one game loop iteration: The frames which are
+	 * due according to Game_Clock and, while the turbo fast forward is
+	 * active, more frames until the turbo present time passed.
+	 *
+	 * @param frame_time start time of the game loop iteration.
+	 * @param logic_frame runs one logic frame, gets the index of the frame.
+	 * @return number of logic frames which ran.
+	 */
+	int UpdateLogicFrames(Game_Clock::time_point frame_time, const std::function<void(int)>& logic_frame);
+
+	/**
+	 * Sets the present rate of the turbo fast forward.
+	 *
+	 * @param fps presents per second while fast forward plus is held, 0 disables the turbo.
+	 */
+	void SetTurboFps(int fps);
+
 	/**
 	 * Pauses the game engine.
 	 */
@@ -151,6 +170,15 @@ namespace Player {
 	 */
 	void LoadSavegame(const std::string& save_file, int save_id = 0);
 
+	/**
+	 * Loads savegame data from a stream.
+	 *
+	 * @param save_stream Stream containing LSD data
+	 * @param save_id ID of the savegame to load, negative when the data
+	 *                does not belong to a save slot (e.g. replay keyframes)
+	 */
+	void LoadSavegame(std::istream& save_stream, int save_id);
+
 	/**
 	 * Starts a new game
 	 */
@@ -336,6 +364,9 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Frame to seek to when replaying a binary input log, -1 when disabled */
+	extern int replay_seek_frame;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
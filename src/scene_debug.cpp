@@ -113,6 +113,8 @@ Window_VarList::Mode Scene_Debug::GetWindowMode() const {
 			return Window_VarList::eCommonEvent;
 		case eCallMapEvent:
 			return Window_VarList::eMapEvent;
+		case eMemory:
+			return Window_VarList::eMemory;
 		default:
 			return Window_VarList::eNone;
 	}
@@ -427,6 +429,13 @@ void Scene_Debug::Update() {
 					}
 				}
 				break;
+			case eMemory:
+				if (sz > 1) {
+					DoMemory();
+				} else {
+					PushUiVarList();
+				}
+				break;
 		}
 		Game_Map::SetNeedRefresh(true);
 	} else if (range_window->GetActive() && Input::IsRepeated(Input::RIGHT)) {
@@ -498,6 +507,7 @@ void Scene_Debug::UpdateRangeListWindow() {
 			} else {
 				addItem("Call MapEvent", !is_battle);
 				addItem("Call BtlEvent", is_battle);
+				addItem("Memory");
 			}
 			break;
 		case eSwitch:
@@ -555,6 +565,9 @@ void Scene_Debug::UpdateRangeListWindow() {
 		case eFullHeal:
 			addItem("Full Heal");
 			break;
+		case eMemory:
+			addItem("Memory");
+			break;
 		case eCallBattleEvent:
 			if (is_battle) {
 				auto* troop = Game_Battle::GetActiveTroop();
@@ -803,6 +816,12 @@ void Scene_Debug::DoCallBattleEvent() {
 	Output::Debug("Debug Scene Forced execution of battle troop {} event page {} on the map foreground interpreter.", troop->ID, page.ID);
 }
 
+void Scene_Debug::DoMemory() {
+	// Refresh the counters
+	var_window->UpdateList(1);
+	var_window->Refresh();
+}
+
 void Scene_Debug::TransitionIn(SceneType /* prev_scene */) {
 	Transition::instance().InitShow(Transition::TransitionCutIn, this);
 }
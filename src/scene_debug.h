@@ -66,6 +66,7 @@ public:
 		eCallCommonEvent,
 		eCallMapEvent,
 		eCallBattleEvent,
+		eMemory,
 		eLastMainMenuOption,
 	};
 
@@ -107,6 +108,7 @@ private:
 	void DoCallCommonEvent();
 	void DoCallMapEvent();
 	void DoCallBattleEvent();
+	void DoMemory();
 
 	/** Displays a range selection for mode. */
 	std::unique_ptr<Window_Command> range_window;
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <sstream>
 #include "scene_logo.h"
 #include "async_handler.h"
 #include "bitmap.h"
@@ -97,6 +98,12 @@ void Scene_Logo::Update() {
 
 				std::string save_name = save.FindFile(ss.str());
 				Player::LoadSavegame(save_name, Player::load_game_id);
+			} else if (Player::replay_seek_frame > 0) {
+				auto keyframe = Input::SeekReplay(Player::replay_seek_frame);
+				if (!keyframe.empty()) {
+					std::istringstream save_stream(keyframe);
+					Player::LoadSavegame(save_stream, -1);
+				}
 			}
 		}
 		else {
@@ -74,11 +74,14 @@ void Scene_Map::Start() {
 
 	// Called here instead of Scene Load, otherwise wrong graphic stack
 	// is used.
-	if (from_save_id > 0) {
+	if (from_save_id != 0) {
 		auto current_music = Main_Data::game_system->GetCurrentBGM();
 		Main_Data::game_system->BgmStop();
 		Main_Data::game_system->BgmPlay(current_music);
-		DynRpg::Load(from_save_id);
+		// Negative ids are saves without a slot (replay keyframes)
+		if (from_save_id > 0) {
+			DynRpg::Load(from_save_id);
+		}
 	} else {
 		Game_Map::PlayBgm();
 	}
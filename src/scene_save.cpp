@@ -88,7 +88,23 @@ void Scene_Save::Save(const FilesystemView& fs, int slot_id, bool prepare_save)
 }
 
 void Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+	Main_Data::game_system->SetSaveSlot(slot_id);
+
+	WriteSaveData(os, prepare_save);
+
+	DynRpg::Save(slot_id);
+
+#ifdef EMSCRIPTEN
+	// Save changed file system
+	EM_ASM({
+		FS.syncfs(function(err) {
+		});
+	});
+#endif
+
+}
 
+void Scene_Save::WriteSaveData(std::ostream& os, bool prepare_save) {
 	lcf::rpg::Save save;
 	auto& title = save.title;
 	// TODO: Maybe find a better place to setup the save file?
@@ -120,7 +136,6 @@ void Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
 		title.hero_name = ToString(actor->GetName());
 	}
 
-	Main_Data::game_system->SetSaveSlot(slot_id);
 	save.party_location = Main_Data::game_player->GetSaveData();
 	Game_Map::PrepareSave(save);
 
@@ -149,17 +164,6 @@ void Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
 	}
 	auto lcf_engine = Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
 	lcf::LSD_Reader::Save(os, save, lcf_engine, Player::encoding);
-
-	DynRpg::Save(slot_id);
-
-#ifdef EMSCRIPTEN
-	// Save changed file system
-	EM_ASM({
-		FS.syncfs(function(err) {
-		});
-	});
-#endif
-
 }
 
 bool Scene_Save::IsSlotValid(int) {
@@ -42,6 +42,15 @@ public:
 	static std::string GetSaveFilename(const FilesystemView& tree, int slot_id);
 	static void Save(const FilesystemView& tree, int slot_id, bool prepare_save = true);
 	static void Save(std::ostream& os, int slot_id, bool prepare_save = true);
+
+	/**
+	 * Writes the current game state as LSD data without touching the
+	 * save slot or DynRPG plugin data.
+	 *
+	 * @param os stream to write to
+	 * @param prepare_save whether to update the save metadata (save count, version)
+	 */
+	static void WriteSaveData(std::ostream& os, bool prepare_save);
 };
 
 #endif
@@ -487,6 +487,11 @@ void Sdl2Ui::UpdateDisplay() {
 	SDL_RenderPresent(sdl_renderer);
 }
 
+bool Sdl2Ui::IsDisplaySurfaceSwappable() const {
+	// The texture is updated from main_surface on every present
+	return true;
+}
+
 void Sdl2Ui::SetTitle(const std::string &title) {
 	SDL_SetWindowTitle(sdl_window, title.c_str());
 }
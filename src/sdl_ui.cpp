@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 
@@ -321,6 +322,8 @@ bool SdlUi::RefreshDisplayMode() {
 	main_surface.reset();
 #ifdef FUNKEY
 	sdl_back_screen = SDL_SetVideoMode(0, 0, bpp, flags);
+	back_screen_wrappers = {};
+	back_screen_frame.reset();
 	sdl_surface = SDL_CreateRGBSurface(SDL_HWSURFACE, 320, 240, 32, 0,0,0,0);
 #else
  	sdl_surface = SDL_SetVideoMode(display_width, display_height, bpp, flags);
@@ -400,14 +403,15 @@ void SdlUi::ProcessEvents() {
 }
 
 void SdlUi::UpdateDisplay() {
+#ifdef FUNKEY
+	// The drawing surface is scaled directly, sdl_surface is not shown
+	StretchBlit(*main_surface, sdl_back_screen);
+	SDL_Flip(sdl_back_screen);
+#else
 	if (zoom_available && current_display_mode.zoom == 2) {
 		// Blit drawing surface x2 scaled over window surface
 		Blit2X(*main_surface, sdl_surface);
 	}
-#ifdef FUNKEY
-	SDL_SoftStretch(sdl_surface, NULL, sdl_back_screen, NULL);
-	SDL_Flip(sdl_back_screen);
-#else
 	SDL_UpdateRect(sdl_surface, 0, 0, 0, 0);
 #endif
 }
@@ -529,6 +533,58 @@ void SdlUi::Blit2X(Bitmap const& src, SDL_Surface* dst_surf) {
 	if (SDL_MUSTLOCK(dst_surf)) SDL_UnlockSurface(dst_surf);
 }
 
+#ifdef FUNKEY
+void SdlUi::StretchBlit(Bitmap const& src, SDL_Surface* dst_surf) {
+	if (SDL_MUSTLOCK(dst_surf)) SDL_LockSurface(dst_surf);
+
+	const DynamicFormat format(
+		dst_surf->format->BitsPerPixel,
+		dst_surf->format->Rmask,
+		dst_surf->format->Gmask,
+		dst_surf->format->Bmask,
+		dst_surf->format->Amask,
+		PF::NoAlpha);
+
+	// The wrappers are recreated when the video mode changes
+	auto it = std::find_if(back_screen_wrappers.begin(), back_screen_wrappers.end(), [&](const BitmapRef& wrapper) {
+		return wrapper && wrapper->pixels() == dst_surf->pixels;
+	});
+	if (it == back_screen_wrappers.end()) {
+		std::swap(back_screen_wrappers[0], back_screen_wrappers[1]);
+		back_screen_wrappers[0] = Bitmap::Create(
+			dst_surf->pixels,
+			dst_surf->w,
+			dst_surf->h,
+			dst_surf->pitch,
+			format);
+		it = back_screen_wrappers.begin();
+	}
+	Bitmap& dst = **it;
+
+	const Bitmap* frame = &src;
+	if (dst.bpp() == 2 && src.bpp() != 2) {
+		// 16 bit screen: Convert the frame at its own size, which pixman
+		// does fast, and scale it in the screen format afterwards
+		if (!back_screen_frame || back_screen_frame->GetWidth() != src.GetWidth() ||
+				back_screen_frame->GetHeight() != src.GetHeight()) {
+			const int pitch = (src.GetWidth() * 2 + 3) & ~3;
+			back_screen_frame_pixels.resize(pitch * src.GetHeight() / 4);
+			back_screen_frame = Bitmap::Create(back_screen_frame_pixels.data(),
+				src.GetWidth(), src.GetHeight(), pitch, format);
+		}
+		back_screen_frame->Blit(0, 0, src, src.GetRect(), Opacity::Opaque());
+		frame = back_screen_frame.get();
+	}
+
+	if (!dst.NearestStretchBlit(dst.GetRect(), *frame, frame->GetRect())) {
+		// Other formats: pixman converts while scaling
+		dst.StretchBlit(dst.GetRect(), src, src.GetRect(), Opacity::Opaque());
+	}
+
+	if (SDL_MUSTLOCK(dst_surf)) SDL_UnlockSurface(dst_surf);
+}
+#endif
+
 void SdlUi::ProcessEvent(SDL_Event &evnt) {
 	switch (evnt.type) {
 		case SDL_ACTIVEEVENT:
@@ -24,6 +24,8 @@
 #include "rect.h"
 #include "system.h"
 
+#include <array>
+#include <vector>
 #include <SDL.h>
 
 extern "C" {
@@ -108,6 +110,19 @@ private:
 	 */
 	void Blit2X(Bitmap const& src, SDL_Surface* dst);
 
+#ifdef FUNKEY
+	/**
+	 * Blits a bitmap stretched to the size of an SDL surface.
+	 * Uses Bitmap::NearestStretchBlit when the surface has the format of
+	 * the bitmap. For a 16 bit surface the bitmap is converted first and
+	 * scaled in 16 bit. Other formats are converted by a pixman composite.
+	 *
+	 * @param src source bitmap.
+	 * @param dst destination surface.
+	 */
+	void StretchBlit(Bitmap const& src, SDL_Surface* dst);
+#endif
+
 	/**
 	 * Resets keys states.
 	 */
@@ -127,6 +142,18 @@ private:
 	/** Main SDL window. */
 	SDL_Surface* sdl_surface;
 
+#ifdef FUNKEY
+	/**
+	 * Bitmaps wrapping the pixels of the back screen. SDL_Flip can swap the
+	 * buffers of a double buffered screen, so one is kept per buffer.
+	 */
+	std::array<BitmapRef, 2> back_screen_wrappers;
+
+	/** The drawn frame converted to the format of a 16 bit back screen. */
+	BitmapRef back_screen_frame;
+	std::vector<uint32_t> back_screen_frame_pixels;
+#endif
+
 	std::unique_ptr<AudioInterface> audio_;
 };
 
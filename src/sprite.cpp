@@ -41,6 +41,23 @@ void Sprite::BlitScreen(Bitmap& dst) {
 	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
 		return;
 
+	if (zoom_x_effect != 1.0 || zoom_y_effect != 1.0 || angle_effect != 0.0 || waver_effect_depth != 0) {
+		// Transformed sprites are drawn in one pass which applies tone, flash
+		// and flip directly instead of creating an effect bitmap first
+		src_rect_effect.Adjust(bitmap->GetWidth(), bitmap->GetHeight());
+		Rect rect = src_rect_effect.GetSubRect(src_rect);
+
+		if (dst.AffineBlit(x, y, ox, oy, *bitmap, rect, src_rect_effect,
+				Opacity(opacity_top_effect, opacity_bottom_effect, bush_effect),
+				zoom_x_effect, zoom_y_effect, angle_effect,
+				waver_effect_depth, waver_effect_phase,
+				tone_effect, flash_effect, flipx_effect, flipy_effect)) {
+			bitmap_effects.reset();
+			bitmap_changed = false;
+			return;
+		}
+	}
+
 	BitmapRef draw_bitmap = Refresh(src_rect_effect);
 	if (!draw_bitmap) {
 		return;
@@ -90,7 +107,12 @@ BitmapRef Sprite::Refresh(Rect& rect) {
 		flash_effect != current_flash ||
 		flipx_effect != current_flip_x ||
 		flipy_effect != current_flip_y;
-	bool effects_rect_changed = rect != bitmap_effects_src_rect;
+
+	// A tone applies to the whole bitmap independent of the rect: Tint the
+	// whole sheet once and let all sprites of the same sheet share it instead
+	// of creating one tinted copy per sprite rect.
+	Rect effect_rect = (no_flash && no_flip) ? bitmap->GetRect() : rect;
+	bool effects_rect_changed = effect_rect != bitmap_effects_src_rect;
 
 	if (no_effects || effects_changed || effects_rect_changed || bitmap_changed) {
 		bitmap_effects.reset();
@@ -106,8 +128,8 @@ BitmapRef Sprite::Refresh(Rect& rect) {
 		current_flip_x = flipx_effect;
 		current_flip_y = flipy_effect;
 
-		bitmap_effects = Cache::SpriteEffect(bitmap, rect, flipx_effect, flipy_effect, current_tone, current_flash);
-		bitmap_effects_src_rect = rect;
+		bitmap_effects = Cache::SpriteEffect(bitmap, effect_rect, flipx_effect, flipy_effect, current_tone, current_flash);
+		bitmap_effects_src_rect = effect_rect;
 
 		return bitmap_effects;
 	}
@@ -102,6 +102,11 @@ public:
 	 */
 	void SetFlashEffect(const Color &color);
 
+	/**
+	 * @return the flash effect color
+	 */
+	Color GetFlashEffect() const;
+
 private:
 	BitmapRef bitmap;
 
@@ -295,4 +300,8 @@ inline void Sprite::SetFlashEffect(const Color &color) {
 	flash_effect = color;
 }
 
+inline Color Sprite::GetFlashEffect() const {
+	return flash_effect;
+}
+
 #endif
@@ -20,6 +20,12 @@
 #include "cache.h"
 #include "game_map.h"
 #include "bitmap.h"
+#include "options.h"
+
+namespace {
+	/** Extra pixels around the screen where sprites are still updated */
+	constexpr int cull_margin = 2 * TILE_SIZE;
+}
 
 Sprite_Character::Sprite_Character(Game_Character* character, CloneType type) :
 	character(character),
@@ -79,6 +85,34 @@ void Sprite_Character::Update() {
 	SetBushDepth(bush_split > 3 ? 0 : GetHeight() / bush_split);
 }
 
+bool Sprite_Character::Cull() {
+	if (!GetBitmap() || (UsesCharset() && chara_width == 0)) {
+		// Size not known yet
+		return false;
+	}
+
+	// GetScreenX/Y already wrap around on looping maps
+	const int x = character->GetScreenX(x_shift) - GetOx();
+	const int y = character->GetScreenY(y_shift) - GetOy();
+
+	if (x + GetWidth() > -cull_margin && x < SCREEN_TARGET_WIDTH + cull_margin &&
+		y + GetHeight() > -cull_margin && y < SCREEN_TARGET_HEIGHT + cull_margin) {
+		return false;
+	}
+
+	if (tile_id != character->GetTileId() ||
+		character_index != character->GetSpriteIndex() ||
+		refresh_bitmap ||
+		character_name != character->GetSpriteName()
+	) {
+		// The new graphic can have a different size
+		return false;
+	}
+
+	SetVisible(false);
+	return true;
+}
+
 Game_Character* Sprite_Character::GetCharacter() {
 	return character;
 }
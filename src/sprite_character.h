@@ -51,6 +51,16 @@ public:
 	 */
 	void Update();
 
+	/**
+	 * Checks if the sprite is far enough outside of the screen that updating
+	 * it can be skipped. Culled sprites are hidden, the next Update makes
+	 * them visible again.
+	 * Sprites with a pending graphic change are never culled.
+	 *
+	 * @return true when the sprite was culled and Update can be skipped
+	 */
+	bool Cull();
+
 	/**
 	 * Gets game character.
 	 *
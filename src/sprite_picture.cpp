@@ -44,6 +44,7 @@ Sprite_Picture::Sprite_Picture(int pic_id, Drawable::Flags flags)
 
 void Sprite_Picture::OnPictureShow() {
 	last_spritesheet_frame = -1;
+	last_revision = -1;
 
 	const bool is_battle = Game_Battle::IsBattleRunning();
 	const auto& pic = Main_Data::game_pictures->GetPicture(pic_id);
@@ -85,6 +86,7 @@ void Sprite_Picture::Draw(Bitmap& dst) {
 			&& last_spritesheet_frame != data.spritesheet_frame)
 	{
 		last_spritesheet_frame = data.spritesheet_frame;
+		last_revision = -1;
 
 		const int sw = bitmap->GetWidth() / data.spritesheet_cols;
 		const int sh = bitmap->GetHeight() / data.spritesheet_rows;
@@ -103,35 +105,43 @@ void Sprite_Picture::Draw(Bitmap& dst) {
 
 	SetX(x);
 	SetY(y);
-	SetZoomX(data.current_magnify / 100.0);
-	SetZoomY(data.current_magnify / 100.0);
 
-	auto sr = GetSrcRect();
-	SetOx(sr.width / 2);
-	SetOy(sr.height / 2);
+	// The remaining parameters only depend on the picture
+	if (last_revision != pic.revision) {
+		last_revision = pic.revision;
 
-	SetAngle(data.effect_mode != lcf::rpg::SavePicture::Effect_wave ? data.current_rotation * (2 * M_PI) / 256 : 0.0);
-	SetWaverPhase(data.effect_mode == lcf::rpg::SavePicture::Effect_wave ? data.current_waver * (2 * M_PI) / 256 : 0.0);
-	SetWaverDepth(data.effect_mode == lcf::rpg::SavePicture::Effect_wave ? data.current_effect_power * 2 : 0);
+		SetZoomX(data.current_magnify / 100.0);
+		SetZoomY(data.current_magnify / 100.0);
 
-	// Only older versions of RPG_RT apply the effects of current_bot_trans chunk.
-	const auto top_trans = data.current_top_trans;
-	const auto bottom_trans = feature_bottom_trans ? data.current_bot_trans : top_trans;
+		auto sr = GetSrcRect();
+		SetOx(sr.width / 2);
+		SetOy(sr.height / 2);
 
-	SetOpacity(
-		(int)(255 * (100 - top_trans) / 100),
-		(int)(255 * (100 - bottom_trans) / 100));
+		SetAngle(data.effect_mode != lcf::rpg::SavePicture::Effect_wave ? data.current_rotation * (2 * M_PI) / 256 : 0.0);
+		SetWaverPhase(data.effect_mode == lcf::rpg::SavePicture::Effect_wave ? data.current_waver * (2 * M_PI) / 256 : 0.0);
+		SetWaverDepth(data.effect_mode == lcf::rpg::SavePicture::Effect_wave ? data.current_effect_power * 2 : 0);
 
-	if (bottom_trans != top_trans) {
-		SetBushDepth(GetHeight() / 2);
-	} else {
-		SetBushDepth(0);
+		// Only older versions of RPG_RT apply the effects of current_bot_trans chunk.
+		const auto top_trans = data.current_top_trans;
+		const auto bottom_trans = feature_bottom_trans ? data.current_bot_trans : top_trans;
+
+		SetOpacity(
+			(int)(255 * (100 - top_trans) / 100),
+			(int)(255 * (100 - bottom_trans) / 100));
+
+		if (bottom_trans != top_trans) {
+			SetBushDepth(GetHeight() / 2);
+		} else {
+			SetBushDepth(0);
+		}
+
+		picture_tone = Tone((int) (data.current_red * 128 / 100),
+				(int) (data.current_green * 128 / 100),
+				(int) (data.current_blue * 128 / 100),
+				(int) (data.current_sat * 128 / 100));
 	}
 
-	auto tone = Tone((int) (data.current_red * 128 / 100),
-			(int) (data.current_green * 128 / 100),
-			(int) (data.current_blue * 128 / 100),
-			(int) (data.current_sat * 128 / 100));
+	auto tone = picture_tone;
 	if (data.flags.affected_by_tint) {
 		auto screen_tone = Main_Data::game_screen->GetTone();
 		tone = Blend(tone, screen_tone);
@@ -40,6 +40,9 @@ public:
 
 private:
 	int last_spritesheet_frame = -1;
+	/** Picture revision the sprite parameters were last calculated for */
+	int last_revision = -1;
+	Tone picture_tone;
 	const int pic_id = 0;
 	const bool feature_spritesheet = false;
 	const bool feature_priority_layers = false;
@@ -40,6 +40,8 @@ Spriteset_Map::Spriteset_Map() {
 	panorama.reset(new Plane());
 	panorama->SetZ(Priority_Background);
 
+	PreloadImages();
+
 	ChipsetUpdated();
 
 	need_x_clone = Game_Map::LoopHorizontal();
@@ -71,6 +73,9 @@ void Spriteset_Map::Update() {
 	tilemap->SetTone(new_tone);
 
 	for (size_t i = 0; i < character_sprites.size(); i++) {
+		if (character_sprites[i]->Cull()) {
+			continue;
+		}
 		character_sprites[i]->Update();
 		character_sprites[i]->SetTone(new_tone);
 	}
@@ -110,6 +115,19 @@ void Spriteset_Map::Update() {
 	DynRpg::Update();
 }
 
+void Spriteset_Map::PreloadImages() {
+	std::vector<Cache::PreloadEntry> entries;
+	entries.push_back({Cache::PreloadEntry::Chipset, ToString(Game_Map::GetChipsetName())});
+	entries.push_back({Cache::PreloadEntry::Panorama, Game_Map::Parallax::GetName()});
+
+	for (Game_Event& ev : Game_Map::GetEvents()) {
+		entries.push_back({Cache::PreloadEntry::Charset, ev.GetSpriteName()});
+	}
+	entries.push_back({Cache::PreloadEntry::Charset, Main_Data::game_player->GetSpriteName()});
+
+	Cache::Preload(entries);
+}
+
 // Finds the sprite for a specific character
 Sprite_Character* Spriteset_Map::FindCharacter(Game_Character* character) const
 {
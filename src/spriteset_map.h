@@ -85,6 +85,9 @@ protected:
 	std::unique_ptr<Screen> screen;
 	std::unique_ptr<Frame> frame;
 
+	/** Decodes the chipset, panorama and charsets of the map in one batch */
+	void PreloadImages();
+
 	void CreateSprite(Game_Character* character, bool create_x_clone, bool create_y_clone);
 	void CreateAirshipShadowSprite(bool create_x_clone, bool create_y_clone);
 
@@ -19,6 +19,7 @@
 #include <lcf/reader_util.h>
 #include <lcf/data.h>
 #include "output.h"
+#include <algorithm>
 #include <cassert>
 
 namespace State {
@@ -227,3 +228,118 @@ const std::vector<lcf::rpg::State*> SortedByPriority(const std::vector<lcf::rpg:
 }
 
 } //namspace State
+
+namespace {
+	/** Flags of the database states indexed by state id - 1 */
+	std::vector<uint32_t> state_flags;
+}
+
+uint32_t StateSet::GetFlags(const lcf::rpg::State& state) {
+	uint32_t f = 0;
+
+	auto affect = [&](bool enabled, uint32_t half, uint32_t dbl) {
+		if (enabled) {
+			if (state.affect_type == lcf::rpg::State::AffectType_half) {
+				f |= half;
+			} else if (state.affect_type == lcf::rpg::State::AffectType_double) {
+				f |= dbl;
+			}
+		}
+	};
+	affect(state.affect_attack, Flag_AtkHalf, Flag_AtkDouble);
+	affect(state.affect_defense, Flag_DefHalf, Flag_DefDouble);
+	affect(state.affect_spirit, Flag_SpiHalf, Flag_SpiDouble);
+	affect(state.affect_agility, Flag_AgiHalf, Flag_AgiDouble);
+
+	switch (state.restriction) {
+		case lcf::rpg::State::Restriction_do_nothing:
+			f |= Flag_RestrictionDoNothing;
+			if (state.auto_release_prob == 0) {
+				f |= Flag_DoNothingForever;
+			}
+			break;
+		case lcf::rpg::State::Restriction_attack_enemy:
+			f |= Flag_RestrictionAttackEnemy;
+			break;
+		case lcf::rpg::State::Restriction_attack_ally:
+			f |= Flag_RestrictionAttackAlly;
+			break;
+		default:
+			break;
+	}
+
+	if (state.avoid_attacks) {
+		f |= Flag_AvoidAttacks;
+	}
+	if (state.reflect_magic) {
+		f |= Flag_ReflectMagic;
+	}
+	if (state.cursed) {
+		f |= Flag_Cursed;
+	}
+
+	return f;
+}
+
+void StateSet::LoadFlagTable() {
+	state_flags.clear();
+	state_flags.reserve(lcf::Data::states.size());
+	for (const auto& state : lcf::Data::states) {
+		state_flags.push_back(GetFlags(state));
+	}
+}
+
+void StateSet::Build(const StateVec& states) {
+	ids.clear();
+	flags = 0;
+	significant_state = nullptr;
+	reduce_hit_ratio = 100;
+
+	int priority = 0;
+	bool has_death = false;
+
+	for (int i = 0; i < static_cast<int>(states.size()); ++i) {
+		if (states[i] <= 0) {
+			continue;
+		}
+
+		auto state_id = i + 1;
+		ids.push_back(state_id);
+
+		auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, state_id);
+		if (state == nullptr) {
+			Output::Warning("StateSet: Invalid state ID {}", state_id);
+			continue;
+		}
+
+		// The table is missing when states were added after loading
+		flags |= state_id <= static_cast<int>(state_flags.size()) ? state_flags[state_id - 1] : GetFlags(*state);
+		reduce_hit_ratio = std::min<int>(reduce_hit_ratio, state->reduce_hit_ratio);
+
+		// Same order as State::GetSignificantState: Death has highest priority
+		if (has_death) {
+			continue;
+		}
+		if (state->ID == lcf::rpg::State::kDeathID) {
+			significant_state = state;
+			has_death = true;
+		} else if (state->priority >= priority) {
+			significant_state = state;
+			priority = state->priority;
+		}
+	}
+}
+
+lcf::rpg::State::Restriction StateSet::GetSignificantRestriction() const {
+	// Priority is nomove > attack enemy > attack ally > normal
+	if (flags & Flag_RestrictionDoNothing) {
+		return lcf::rpg::State::Restriction_do_nothing;
+	}
+	if (flags & Flag_RestrictionAttackEnemy) {
+		return lcf::rpg::State::Restriction_attack_enemy;
+	}
+	if (flags & Flag_RestrictionAttackAlly) {
+		return lcf::rpg::State::Restriction_attack_ally;
+	}
+	return lcf::rpg::State::Restriction_normal;
+}
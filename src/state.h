@@ -37,6 +37,76 @@ class PermanentStates {
 		std::vector<bool> states;
 };
 
+/**
+ * Summary of the inflicted states of a StateVec.
+ * Holds the sparse list of inflicted states and the combined flags of
+ * these states so that battle queries are a mask test instead of a scan
+ * over all states of the database.
+ * The StateVec stays the authoritative storage (it is saved as is), the
+ * summary must be rebuilt whenever it changes.
+ */
+class StateSet {
+	public:
+		enum Flag : uint32_t {
+			Flag_AtkHalf = 1 << 0,
+			Flag_AtkDouble = 1 << 1,
+			Flag_DefHalf = 1 << 2,
+			Flag_DefDouble = 1 << 3,
+			Flag_SpiHalf = 1 << 4,
+			Flag_SpiDouble = 1 << 5,
+			Flag_AgiHalf = 1 << 6,
+			Flag_AgiDouble = 1 << 7,
+			Flag_RestrictionDoNothing = 1 << 8,
+			Flag_RestrictionAttackEnemy = 1 << 9,
+			Flag_RestrictionAttackAlly = 1 << 10,
+			/** Restriction do nothing without automatic release */
+			Flag_DoNothingForever = 1 << 11,
+			Flag_AvoidAttacks = 1 << 12,
+			Flag_ReflectMagic = 1 << 13,
+			Flag_Cursed = 1 << 14
+		};
+
+		/**
+		 * Rebuilds the summary.
+		 *
+		 * @param states states to summarize
+		 */
+		void Build(const StateVec& states);
+
+		/** @return ids of all inflicted states in ascending order */
+		const std::vector<int16_t>& GetIds() const;
+
+		/** @return true when any inflicted state has one of the flags */
+		bool Any(uint32_t flags) const;
+
+		/** @see State::GetSignificantRestriction */
+		lcf::rpg::State::Restriction GetSignificantRestriction() const;
+
+		/** @see State::GetSignificantState */
+		const lcf::rpg::State* GetSignificantState() const;
+
+		/** @return lowest hit ratio of all inflicted states or 100 */
+		int GetReduceHitRatio() const;
+
+		/**
+		 * @param state database state
+		 * @return flags of a single state
+		 */
+		static uint32_t GetFlags(const lcf::rpg::State& state);
+
+		/**
+		 * Precomputes the flags of all database states for Build.
+		 * Must be called whenever the database is loaded.
+		 */
+		static void LoadFlagTable();
+
+	private:
+		std::vector<int16_t> ids;
+		uint32_t flags = 0;
+		const lcf::rpg::State* significant_state = nullptr;
+		int reduce_hit_ratio = 100;
+};
+
 namespace State {
 
 
@@ -129,6 +199,22 @@ const std::vector<lcf::rpg::State*> SortedByPriority(const std::vector<lcf::rpg:
 
 } //namespace State
 
+inline const std::vector<int16_t>& StateSet::GetIds() const {
+	return ids;
+}
+
+inline bool StateSet::Any(uint32_t flags) const {
+	return (this->flags & flags) != 0;
+}
+
+inline const lcf::rpg::State* StateSet::GetSignificantState() const {
+	return significant_state;
+}
+
+inline int StateSet::GetReduceHitRatio() const {
+	return reduce_hit_ratio;
+}
+
 inline bool State::Has(int state_id, const StateVec& states) {
 	return static_cast<int>(states.size()) >= state_id && states[state_id - 1] > 0;
 }
@@ -24,9 +24,178 @@
 #include "font.h"
 #include "text.h"
 #include "compiler.h"
+#include "memory_stats.h"
 
 #include <cctype>
+#include <cstring>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+	struct LayoutGlyph {
+		char32_t ch;
+		bool is_exfont;
+		/** Width returned by the first rendering of the glyph */
+		int advance;
+	};
+
+	/** Decoded glyph run of a string, shared by all draws of the same string */
+	struct Layout {
+		std::string font_name;
+		unsigned font_size = 0;
+		/** The string, referenced by the cache key */
+		std::string text;
+		Rect rect;
+		std::vector<LayoutGlyph> glyphs;
+		/** Sum of all advances, -1 until the string was drawn once */
+		int width = -1;
+
+		size_t GetSize() const {
+			return sizeof(Layout) + font_name.size() + text.size() + glyphs.size() * sizeof(LayoutGlyph);
+		}
+	};
+
+	using LayoutRef = std::shared_ptr<Layout>;
+
+	/** Font address and text, the text of a cached key points into its Layout */
+	struct LayoutKey {
+		const Font* font;
+		StringView text;
+
+		bool operator==(const LayoutKey& other) const {
+			return font == other.font && text == other.text;
+		}
+	};
+
+	struct LayoutKeyHash {
+		size_t operator()(const LayoutKey& key) const {
+			// FNV-1a
+			uint64_t hash = 0xcbf29ce484222325 ^ reinterpret_cast<uintptr_t>(key.font);
+			for (char c : key.text) {
+				hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	/** The cache is cleared when it grows beyond this amount of strings */
+	constexpr size_t layout_cache_limit = 1024;
+
+	MemoryStats::Source layout_stats("Text layouts");
+
+	LayoutRef CreateLayout(Font& font, StringView text) {
+		auto layout = std::make_shared<Layout>();
+		layout->font_name = font.name;
+		layout->font_size = font.size;
+		layout->text = ToString(text);
+		layout->rect = font.GetSize(text);
+
+		auto iter = text.data();
+		const auto end = iter + text.size();
+		while (iter != end) {
+			auto ret = Utils::TextNext(iter, end, 0);
+
+			iter = ret.next;
+			if (EP_UNLIKELY(!ret)) {
+				continue;
+			}
+			layout->glyphs.push_back({ ret.ch, ret.is_exfont, 0 });
+		}
+
+		return layout;
+	}
+
+	class LayoutCache {
+	public:
+		/**
+		 * Looks up the glyph run of a string and creates it on a miss.
+		 *
+		 * @param font font used to render
+		 * @param text text to render
+		 * @param width set to the known width of the run or -1
+		 * @return glyph run
+		 */
+		LayoutRef Get(Font& font, StringView text, int& width) {
+			auto it = cache.find(LayoutKey{ &font, text });
+			if (it != cache.end()) {
+				auto& layout = it->second;
+				// A different font can be allocated at the address of a destroyed one
+				if (layout->font_name == font.name && layout->font_size == font.size) {
+					layout_stats.Hit();
+					width = layout->width;
+					return layout;
+				}
+				layout_stats.Release(layout->GetSize());
+				cache.erase(it);
+			}
+
+			layout_stats.Miss();
+
+			if (cache.size() >= layout_cache_limit) {
+				layout_stats.Evict(cache.size());
+				for (auto& entry: cache) {
+					layout_stats.Release(entry.second->GetSize());
+				}
+				cache.clear();
+			}
+
+			auto layout = CreateLayout(font, text);
+			layout_stats.Allocate(layout->GetSize());
+			cache.emplace(LayoutKey{ &font, layout->text }, layout);
+
+			width = -1;
+			return layout;
+		}
+
+	private:
+		std::unordered_map<LayoutKey, LayoutRef, LayoutKeyHash> cache;
+	};
+
+	// Text is mostly drawn by the main thread, which uses its own cache without
+	// locking. Other threads (overlays drawn by the render thread) share a locked one.
+	const std::thread::id main_thread_id = std::this_thread::get_id();
+	LayoutCache main_layouts;
+	std::mutex layout_mutex;
+	LayoutCache other_layouts;
+
+	LayoutRef GetLayout(Font& font, StringView text, int& width) {
+		if (std::this_thread::get_id() == main_thread_id) {
+			return main_layouts.Get(font, text, width);
+		}
+
+		std::lock_guard<std::mutex> lock(layout_mutex);
+		return other_layouts.Get(font, text, width);
+	}
+
+	void SetLayoutAdvances(Layout& layout, const std::vector<int>& advances) {
+		if (layout.width >= 0) {
+			return;
+		}
+
+		int width = 0;
+		for (size_t i = 0; i < advances.size(); ++i) {
+			layout.glyphs[i].advance = advances[i];
+			width += advances[i];
+		}
+		layout.width = width;
+	}
+
+	/** Stores the advances of the first rendering of a glyph run */
+	void MeasureLayout(Layout& layout, const std::vector<int>& advances) {
+		// A layout is only used by the threads of the cache it came from
+		if (std::this_thread::get_id() == main_thread_id) {
+			SetLayoutAdvances(layout, advances);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(layout_mutex);
+		SetLayoutAdvances(layout, advances);
+	}
+}
 
 Rect Text::Draw(Bitmap& dest, int x, int y, Font& font, const Bitmap& system, int color, char32_t ch, bool is_exfont) {
 	if (is_exfont) {
@@ -47,7 +216,12 @@ Rect Text::Draw(Bitmap& dest, int x, int y, Font& font, Color color, char32_t ch
 Rect Text::Draw(Bitmap& dest, const int x, const int y, Font& font, const Bitmap& system, const int color, StringView text, const Text::Alignment align) {
 	if (text.length() == 0) return { x, y, 0, 0 };
 
-	Rect dst_rect = font.GetSize(text);
+	// The glyph run of a string only depends on the font: Strings which are
+	// drawn repeatedly (menu items, numbers) are decoded and measured once
+	int width;
+	auto layout = GetLayout(font, text, width);
+
+	Rect dst_rect = layout->rect;
 
 	const int ih = dst_rect.height;
 
@@ -71,19 +245,29 @@ Rect Text::Draw(Bitmap& dest, const int x, const int y, Font& font, const Bitmap
 	// Where to draw the next glyph (x pos)
 	int next_glyph_pos = 0;
 
+	if (width >= 0) {
+		// The advances are known: Stop at the right border of dest
+		for (auto& glyph: layout->glyphs) {
+			if (ix + next_glyph_pos >= dest.GetWidth()) {
+				break;
+			}
+			Text::Draw(dest, ix + next_glyph_pos, iy, font, system, color, glyph.ch, glyph.is_exfont);
+			next_glyph_pos += glyph.advance;
+		}
+		return { x, y, width, ih };
+	}
+
 	// This loops always renders a single char, color blends it and then puts
 	// it onto the text_surface (including the drop shadow)
-	auto iter = text.data();
-	const auto end = iter + text.size();
-	while (iter != end) {
-		auto ret = Utils::TextNext(iter, end, 0);
-
-		iter = ret.next;
-		if (EP_UNLIKELY(!ret)) {
-			continue;
-		}
-		next_glyph_pos += Text::Draw(dest, ix + next_glyph_pos, iy, font, system, color, ret.ch, ret.is_exfont).width;
+	std::vector<int> advances;
+	advances.reserve(layout->glyphs.size());
+	for (auto& glyph: layout->glyphs) {
+		int advance = Text::Draw(dest, ix + next_glyph_pos, iy, font, system, color, glyph.ch, glyph.is_exfont).width;
+		advances.push_back(advance);
+		next_glyph_pos += advance;
 	}
+	MeasureLayout(*layout, advances);
+
 	return { x, y, next_glyph_pos, ih };
 }
 
@@ -0,0 +1,111 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int num_threads) {
+	for (int i = 0; i < num_threads; ++i) {
+		threads.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	cv.notify_all();
+
+	for (auto& t: threads) {
+		t.join();
+	}
+}
+
+void ThreadPool::Push(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	cv.notify_one();
+}
+
+void ThreadPool::WorkerMain() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		cv.wait(lock, [this]() { return quit || !tasks.empty(); });
+		if (tasks.empty()) {
+			// quit is set and nothing left to do
+			return;
+		}
+
+		auto task = std::move(tasks.front());
+		tasks.pop_front();
+
+		lock.unlock();
+		task();
+		lock.lock();
+	}
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& func) {
+	if (count <= 0) {
+		return;
+	}
+
+	if (count == 1 || threads.empty()) {
+		for (int i = 0; i < count; ++i) {
+			func(i);
+		}
+		return;
+	}
+
+	struct Job {
+		std::atomic<int> next{0};
+		std::atomic<int> done{0};
+		std::mutex mutex;
+		std::condition_variable cv;
+	};
+	auto job = std::make_shared<Job>();
+
+	// Helpers which start after all items were taken return without touching func
+	auto run = [job, count, &func]() {
+		int num_done = 0;
+		for (int i = job->next++; i < count; i = job->next++) {
+			func(i);
+			++num_done;
+		}
+		if (num_done > 0 && (job->done += num_done) == count) {
+			std::lock_guard<std::mutex> lock(job->mutex);
+			job->cv.notify_all();
+		}
+	};
+
+	const int helpers = std::min(GetNumThreads(), count - 1);
+	for (int i = 0; i < helpers; ++i) {
+		Push(run);
+	}
+
+	// The caller works on its own job too, so nesting can not deadlock
+	run();
+
+	std::unique_lock<std::mutex> lock(job->mutex);
+	job->cv.wait(lock, [&job, count]() { return job->done == count; });
+}
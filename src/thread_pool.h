@@ -0,0 +1,81 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_THREAD_POOL_H
+#define EP_THREAD_POOL_H
+
+// Headers
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads executing queued tasks.
+ */
+class ThreadPool {
+public:
+	/**
+	 * Creates the pool.
+	 *
+	 * @param num_threads number of worker threads to spawn
+	 */
+	explicit ThreadPool(int num_threads);
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/** Waits for all queued tasks and joins the workers */
+	~ThreadPool();
+
+	/** @return number of worker threads */
+	int GetNumThreads() const;
+
+	/**
+	 * Queues a task for execution on one of the workers.
+	 *
+	 * @param task function to execute
+	 */
+	void Push(std::function<void()> task);
+
+	/**
+	 * Calls func(i) for every i in [0, count) distributed over the workers
+	 * and the calling thread. Returns when all calls finished.
+	 * Safe to call from multiple threads and from inside a task.
+	 *
+	 * @param count number of work items
+	 * @param func function invoked with the work item index
+	 */
+	void ParallelFor(int count, const std::function<void(int)>& func);
+
+private:
+	void WorkerMain();
+
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool quit = false;
+};
+
+inline int ThreadPool::GetNumThreads() const {
+	return static_cast<int>(threads.size());
+}
+
+#endif
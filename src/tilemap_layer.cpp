@@ -172,7 +172,10 @@ void TilemapLayer::DrawTileImpl(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tiles
 	// Create tone changed tile
 	if (tone != Tone()) {
 		if (chipset_tone_tiles.insert(tone_hash).second) {
+			++tone_misses;
 			tone_tileset.ToneBlit(col * TILE_SIZE, row * TILE_SIZE, tileset, rect, tone, Opacity::Opaque());
+		} else {
+			++tone_hits;
 		}
 		src = &tone_tileset;
 	}
@@ -357,6 +360,15 @@ void TilemapLayer::Draw(Bitmap& dst, int z_order) {
 			}
 		}
 	}
+
+	if (tone_hits > 0) {
+		bitmap_stats.Hit(tone_hits);
+		tone_hits = 0;
+	}
+	if (tone_misses > 0) {
+		bitmap_stats.Miss(tone_misses);
+		tone_misses = 0;
+	}
 }
 
 TilemapLayer::TileXY TilemapLayer::GetCachedAutotileAB(short ID, short animID) {
@@ -700,5 +712,18 @@ void TilemapLayer::SetTone(Tone tone) {
 	if (chipset_effect) {
 		chipset_effect->Clear();
 	}
+	bitmap_stats.Evict(chipset_tone_tiles.size());
 	chipset_tone_tiles.clear();
 }
+
+void TilemapLayer::MeasureBitmaps(MemoryStats::Source& source) const {
+	size_t bytes = 0;
+	for (auto* bitmap: { &chipset_effect, &autotiles_ab_screen, &autotiles_ab_screen_effect,
+			&autotiles_d_screen, &autotiles_d_screen_effect }) {
+		if (*bitmap) {
+			bytes += (*bitmap)->GetSize();
+		}
+	}
+
+	source.SetUsage(bytes, autotiles_ab_map.size() + autotiles_d_map.size());
+}
@@ -25,6 +25,7 @@
 #include <unordered_map>
 #include "system.h"
 #include "drawable.h"
+#include "memory_stats.h"
 #include "tone.h"
 #include "opacity.h"
 #include "span.h"
@@ -100,6 +101,9 @@ private:
 	int animation_type = 0;
 	int layer = 0;
 	bool fast_blit = false;
+	/** Tone tile lookups of the current Draw, reported to bitmap_stats once per Draw */
+	int tone_hits = 0;
+	int tone_misses = 0;
 
 	void CreateTileCache(const std::vector<short>& nmap_data);
 	void GenerateAutotileAB(short ID, short animID);
@@ -148,6 +152,12 @@ private:
 	TilemapSubLayer upper_layer;
 
 	Tone tone;
+
+	/** Reports the size of the autotile and tone bitmaps to MemoryStats */
+	void MeasureBitmaps(MemoryStats::Source& source) const;
+
+	/** Entries are the generated autotiles, lookups are the tone tiles */
+	MemoryStats::Source bitmap_stats{"Tilemap", [this](MemoryStats::Source& source) { MeasureBitmaps(source); }};
 };
 
 inline BitmapRef const& TilemapLayer::GetChipset() const {
@@ -18,6 +18,8 @@
 #include "translation.h"
 
 // Headers
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <memory>
@@ -45,6 +47,9 @@
 #define TRFILE_RPG_RT_LMT    "rpg_rt.lmt.po"
 #define TRFILE_META_INI      "META.INI"
 
+// Compiled dictionaries of a language, stored in the save directory
+#define TRFILE_COMPILED_CACHE "easyrpg_translation_{}.bin"
+
 // Message box commands to remove a message box or add one in place.
 // These commands are added by translators in the .po files to manipulate
 //   text boxes at runtime. They are magic strings that will not otherwise
@@ -173,6 +178,8 @@ bool Translation::ParseLanguageFiles(const std::string& lang_id)
 		return true;
 	}
 
+	ReadCompiledCache(lang_id);
+
 	// Scan for files in the directory and parse them.
 	for (const auto& tr_name : *language_tree.ListDirectory()) {
 		if (tr_name.second.type != DirectoryTree::FileType::Regular) {
@@ -183,37 +190,39 @@ bool Translation::ParseLanguageFiles(const std::string& lang_id)
 			sys = std::make_unique<Dictionary>();
 			auto is = FileFinder::Game().OpenInputStream(language_tree.FindFile(tr_name.first));
 			if (is) {
-				ParsePoFile(std::move(is), *sys);
+				ParsePoFile(std::move(is), tr_name.first, *sys);
 			}
 		} else if (tr_name.first == TRFILE_RPG_RT_BATTLE) {
 			battle = std::make_unique<Dictionary>();
 			auto is = FileFinder::Game().OpenInputStream(language_tree.FindFile(tr_name.first));
 			if (is) {
-				ParsePoFile(std::move(is), *battle);
+				ParsePoFile(std::move(is), tr_name.first, *battle);
 			}
 		} else if (tr_name.first == TRFILE_RPG_RT_COMMON) {
 			common = std::make_unique<Dictionary>();
 			auto is = FileFinder::Game().OpenInputStream(language_tree.FindFile(tr_name.first));
 			if (is) {
-				ParsePoFile(std::move(is), *common);
+				ParsePoFile(std::move(is), tr_name.first, *common);
 			}
 		} else if (tr_name.first == TRFILE_RPG_RT_LMT) {
 			mapnames = std::make_unique<Dictionary>();
 			auto is = FileFinder::Game().OpenInputStream(language_tree.FindFile(tr_name.first));
 			if (is) {
-				ParsePoFile(std::move(is), *mapnames);
+				ParsePoFile(std::move(is), tr_name.first, *mapnames);
 			}
 		} else {
 			std::unique_ptr<Dictionary> dict;
 			dict = std::make_unique<Dictionary>();
 			auto is = FileFinder::Game().OpenInputStream(language_tree.FindFile(tr_name.first));
 			if (is) {
-				ParsePoFile(std::move(is), *dict);
+				ParsePoFile(std::move(is), tr_name.first, *dict);
 				maps[tr_name.first] = std::move(dict);
 			}
 		}
 	}
 
+	WriteCompiledCache(lang_id);
+
 	// Log
 	Output::Debug("Translation loaded {} sys, {} common, {} battle, and {} map .po files", (sys==nullptr?0:1), (battle==nullptr?0:1), (common==nullptr?0:1), maps.size());
 	return true;
@@ -622,27 +631,160 @@ void Translation::RewriteEventCommandMessage(const Dictionary& dict, std::vector
 	}
 }
 
-void Translation::RewriteMapMessages(const std::string& map_name, lcf::rpg::Map& map) {
+void Translation::SelectMapMessages(const std::string& map_name) {
+	rewritten_pages.clear();
+
 	// Retrieve lookup for this map.
 	auto mapIt = maps.find(map_name);
-	if (mapIt==maps.end()) { return; }
+	map_dict = (mapIt != maps.end()) ? mapIt->second.get() : nullptr;
+}
 
-	// Rewrite all event commands on all pages.
-	for (lcf::rpg::Event& ev : map.events) {
-		for (lcf::rpg::EventPage& pg : ev.pages) {
-			RewriteEventCommandMessage(*mapIt->second, pg.event_commands);
+void Translation::RewriteEventPageMessages(int event_id, lcf::rpg::EventPage& page) {
+	if (!map_dict) {
+		return;
+	}
+
+	uint32_t key = (static_cast<uint32_t>(event_id) << 16) | static_cast<uint32_t>(page.ID);
+	if (!rewritten_pages.insert(key).second) {
+		return;
+	}
+
+	RewriteEventCommandMessage(*map_dict, page.event_commands);
+}
+
+void Translation::ParsePoFile(Filesystem_Stream::InputStream is, const std::string& name, Dictionary& out)
+{
+	if (!is.good()) {
+		return;
+	}
+
+	CompiledPo po;
+	po.crc = Utils::CRC32(is);
+	po.dict = &out;
+	is.clear();
+	po.size = is.seekg(0, std::ios_base::end).tellg();
+	is.seekg(0, std::ios_base::beg);
+
+	auto it = compiled_cache_index.find(name);
+	if (it != compiled_cache_index.end() && it->second.size == po.size && it->second.crc == po.crc) {
+		compiled_cache.clear();
+		compiled_cache.seekg(it->second.offset, std::ios_base::beg);
+		if (Dictionary::FromBinary(out, compiled_cache)) {
+			compiled_pos.emplace_back(name, po);
+			return;
+		}
+		out = Dictionary();
+	}
+
+	compiled_dirty = true;
+	if (!Dictionary::FromPo(out, is)) {
+		Output::Warning("Failure parsing PO file, resetting");
+		out = Dictionary();
+	}
+	compiled_pos.emplace_back(name, po);
+}
+
+namespace {
+	constexpr char compiled_magic[] = "EPTC";
+	constexpr uint32_t compiled_version = 1;
+
+	template <typename T>
+	void WriteLE(std::ostream& out, T value) {
+		for (size_t i = 0; i < sizeof(T); ++i) {
+			out.put(static_cast<char>((static_cast<uint64_t>(value) >> (i * 8)) & 0xFF));
+		}
+	}
+
+	template <typename T>
+	bool ReadLE(std::istream& in, T& value) {
+		uint64_t res = 0;
+		for (size_t i = 0; i < sizeof(T); ++i) {
+			int c = in.get();
+			if (c == EOF) {
+				return false;
+			}
+			res |= static_cast<uint64_t>(c & 0xFF) << (i * 8);
 		}
+		value = static_cast<T>(res);
+		return true;
 	}
 }
 
-void Translation::ParsePoFile(Filesystem_Stream::InputStream is, Dictionary& out)
+void Translation::ReadCompiledCache(const std::string& lang_id)
 {
-	if (is.good()) {
-		if (!Dictionary::FromPo(out, is)) {
-			Output::Warning("Failure parsing PO file, resetting");
-			out = Dictionary();
+	compiled_cache_index.clear();
+	compiled_pos.clear();
+	compiled_dirty = false;
+
+	compiled_cache = FileFinder::Save().OpenInputStream(fmt::format(TRFILE_COMPILED_CACHE, lang_id));
+	if (!compiled_cache) {
+		return;
+	}
+
+	char magic[4] = {};
+	uint32_t version = 0;
+	uint32_t count = 0;
+	compiled_cache.read(magic, sizeof(magic));
+	if (!compiled_cache || memcmp(magic, compiled_magic, sizeof(magic)) != 0 ||
+			!ReadLE(compiled_cache, version) || version != compiled_version || !ReadLE(compiled_cache, count)) {
+		Output::Debug("Translation: Ignoring invalid compiled cache for {}", lang_id);
+		compiled_cache = Filesystem_Stream::InputStream();
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t name_size = 0;
+		uint32_t blob_size = 0;
+		CompiledPo po;
+		if (!ReadLE(compiled_cache, name_size) || name_size > 4096) {
+			break;
 		}
+		std::string name(name_size, '\0');
+		compiled_cache.read(&name[0], name_size);
+		if (!ReadLE(compiled_cache, po.size) || !ReadLE(compiled_cache, po.crc) || !ReadLE(compiled_cache, blob_size)) {
+			break;
+		}
+		po.offset = compiled_cache.tellg();
+		compiled_cache_index[name] = po;
+		compiled_cache.seekg(blob_size, std::ios_base::cur);
+	}
+}
+
+void Translation::WriteCompiledCache(const std::string& lang_id)
+{
+	compiled_cache = Filesystem_Stream::InputStream();
+	compiled_cache_index.clear();
+
+	if (!compiled_dirty) {
+		compiled_pos.clear();
+		return;
+	}
+
+	auto out = FileFinder::Save().OpenOutputStream(fmt::format(TRFILE_COMPILED_CACHE, lang_id));
+	if (!out) {
+		Output::Debug("Translation: Unable to write compiled cache for {}", lang_id);
+		compiled_pos.clear();
+		return;
+	}
+
+	out.write(compiled_magic, 4);
+	WriteLE(out, compiled_version);
+	WriteLE(out, static_cast<uint32_t>(compiled_pos.size()));
+
+	for (const auto& po : compiled_pos) {
+		std::stringstream blob;
+		po.second.dict->ToBinary(blob);
+		std::string blob_str = blob.str();
+
+		WriteLE(out, static_cast<uint32_t>(po.first.size()));
+		out.write(po.first.data(), po.first.size());
+		WriteLE(out, po.second.size);
+		WriteLE(out, po.second.crc);
+		WriteLE(out, static_cast<uint32_t>(blob_str.size()));
+		out.write(blob_str.data(), blob_str.size());
 	}
+
+	compiled_pos.clear();
 }
 
 void Translation::ClearTranslationLookups()
@@ -652,6 +794,9 @@ void Translation::ClearTranslationLookups()
 	battle.reset();
 	mapnames.reset();
 	maps.clear();
+
+	map_dict = nullptr;
+	rewritten_pages.clear();
 }
 
 
@@ -664,9 +809,124 @@ void Translation::ClearTranslationLookups()
 void Dictionary::addEntry(const Entry& entry)
 {
 	// Space-saving measure: If the translation string is empty, there's no need to save it (since we will just show the original).
-	if (!entry.translation.empty()) {
-		entries[entry.context][entry.original] = entry.translation;
+	if (entry.translation.empty()) {
+		return;
+	}
+
+	IndexEntry ie;
+	ie.hash = Hash(entry.context, entry.original);
+	ie.context_offset = static_cast<uint32_t>(pool.size());
+	ie.context_size = static_cast<uint32_t>(entry.context.size());
+	pool += entry.context;
+	ie.original_offset = static_cast<uint32_t>(pool.size());
+	ie.original_size = static_cast<uint32_t>(entry.original.size());
+	pool += entry.original;
+	ie.translation_offset = static_cast<uint32_t>(pool.size());
+	ie.translation_size = static_cast<uint32_t>(entry.translation.size());
+	pool += entry.translation;
+
+	index.push_back(ie);
+}
+
+void Dictionary::Compile()
+{
+	// Stable, so a later duplicate entry stays behind the earlier one and wins in Find
+	std::stable_sort(index.begin(), index.end(), [](const IndexEntry& l, const IndexEntry& r) {
+		return l.hash < r.hash;
+	});
+	pool.shrink_to_fit();
+	index.shrink_to_fit();
+}
+
+uint64_t Dictionary::Hash(StringView context, StringView original)
+{
+	// FNV-1a, context and original are separated by a byte that is not valid UTF-8
+	uint64_t hash = 14695981039346656037ULL;
+	auto add = [&hash](unsigned char c) {
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	};
+
+	for (char c : context) {
+		add(static_cast<unsigned char>(c));
+	}
+	add(0xFF);
+	for (char c : original) {
+		add(static_cast<unsigned char>(c));
+	}
+
+	return hash;
+}
+
+bool Dictionary::Find(StringView context, StringView original, StringView& translation) const
+{
+	uint64_t hash = Hash(context, original);
+	auto it = std::lower_bound(index.begin(), index.end(), hash, [](const IndexEntry& e, uint64_t h) {
+		return e.hash < h;
+	});
+
+	bool found = false;
+	for (; it != index.end() && it->hash == hash; ++it) {
+		if (GetString(it->context_offset, it->context_size) == context &&
+				GetString(it->original_offset, it->original_size) == original) {
+			translation = GetString(it->translation_offset, it->translation_size);
+			found = true;
+		}
+	}
+	return found;
+}
+
+void Dictionary::ToBinary(std::ostream& out) const
+{
+	WriteLE(out, static_cast<uint32_t>(index.size()));
+	WriteLE(out, static_cast<uint32_t>(pool.size()));
+	out.write(pool.data(), pool.size());
+
+	for (const auto& ie : index) {
+		WriteLE(out, ie.hash);
+		WriteLE(out, ie.context_offset);
+		WriteLE(out, ie.context_size);
+		WriteLE(out, ie.original_offset);
+		WriteLE(out, ie.original_size);
+		WriteLE(out, ie.translation_offset);
+		WriteLE(out, ie.translation_size);
+	}
+}
+
+bool Dictionary::FromBinary(Dictionary& res, std::istream& in)
+{
+	uint32_t count = 0;
+	uint32_t pool_size = 0;
+	if (!ReadLE(in, count) || !ReadLE(in, pool_size)) {
+		return false;
+	}
+
+	res.pool.resize(pool_size);
+	if (!in.read(&res.pool[0], pool_size)) {
+		return false;
 	}
+
+	auto in_pool = [pool_size](uint32_t offset, uint32_t size) {
+		return offset <= pool_size && size <= pool_size - offset;
+	};
+
+	res.index.resize(count);
+	for (auto& ie : res.index) {
+		if (!ReadLE(in, ie.hash) ||
+				!ReadLE(in, ie.context_offset) || !ReadLE(in, ie.context_size) ||
+				!ReadLE(in, ie.original_offset) || !ReadLE(in, ie.original_size) ||
+				!ReadLE(in, ie.translation_offset) || !ReadLE(in, ie.translation_size)) {
+			return false;
+		}
+
+		if (!in_pool(ie.context_offset, ie.context_size) ||
+				!in_pool(ie.original_offset, ie.original_size) ||
+				!in_pool(ie.translation_offset, ie.translation_size)) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
 // Returns success
@@ -779,6 +1039,8 @@ bool Dictionary::FromPo(Dictionary& res, std::istream& in)
 			}
 		}
 	}
+
+	res.Compile();
 	return !error;
 }
 
@@ -23,13 +23,17 @@
 #include <sstream>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "filefinder.h"
+#include "string_view.h"
 
 namespace lcf {
 	namespace rpg {
 		class Map;
 		class EventCommand;
+		class EventPage;
 	}
 	class DBString;
 }
@@ -75,6 +79,9 @@ public:
 
 /**
  * A .po file loaded into memory. Contains a dictionary of entries.
+ * The entries are stored in a single string pool and looked up by a hash of
+ * context and original string, the compiled form can be written to and read
+ * from a binary stream.
  */
 class Dictionary {
 public:
@@ -89,6 +96,32 @@ public:
 	 */
 	static bool FromPo(Dictionary& res, std::istream& in);
 
+	/**
+	 * Loads a dictionary written by ToBinary.
+	 *
+	 * @param res The dictionary to store the translated entries in.
+	 * @param in The stream to load the compiled dictionary from.
+	 * @return True if the dictionary was loaded without error; false otherwise.
+	 */
+	static bool FromBinary(Dictionary& res, std::istream& in);
+
+	/**
+	 * Writes the compiled dictionary.
+	 *
+	 * @param out The stream to write to.
+	 */
+	void ToBinary(std::ostream& out) const;
+
+	/**
+	 * Looks up the translation of a string.
+	 *
+	 * @param context The 'context' of this string, "" for no context.
+	 * @param original The string to lookup.
+	 * @param translation Set to the translated string when found.
+	 * @return True if a translation was found; false otherwise.
+	 */
+	bool Find(StringView context, StringView original, StringView& translation) const;
+
 	/**
 	 * Replace an original string with the translated string.
 	 * Template can be "std::string" or "lcf::DBString"
@@ -99,9 +132,22 @@ public:
 	 * @return True if the original string was replaced; false otherwise.
 	 */
 	template <class StringType>
-	bool TranslateString(const std::string& context, StringType& original) const;
+	bool TranslateString(StringView context, StringType& original) const;
+
+	/** @return Number of entries in the dictionary */
+	size_t GetEntryCount() const;
 
 private:
+	struct IndexEntry {
+		uint64_t hash;
+		uint32_t context_offset;
+		uint32_t context_size;
+		uint32_t original_offset;
+		uint32_t original_size;
+		uint32_t translation_offset;
+		uint32_t translation_size;
+	};
+
 	/**
 	 * Add an entry to the dictionary.
 	 *
@@ -109,28 +155,39 @@ private:
 	 */
 	void addEntry(const Entry& entry);
 
-	// Lookup by context, where context can be empty ("") for no context.
-	std::unordered_map<std::string, std::unordered_map<std::string, std::string>> entries;
+	/** Sorts the index by hash after all entries were added */
+	void Compile();
+
+	/** @return string of the pool at the given offset */
+	StringView GetString(uint32_t offset, uint32_t size) const;
+
+	static uint64_t Hash(StringView context, StringView original);
+
+	std::string pool;
+	std::vector<IndexEntry> index;
 };
 
 
 // Template implementation
 template <class StringType>
-bool Dictionary::TranslateString(const std::string& context, StringType& original) const
+bool Dictionary::TranslateString(StringView context, StringType& original) const
 {
-	std::stringstream key;
-	key <<original;
-	auto it = entries.find(context);
-	if (it != entries.end()) {
-		auto it2 = it->second.find(key.str());
-		if (it2 != it->second.end()) {
-			original = StringType(it2->second);
-			return true;
-		}
+	StringView translation;
+	if (Find(context, StringView(original), translation)) {
+		original = StringType(ToString(translation));
+		return true;
 	}
 	return false;
 }
 
+inline size_t Dictionary::GetEntryCount() const {
+	return index.size();
+}
+
+inline StringView Dictionary::GetString(uint32_t offset, uint32_t size) const {
+	return StringView(pool.data() + offset, size);
+}
+
 
 /**
  * Properties of a language
@@ -182,12 +239,26 @@ public:
 	void SelectLanguage(const std::string& lang_id);
 
 	/**
-	 * Rewrite all Messages and Choices in this Map
+	 * Selects the dictionary used for the Messages and Choices of the current map.
+	 * The event pages are rewritten by RewriteEventPageMessages when they are used.
 	 *
 	 * @param map_name The name of the map with formatting similar to the .po file; e.g., "map0104.po"
-	 * @param map The map object itself (for modifying).
 	 */
-	void RewriteMapMessages(const std::string& map_name, lcf::rpg::Map& map);
+	void SelectMapMessages(const std::string& map_name);
+
+	/**
+	 * @return True if the current map has a dictionary for its messages; false otherwise
+	 */
+	bool HasMapMessages() const;
+
+	/**
+	 * Rewrite all Messages and Choices of an event page of the current map.
+	 * Every page is only rewritten once after SelectMapMessages.
+	 *
+	 * @param event_id ID of the event
+	 * @param page The event page (for modifying).
+	 */
+	void RewriteEventPageMessages(int event_id, lcf::rpg::EventPage& page);
 
 	/**
 	 * Retrieve the ID of the current (active) language.
@@ -210,11 +281,29 @@ private:
 
 	/**
 	 * Parse a .po file and save its language-related strings.
+	 * When the compiled cache contains the file with the same size and CRC
+	 * the compiled dictionary is used instead.
 	 *
 	 * @param is Handle to a Po file to read.
+	 * @param name Filename of the Po file (cache key).
 	 * @param out The Dictionary to save these entries in (output).
 	 */
-	void ParsePoFile(Filesystem_Stream::InputStream is, Dictionary& out);
+	void ParsePoFile(Filesystem_Stream::InputStream is, const std::string& name, Dictionary& out);
+
+	/**
+	 * Read the compiled dictionaries of a language from the save directory.
+	 *
+	 * @param lang_id The ID of the language
+	 */
+	void ReadCompiledCache(const std::string& lang_id);
+
+	/**
+	 * Write the compiled dictionaries of a language to the save directory
+	 * when a .po file was parsed.
+	 *
+	 * @param lang_id The ID of the language
+	 */
+	void WriteCompiledCache(const std::string& lang_id);
 
 	/**
 	 * Parse all .po files for the given language.
@@ -274,6 +363,23 @@ private:
 	std::unique_ptr<Dictionary> mapnames;  // RPG_RT.lmt.po (map names, used only in the "Teleport" event command)
 	std::unordered_map<std::string, std::unique_ptr<Dictionary>> maps;  // map<id>.po, indexed by map name
 
+	// Dictionary of the current map and the event pages (event id << 16 | page id) already rewritten with it.
+	const Dictionary* map_dict = nullptr;
+	std::unordered_set<uint32_t> rewritten_pages;
+
+	// Compiled .po files of a language, indexed by file name.
+	// Only used while the language files are parsed.
+	struct CompiledPo {
+		int64_t size = 0;
+		uint32_t crc = 0;
+		std::streamoff offset = 0;
+		const Dictionary* dict = nullptr;
+	};
+	Filesystem_Stream::InputStream compiled_cache;
+	std::unordered_map<std::string, CompiledPo> compiled_cache_index;
+	std::vector<std::pair<std::string, CompiledPo>> compiled_pos;
+	bool compiled_dirty = false;
+
 	// Our list of available Languages (translations, localizations), determined by scanning the files on disk.
 	std::vector<Language> languages;
 
@@ -284,4 +390,8 @@ private:
 	std::string current_language;
 };
 
+inline bool Translation::HasMapMessages() const {
+	return map_dict != nullptr;
+}
+
 #endif  // EP_TRANSLATION_H
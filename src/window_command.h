@@ -78,6 +78,7 @@ public:
 protected:
 	std::vector<std::string> commands;
 
+	using Window_Selectable::DrawItem;
 	void DrawItem(int index, Font::SystemColor color);
 };
 
@@ -45,7 +45,7 @@ public:
 	 *
 	 * @param index index of item to draw.
 	 */
-	void DrawItem(int index);
+	void DrawItem(int index) override;
 
 	void DrawErrorText();
 
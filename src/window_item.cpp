@@ -29,6 +29,7 @@
 Window_Item::Window_Item(int ix, int iy, int iwidth, int iheight) :
 	Window_Selectable(ix, iy, iwidth, iheight) {
 	column_max = 2;
+	SetVirtualized(true);
 }
 
 const lcf::rpg::Item* Window_Item::GetItem() const {
@@ -98,9 +99,7 @@ void Window_Item::Refresh() {
 
 	contents->Clear();
 
-	for (int i = 0; i < item_max; ++i) {
-		DrawItem(i);
-	}
+	DrawItems();
 }
 
 void Window_Item::DrawItem(int index) {
@@ -23,13 +23,61 @@
 #include "bitmap.h"
 
 constexpr int arrow_animation_frames = 20;
+/** Rows drawn above and below the page of a virtualized window */
+constexpr int virtualized_margin_rows = 4;
 
 // Constructor
 Window_Selectable::Window_Selectable(int ix, int iy, int iwidth, int iheight) :
 	Window_Base(ix, iy, iwidth, iheight) { }
 
 void Window_Selectable::CreateContents() {
-	SetContents(Bitmap::Create(width - 16, max(height - 16, GetRowMax() * 16)));
+	if (!virtualized) {
+		SetContents(Bitmap::Create(width - 16, max(height - 16, GetRowMax() * 16)));
+		return;
+	}
+
+	int top_row = GetTopRow();
+	int rows = min(GetRowMax(), GetPageRowMax() + virtualized_margin_rows * 2);
+	SetContents(Bitmap::Create(width - 16, max(height - 16, rows * 16)));
+
+	// Position the new contents around the old top row, the caller draws them
+	if (top_row > GetRowMax() - 1) top_row = GetRowMax() - 1;
+	if (top_row < 0) top_row = 0;
+	contents_top_row = max(0, min(top_row - virtualized_margin_rows, GetRowMax() - rows));
+	SetOy((top_row - contents_top_row) * 16);
+}
+
+void Window_Selectable::SetVirtualized(bool state) {
+	virtualized = state;
+}
+
+void Window_Selectable::DrawItem(int) {
+}
+
+void Window_Selectable::DrawItems() {
+	int rows = contents->GetHeight() / 16;
+	int end = min(item_max, (contents_top_row + rows) * column_max);
+	for (int i = contents_top_row * column_max; i < end; ++i) {
+		DrawItem(i);
+	}
+}
+
+void Window_Selectable::ScrollContents(int row) {
+	if (!contents) {
+		SetOy(row * 16);
+		return;
+	}
+
+	int rows = contents->GetHeight() / 16;
+	int page_end = min(row + GetPageRowMax(), GetRowMax());
+
+	if (row < contents_top_row || page_end > contents_top_row + rows) {
+		contents_top_row = max(0, min(row - virtualized_margin_rows, GetRowMax() - rows));
+		contents->Clear();
+		DrawItems();
+	}
+
+	SetOy((row - contents_top_row) * 16);
 }
 
 // Properties
@@ -48,11 +96,15 @@ int Window_Selectable::GetRowMax() const {
 	return (item_max + column_max - 1) / column_max;
 }
 int Window_Selectable::GetTopRow() const {
-	return oy / 16;
+	return contents_top_row + oy / 16;
 }
 void Window_Selectable::SetTopRow(int row) {
 	if (row < 0) row = 0;
 	if (row > GetRowMax() - 1) row = GetRowMax() - 1;
+	if (virtualized) {
+		ScrollContents(row);
+		return;
+	}
 	SetOy(row * 16);
 }
 int Window_Selectable::GetPageRowMax() const {
@@ -67,7 +119,7 @@ Rect Window_Selectable::GetItemRect(int index) {
 	rect.width = (width / column_max - 16);
 	rect.x = (index % column_max * (rect.width + 16));
 	rect.height = 12;
-	rect.y = index / column_max * 16 + 2;
+	rect.y = (index / column_max - contents_top_row) * 16 + 2;
 	return rect;
 }
 
@@ -106,7 +158,7 @@ void Window_Selectable::UpdateCursorRect() {
 	cursor_width = (width / column_max - 16) + 8;
 	x = (index % column_max * (cursor_width + 8)) - 4;
 
-	int y = index / column_max * 16 - oy;
+	int y = (row - contents_top_row) * 16 - oy;
 	SetCursorRect(Rect(x, y, cursor_width, 16));
 }
 
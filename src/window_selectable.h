@@ -52,6 +52,33 @@ public:
 	 */
 	Rect GetItemRect(int index);
 
+	/**
+	 * Draws the item at index into the contents.
+	 * Called by DrawItems for every item which is in the contents.
+	 *
+	 * @param index index of item.
+	 */
+	virtual void DrawItem(int index);
+
+	/**
+	 * Draws all items which are in the contents.
+	 * For a virtualized window these are only the visible items and a margin.
+	 */
+	void DrawItems();
+
+	/**
+	 * Enables virtualized rendering. The contents only cover the visible rows
+	 * and a margin instead of the whole list. When the window scrolls out of
+	 * the contents they are moved and redrawn with DrawItem.
+	 * Must be called before the contents are created.
+	 *
+	 * @param state true to enable, false to disable (default).
+	 */
+	void SetVirtualized(bool state);
+
+	/** @return whether virtualized rendering is enabled */
+	bool IsVirtualized() const;
+
 	/**
 	 * Function called by the base UpdateHelp() implementation.
 	 * Passes in the Help Window and the current selected index
@@ -83,6 +110,14 @@ public:
 protected:
 	void UpdateArrows();
 
+	/**
+	 * Scrolls to a row and moves the contents of a virtualized window when
+	 * the page is not inside of them.
+	 *
+	 * @param row new top row
+	 */
+	void ScrollContents(int row);
+
 	Window_Help* help_window = nullptr;
 	int item_max = 1;
 	int column_max = 1;
@@ -90,6 +125,14 @@ protected:
 	int arrow_frame = 0;
 
 	bool endless_scrolling = true;
+
+	bool virtualized = false;
+	/** First row drawn into the contents, always 0 when not virtualized */
+	int contents_top_row = 0;
 };
 
+inline bool Window_Selectable::IsVirtualized() const {
+	return virtualized;
+}
+
 #endif
@@ -34,6 +34,7 @@ Window_ShopBuy::Window_ShopBuy(const std::vector<int>& goods,
 {
 	index = 0;
 	item_max = data.size();
+	SetVirtualized(true);
 }
 
 int Window_ShopBuy::GetItemId() {
@@ -51,9 +52,7 @@ void Window_ShopBuy::Refresh() {
 	Rect rect(0, 0, contents->GetWidth(), contents->GetHeight());
 	contents->Clear();
 
-	for (size_t i = 0; i < data.size(); ++i) {
-		DrawItem(i);
-	}
+	DrawItems();
 }
 
 void Window_ShopBuy::DrawItem(int index) {
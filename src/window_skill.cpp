@@ -32,6 +32,7 @@
 Window_Skill::Window_Skill(int ix, int iy, int iwidth, int iheight) :
 	Window_Selectable(ix, iy, iwidth, iheight), actor_id(-1), subset(0) {
 	column_max = 2;
+	SetVirtualized(true);
 }
 
 void Window_Skill::SetActor(int actor_id) {
@@ -66,9 +67,7 @@ void Window_Skill::Refresh() {
 
 	contents->Clear();
 
-	for (int i = 0; i < item_max; ++i) {
-		DrawItem(i);
-	}
+	DrawItems();
 }
 
 void Window_Skill::DrawItem(int index) {
@@ -57,7 +57,7 @@ public:
 	 *
 	 * @param index index of skill to draw.
 	 */
-	void DrawItem(int index);
+	void DrawItem(int index) override;
 
 	/**
 	 * Updates the help window.
@@ -76,6 +76,18 @@ void Window_VarList::DrawItemValue(int index){
 				contents->TextDraw(GetWidth() - 16, 16 * index + 2, font, std::to_string(value), Text::AlignRight);
 			}
 			break;
+		case eMemory:
+			{
+				const auto& stats = memory_stats[first_var + index - 1];
+				auto value = MemoryStats::FormatBytes(stats.bytes);
+				auto lookups = stats.hits + stats.misses;
+				if (lookups > 0) {
+					value += " " + std::to_string(stats.hits * 100 / lookups) + "%";
+				}
+				DrawItem(index, Font::ColorDefault);
+				contents->TextDraw(GetWidth() - 16, 16 * index + 2, Font::ColorDefault, value, Text::AlignRight);
+			}
+			break;
 		case eTroop:
 		case eMap:
 		case eHeal:
@@ -100,6 +112,9 @@ void Window_VarList::UpdateList(int first_value){
 				[](const lcf::rpg::MapInfo& l, int r) { return l.ID < r; });
 		map_idx = iter - lcf::Data::treemap.maps.begin();
 	}
+	if (mode == eMemory) {
+		memory_stats = MemoryStats::Collect();
+	}
 	for (int i = 0; i < 10; i++){
 		if (!DataIsValid(first_var+i)) {
 			continue;
@@ -142,6 +157,12 @@ void Window_VarList::UpdateList(int first_value){
 			case eMapEvent:
 				ss << Game_Map::GetEvent(first_value+i)->GetName();
 				break;
+			case eMemory:
+				{
+					const auto& stats = memory_stats[first_value + i - 1];
+					ss << stats.name << " (" << stats.entries << ")";
+				}
+				break;
 			default:
 				break;
 		}
@@ -173,6 +194,8 @@ bool Window_VarList::DataIsValid(int range_index) {
 			return range_index > 0 && range_index <= static_cast<int>(lcf::Data::commonevents.size());
 		case eMapEvent:
 			return Game_Map::GetEvent(range_index) != nullptr;
+		case eMemory:
+			return range_index > 0 && range_index <= static_cast<int>(memory_stats.size());
 		default:
 			break;
 	}
@@ -20,6 +20,7 @@
 
 // Headers
 #include "window_command.h"
+#include "memory_stats.h"
 
 class Window_VarList : public Window_Command
 {
@@ -34,6 +35,7 @@ public:
 		eHeal,
 		eCommonEvent,
 		eMapEvent,
+		eMemory,
 	};
 
 	/**
@@ -80,6 +82,9 @@ private:
 	Mode mode = eNone;
 	int first_var = 0;
 
+	/** Memory usage shown in eMemory mode, collected by UpdateList */
+	std::vector<MemoryStats::Stats> memory_stats;
+
 	bool DataIsValid(int range_index);
 
 };
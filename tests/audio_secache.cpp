@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "audio_decoder.h"
+#include "audio_secache.h"
+#include "filesystem_stream.h"
+#include "system.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("AudioSeCache");
+
+#if defined(WANT_FASTWAV) || defined(HAVE_LIBSNDFILE)
+
+namespace {
+
+constexpr int frequency = 22050;
+constexpr int samples = 1000;
+constexpr size_t sample_bytes = samples * 2;
+
+void Put16(std::vector<uint8_t>& out, uint16_t v) {
+	out.push_back(v & 0xFF);
+	out.push_back(v >> 8);
+}
+
+void Put32(std::vector<uint8_t>& out, uint32_t v) {
+	Put16(out, v & 0xFFFF);
+	Put16(out, v >> 16);
+}
+
+/** 16 bit mono PCM wave file */
+const std::vector<uint8_t>& Wav() {
+	static std::vector<uint8_t> wav;
+	if (!wav.empty()) {
+		return wav;
+	}
+
+	wav.insert(wav.end(), { 'R', 'I', 'F', 'F' });
+	Put32(wav, 36 + sample_bytes);
+	wav.insert(wav.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+	Put32(wav, 16);
+	Put16(wav, 1);
+	Put16(wav, 1);
+	Put32(wav, frequency);
+	Put32(wav, frequency * 2);
+	Put16(wav, 2);
+	Put16(wav, 16);
+	wav.insert(wav.end(), { 'd', 'a', 't', 'a' });
+	Put32(wav, sample_bytes);
+	for (int i = 0; i < samples; ++i) {
+		Put16(wav, static_cast<uint16_t>((i % 100) * 300));
+	}
+	return wav;
+}
+
+Filesystem_Stream::InputStream Open(std::string name) {
+	auto& wav = const_cast<std::vector<uint8_t>&>(Wav());
+	return Filesystem_Stream::InputStream(new Filesystem_Stream::InputMemoryStreamBuf(wav), std::move(name));
+}
+
+bool IsCached(std::string name, int pitch = 100) {
+	auto se = AudioSeCache::Create(Open(std::move(name)), pitch);
+	REQUIRE(se);
+	return se->IsCached();
+}
+
+/** Resets the cache to an output format matching the test sample */
+struct CacheFixture {
+	CacheFixture() {
+		AudioSeCache::SetOutputFormat(frequency, AudioDecoder::Format::S16, 1);
+		AudioSeCache::Clear();
+		AudioSeCache::SetCacheLimit(sample_bytes * 5 / 2);
+	}
+
+	~CacheFixture() {
+		AudioSeCache::SetCacheLimit(3 * 1024 * 1024);
+		AudioSeCache::SetOutputFormat(0, AudioDecoder::Format::S16, 0);
+	}
+};
+
+}
+
+TEST_CASE_FIXTURE(CacheFixture, "EvictLeastRecentlyUsed") {
+	REQUIRE(AudioSeCache::Preload(Open("a")));
+	REQUIRE(AudioSeCache::Preload(Open("b")));
+	CHECK(IsCached("a"));
+	CHECK(IsCached("b"));
+
+	// Cache full: Preloading stops instead of evicting preloaded SEs
+	CHECK(!AudioSeCache::Preload(Open("c")));
+	CHECK(!IsCached("c"));
+	CHECK(IsCached("a"));
+
+	// Playing a evicts b, the least recently used one
+	AudioSeCache::Create(Open("a"))->CreateSeDecoder(100);
+	AudioSeCache::Create(Open("c"))->CreateSeDecoder(100);
+	CHECK(IsCached("a"));
+	CHECK(!IsCached("b"));
+	CHECK(IsCached("c"));
+}
+
+TEST_CASE_FIXTURE(CacheFixture, "KeepPlaying") {
+	auto playing = AudioSeCache::Create(Open("a"))->CreateSeDecoder(100);
+
+	for (int i = 0; i < 100; ++i) {
+		AudioSeCache::Create(Open("se" + std::to_string(i)))->CreateSeDecoder(100);
+	}
+
+	CHECK(IsCached("a"));
+	CHECK(IsCached("se99"));
+	CHECK(!IsCached("se0"));
+}
+
+TEST_CASE_FIXTURE(CacheFixture, "PlayWithoutResampler") {
+	auto se = AudioSeCache::Create(Open("a"));
+	auto dec = se->CreateSeDecoder(100);
+	CHECK(dynamic_cast<AudioSeDecoder*>(dec.get()));
+	CHECK_EQ(se->GetSeData()->buffer.size(), sample_bytes);
+}
+
+#ifdef USE_AUDIO_RESAMPLER
+TEST_CASE_FIXTURE(CacheFixture, "PitchResampledOnce") {
+	auto se = AudioSeCache::Create(Open("a"), 200);
+	auto dec = se->CreateSeDecoder(200);
+
+	// The pitch is applied when caching, playback only mixes
+	CHECK(dynamic_cast<AudioSeDecoder*>(dec.get()));
+	auto data = se->GetSeData();
+	CHECK_EQ(data->pitch, 200);
+	CHECK_EQ(data->frequency, frequency);
+	CHECK(data->buffer.size() > sample_bytes / 2 - 64);
+	CHECK(data->buffer.size() < sample_bytes / 2 + 64);
+
+	// Other pitches are separate entries
+	CHECK(IsCached("a", 200));
+	CHECK(!IsCached("a"));
+	CHECK(!IsCached("a", 150));
+}
+#endif
+
+#endif
+
+TEST_SUITE_END();
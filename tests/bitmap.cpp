@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include "bitmap.h"
+#include "cache.h"
+#include "color.h"
+#include "tone.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Bitmap");
+
+namespace {
+
+struct Effects {
+	double zoom_x = 1.0;
+	double zoom_y = 1.0;
+	double angle = 0.0;
+	int waver_depth = 0;
+	double waver_phase = 0.0;
+	Tone tone;
+	Color flash;
+	bool flip_x = false;
+	bool flip_y = false;
+	Opacity opacity = Opacity::Opaque();
+};
+
+BitmapRef MakeSource() {
+	// Blocks of opaque, half transparent and fully transparent colors
+	auto src = Bitmap::Create(32, 24, true);
+	for (int y = 0; y < src->height(); y += 4) {
+		for (int x = 0; x < src->width(); x += 4) {
+			int i = x / 4 + y;
+			auto alpha = static_cast<uint8_t>(i % 3 == 0 ? 255 : (i % 3 == 1 ? 128 : 0));
+			src->FillRect(Rect(x, y, 4, 4), Color((i * 37) % 256, (i * 91) % 256, (i * 53) % 256, alpha));
+		}
+	}
+	return src;
+}
+
+void Put32(std::vector<uint8_t>& out, uint32_t v) {
+	for (int i = 0; i < 4; ++i) {
+		out.push_back((v >> (i * 8)) & 0xFF);
+	}
+}
+
+/** 8 bit BMP with 256 palette entries, pixel (x, y) has index (x + y * 7) % 256 */
+std::vector<uint8_t> MakeIndexedBmp(int width, int height) {
+	const int stride = (width + 3) & ~3;
+	const uint32_t offset = 14 + 40 + 256 * 4;
+
+	std::vector<uint8_t> bmp = { 'B', 'M' };
+	Put32(bmp, offset + stride * height);
+	Put32(bmp, 0);
+	Put32(bmp, offset);
+	Put32(bmp, 40);
+	Put32(bmp, width);
+	Put32(bmp, height);
+	Put32(bmp, 1 | (8 << 16));
+	for (int i = 0; i < 6; ++i) {
+		Put32(bmp, 0);
+	}
+	for (int i = 0; i < 256; ++i) {
+		bmp.insert(bmp.end(), { uint8_t(i * 3), uint8_t(255 - i), uint8_t(i * 5), 0 });
+	}
+	for (int y = height - 1; y >= 0; --y) {
+		for (int x = 0; x < stride; ++x) {
+			bmp.push_back(x < width ? (x + y * 7) % 256 : 0);
+		}
+	}
+	return bmp;
+}
+
+BitmapRef MakeScreen() {
+	auto dst = Bitmap::Create(80, 80, false);
+	dst->Fill(Color(20, 40, 60, 255));
+	return dst;
+}
+
+// The sprite rect is the whole bitmap, so the effect bitmap has the same
+// coordinates as the source and both paths sample the same pixels.
+void Compare(const Effects& e) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+
+	auto src = MakeSource();
+	const Rect rect = src->GetRect();
+
+	// Old path: Materialize the effects, then transform
+	auto expected = MakeScreen();
+	BitmapRef effect = src;
+	if (e.tone != Tone() || e.flash != Color() || e.flip_x || e.flip_y) {
+		effect = Cache::SpriteEffect(src, rect, e.flip_x, e.flip_y, e.tone, e.flash);
+	}
+	expected->EffectsBlit(40, 40, 16, 12, *effect, rect, e.opacity,
+			e.zoom_x, e.zoom_y, e.angle, e.waver_depth, e.waver_phase);
+
+	auto actual = MakeScreen();
+	REQUIRE(actual->AffineBlit(40, 40, 16, 12, *src, rect, rect, e.opacity,
+			e.zoom_x, e.zoom_y, e.angle, e.waver_depth, e.waver_phase,
+			e.tone, e.flash, e.flip_x, e.flip_y));
+
+	// Tolerance of 1 per channel for the rounding of tone and flash
+	int mismatches = 0;
+	for (int y = 0; y < actual->height(); ++y) {
+		auto* a = static_cast<const uint8_t*>(actual->pixels()) + y * actual->pitch();
+		auto* b = static_cast<const uint8_t*>(expected->pixels()) + y * expected->pitch();
+		for (int x = 0; x < actual->width() * 4; ++x) {
+			if (std::abs(a[x] - b[x]) > 1) {
+				++mismatches;
+			}
+		}
+	}
+	REQUIRE_EQ(mismatches, 0);
+}
+
+}
+
+TEST_CASE("IndexedImageExpand") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+
+	// Wider than the vector loops and not a multiple of their width
+	const int width = 37;
+	const int height = 3;
+	auto bmp = MakeIndexedBmp(width, height);
+	auto bitmap = Bitmap::Create(bmp.data(), bmp.size(), true);
+	REQUIRE(bitmap);
+	REQUIRE_EQ(bitmap->GetRect(), Rect(0, 0, width, height));
+
+	// Palette entry 0 is the transparent color
+	auto expected = Bitmap::Create(width, height, true);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			int i = (x + y * 7) % 256;
+			auto color = i == 0 ? Color(0, 0, 0, 0) : Color(i * 5 % 256, 255 - i, i * 3 % 256, 255);
+			expected->FillRect(Rect(x, y, 1, 1), color);
+		}
+	}
+
+	for (int y = 0; y < height; ++y) {
+		auto* a = static_cast<const uint8_t*>(bitmap->pixels()) + y * bitmap->pitch();
+		auto* b = static_cast<const uint8_t*>(expected->pixels()) + y * expected->pitch();
+		REQUIRE(std::equal(a, a + width * 4, b));
+	}
+}
+
+// Blits from the palette must give the same pixels as pixman compositing
+// the expanded image.
+TEST_CASE("IndexedBlit") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+
+	const int width = 150;
+	const int height = 130;
+	auto bmp = MakeIndexedBmp(width, height);
+
+	Bitmap::SetIndexedStorage(true);
+	auto indexed = Bitmap::Create(bmp.data(), bmp.size(), true, Bitmap::Flag_ReadOnly);
+	Bitmap::SetIndexedStorage(false);
+	auto expanded = Bitmap::Create(bmp.data(), bmp.size(), true, Bitmap::Flag_ReadOnly);
+	REQUIRE(indexed);
+	REQUIRE(expanded);
+	REQUIRE(indexed->IsIndexed());
+	REQUIRE(!expanded->IsIndexed());
+
+	auto blit = [&](int x, int y, const Rect& rect, const Opacity& opacity, bool fast) {
+		BitmapRef a = Bitmap::Create(80, 80, true);
+		BitmapRef b = Bitmap::Create(80, 80, true);
+		for (auto& screen : { a, b }) {
+			screen->Fill(Color(20, 40, 60, 255));
+			screen->FillRect(Rect(10, 10, 30, 30), Color(100, 50, 0, 128));
+		}
+		if (fast) {
+			a->BlitFast(x, y, *indexed, rect, opacity);
+			b->BlitFast(x, y, *expanded, rect, opacity);
+		} else {
+			a->Blit(x, y, *indexed, rect, opacity);
+			b->Blit(x, y, *expanded, rect, opacity);
+		}
+
+		for (int row = 0; row < a->height(); ++row) {
+			auto* pa = static_cast<const uint8_t*>(a->pixels()) + row * a->pitch();
+			auto* pb = static_cast<const uint8_t*>(b->pixels()) + row * b->pitch();
+			REQUIRE(std::equal(pa, pa + a->width() * 4, pb));
+		}
+	};
+
+	for (bool fast : { false, true }) {
+		blit(5, 7, Rect(3, 4, 60, 50), Opacity::Opaque(), fast);
+		blit(-20, -30, Rect(0, 0, width, height), Opacity::Opaque(), fast);
+		blit(50, 60, Rect(100, 90, 50, 40), Opacity::Opaque(), fast);
+	}
+	blit(5, 7, Rect(3, 4, 60, 50), Opacity(128), false);
+	blit(-9, 2, Rect(17, 0, 41, 80), Opacity(1), false);
+	blit(5, 7, Rect(3, 4, 60, 50), Opacity(200, 60, 20), false);
+}
+
+TEST_CASE("AffineBlitZoom") {
+	Effects e;
+	e.zoom_x = 2.0;
+	e.zoom_y = 1.5;
+	Compare(e);
+
+	e.zoom_x = 0.5;
+	e.zoom_y = 0.75;
+	Compare(e);
+}
+
+TEST_CASE("AffineBlitAngle") {
+	Effects e;
+	e.angle = 0.7;
+	Compare(e);
+
+	e.zoom_x = 1.5;
+	e.angle = -2.1;
+	Compare(e);
+}
+
+TEST_CASE("AffineBlitWaver") {
+	Effects e;
+	e.waver_depth = 4;
+	e.waver_phase = 30.0;
+	Compare(e);
+
+	e.zoom_y = 2.0;
+	e.opacity = Opacity(200, 100, 12);
+	Compare(e);
+}
+
+TEST_CASE("AffineBlitTone") {
+	Effects e;
+	e.zoom_x = 2.0;
+	e.tone = Tone(200, 64, 100, 0);
+	Compare(e);
+
+	e.tone = Tone(128, 128, 128, 40);
+	Compare(e);
+}
+
+TEST_CASE("AffineBlitFlash") {
+	Effects e;
+	e.angle = 1.2;
+	e.flash = Color(255, 255, 255, 128);
+	Compare(e);
+
+	e.tone = Tone(50, 200, 128, 128);
+	Compare(e);
+}
+
+TEST_CASE("AffineBlitFlip") {
+	Effects e;
+	e.zoom_x = 1.5;
+	e.flip_x = true;
+	Compare(e);
+
+	e.flip_x = false;
+	e.flip_y = true;
+	e.waver_depth = 2;
+	Compare(e);
+
+	e.flip_x = true;
+	e.angle = 0.3;
+	e.flash = Color(0, 0, 255, 200);
+	Compare(e);
+}
+
+TEST_SUITE_END();
@@ -350,4 +350,43 @@ TEST_CASE("TakeFromPred") {
 	REQUIRE(list2.IsDirty());
 }
 
+TEST_CASE("MovedReinsert") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Bitmap bitmap(16, 16, false);
+
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	// Few distinct Z values to get many ties
+	std::vector<std::unique_ptr<TestSprite>> sprites;
+	for (int i = 0; i < 200; ++i) {
+		sprites.push_back(std::make_unique<TestSprite>((i * 7) % 13));
+		list.Append(sprites.back().get());
+	}
+	list.Draw(bitmap);
+	REQUIRE(list.IsSorted());
+
+	uint32_t seed = 1;
+	auto next = [&seed]() {
+		seed = seed * 1103515245 + 12345;
+		return static_cast<int>((seed >> 16) & 0x7FFF);
+	};
+
+	for (int round = 0; round < 50; ++round) {
+		for (int i = 0; i < 1 + round % 10; ++i) {
+			auto& sprite = sprites[next() % sprites.size()];
+			sprite->SetZ(next() % 13);
+		}
+
+		std::vector<Drawable*> expected(list.begin(), list.end());
+		std::stable_sort(expected.begin(), expected.end(), [](Drawable* l, Drawable* r) { return l->GetZ() < r->GetZ(); });
+
+		list.Draw(bitmap);
+		REQUIRE_FALSE(list.IsDirty());
+		REQUIRE(std::equal(expected.begin(), expected.end(), list.begin(), list.end()));
+	}
+
+	DrawableMgr::SetLocalList(nullptr);
+}
+
 TEST_SUITE_END();
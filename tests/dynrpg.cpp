@@ -106,7 +106,7 @@ TEST_CASE("Arg parse") {
 
 	// 2.5x not tested here because the result differs between different C++ libraries
 	// See: https://bugs.llvm.org/show_bug.cgi?id=17782
-	std::vector<std::string> args = {"A", "1y", "2.5 x"};
+	std::vector<DynRpg::Arg> args = {"A", "1y", "2.5 x"};
 	bool okay = false;
 
 	std::string s, s2;
@@ -185,6 +185,98 @@ TEST_CASE("easyrpg dynrpg invoke") {
 	DynRpg::Invoke("@unknownfunc 1, 2, 3");
 }
 
+TEST_CASE("Cached invoke resolves references") {
+	const MockActor m;
+
+	std::vector<int32_t> vars = {0, 1, 2};
+	Main_Data::game_variables->SetData(vars);
+	Main_Data::game_variables->SetWarning(0);
+
+	DynRpg::Invoke("@easyrpg_add 1, V2, V3");
+	CHECK(Main_Data::game_variables->Get(1) == 3);
+
+	// Same comment again, references are resolved again
+	Main_Data::game_variables->Set(2, 10);
+	DynRpg::Invoke("@easyrpg_add 1, V2, V3");
+	CHECK(Main_Data::game_variables->Get(1) == 12);
+
+	// Not a DynRPG comment
+	CHECK(DynRpg::Invoke("easyrpg_add 1, 2"));
+	CHECK(Main_Data::game_variables->Get(1) == 12);
+}
+
+TEST_CASE("Typed args") {
+	int value = 0;
+	CHECK(DynRpg::Arg("42").GetInt(value));
+	CHECK(value == 42);
+	CHECK(DynRpg::Arg("-2147483648").GetInt(value));
+	CHECK(value == -2147483648LL);
+	CHECK(!DynRpg::Arg("2147483648").GetInt(value));
+	CHECK(!DynRpg::Arg("4x").GetInt(value));
+	CHECK(!DynRpg::Arg("-").GetInt(value));
+	CHECK(!DynRpg::Arg("").GetInt(value));
+	CHECK(DynRpg::Arg("").empty());
+
+	DynRpg::Arg arg("abc");
+	arg.SetInt(-15);
+	CHECK(!arg.empty());
+	CHECK(arg.GetText() == "-15");
+	arg.SetText("7");
+	CHECK(arg.GetInt(value));
+	CHECK(value == 7);
+}
+
+namespace {
+std::vector<std::string> nested_args;
+
+bool NestedFunc(dyn_arg_list args) {
+	int depth;
+	std::string text;
+	std::tie(depth, text) = DynRpg::ParseArgs<int, std::string>("test_nested", args);
+	if (depth > 0) {
+		DynRpg::Invoke("@test_nested " + std::to_string(depth - 1) + ", V" + std::to_string(depth));
+	}
+	// The arguments of the outer call are unchanged by the nested call
+	nested_args.push_back(args[1].GetText());
+	return true;
+}
+}
+
+TEST_CASE("Nested invoke") {
+	const MockActor m;
+
+	// Registers the plugins before the test function
+	DynRpg::Invoke("@easyrpg_add 1, 0");
+	DynRpg::RegisterFunction("test_nested", NestedFunc);
+
+	std::vector<int32_t> vars = {10, 20, 30};
+	Main_Data::game_variables->SetData(vars);
+	Main_Data::game_variables->SetWarning(0);
+
+	nested_args.clear();
+	DynRpg::Invoke("@test_nested 3, abc");
+	REQUIRE(nested_args.size() == 4);
+	CHECK(nested_args[0] == "10");
+	CHECK(nested_args[1] == "20");
+	CHECK(nested_args[2] == "30");
+	CHECK(nested_args[3] == "abc");
+}
+
+TEST_CASE("Many distinct calls") {
+	const MockActor m;
+
+	std::vector<int32_t> vars = {0};
+	Main_Data::game_variables->SetData(vars);
+	Main_Data::game_variables->SetWarning(0);
+
+	for (int i = 0; i < 3000; ++i) {
+		DynRpg::Invoke("@easyrpg_add 1, " + std::to_string(i));
+		REQUIRE(Main_Data::game_variables->Get(1) == i);
+	}
+	DynRpg::Invoke("@easyrpg_add 1, 1, 2");
+	CHECK(Main_Data::game_variables->Get(1) == 3);
+}
+
 TEST_CASE("Incompatible changes") {
 	const MockActor m; // disable log
 
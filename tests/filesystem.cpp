@@ -88,4 +88,24 @@ TEST_CASE("FindFile") {
 	Player::escape_symbol = "";
 }
 
+TEST_CASE("FindFileIndexed") {
+	auto fs = FileFinder::Root().Subtree(EP_TEST_PATH "/game");
+
+	auto name = [](const std::string& file) {
+		return std::get<1>(FileFinder::GetPathAndFilename(file));
+	};
+
+	auto IMG_TYPES = Utils::MakeSvArray(".bmp",  ".png", ".xyz");
+
+	// The first search lists the directory, the further ones use the index
+	for (int i = 0; i < 3; ++i) {
+		CHECK(name(fs.FindFile({ "Charset/chara1", IMG_TYPES })) == "chara1.png");
+		CHECK(name(fs.FindFile({ "Charset/CHARA1", IMG_TYPES })) == "chara1.png");
+		CHECK(name(fs.FindFile("Charset/CharA1.PNG")) == "chara1.png");
+		CHECK(fs.FindFile({ "Charset/chara2", IMG_TYPES }).empty());
+		CHECK(fs.FindFile({ "Charset/chara1", Utils::MakeSvArray(".PNG") }).empty());
+		CHECK(name(fs.FindFile({ "Charset/../exfont", IMG_TYPES, 1 })) == "ExFont.png");
+	}
+}
+
 TEST_SUITE_END();
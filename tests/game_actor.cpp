@@ -273,6 +273,66 @@ TEST_CASE("AdjParams") {
 	}
 }
 
+TEST_CASE("CachedStats") {
+	const MockActor m;
+	auto actor = MakeActor(1, 1, 99, 100, 10, 11, 12, 13, 14);
+
+	REQUIRE_EQ(actor.GetAtk(), 11);
+	REQUIRE_EQ(actor.GetAgi(), 14);
+
+	MakeDBEquip(1, lcf::rpg::Item::Type_weapon, 5, 6, 7, 8);
+	actor.SetEquipment(1, 1);
+	REQUIRE_EQ(actor.GetAtk(), 16);
+	REQUIRE_EQ(actor.GetAtk(Game_Battler::WeaponNone), 11);
+	REQUIRE_EQ(actor.GetAgi(), 22);
+
+	auto& state = lcf::Data::states[1];
+	state.affect_attack = true;
+	state.affect_type = lcf::rpg::State::AffectType_double;
+
+	actor.AddState(2, true);
+	REQUIRE_EQ(actor.GetAtk(), 32);
+	REQUIRE_EQ(actor.GetAgi(), 22);
+
+	actor.RemoveState(2, true);
+	REQUIRE_EQ(actor.GetAtk(), 16);
+
+	actor.SetEquipment(1, 0);
+	REQUIRE_EQ(actor.GetAtk(), 11);
+}
+
+TEST_CASE("StateFlags") {
+	const MockActor m;
+	auto actor = MakeActor(1, 1, 99, 100, 10, 11, 12, 13, 14);
+
+	lcf::Data::states[1].restriction = lcf::rpg::State::Restriction_attack_ally;
+	lcf::Data::states[2].restriction = lcf::rpg::State::Restriction_do_nothing;
+	lcf::Data::states[2].auto_release_prob = 0;
+	lcf::Data::states[3].reflect_magic = true;
+	StateSet::LoadFlagTable();
+
+	REQUIRE(actor.CanAct());
+	REQUIRE_FALSE(actor.HasReflectState());
+	REQUIRE_EQ(actor.GetSignificantRestriction(), lcf::rpg::State::Restriction_normal);
+
+	actor.AddState(2, true);
+	REQUIRE(actor.CanAct());
+	REQUIRE_EQ(actor.GetSignificantRestriction(), lcf::rpg::State::Restriction_attack_ally);
+
+	actor.AddState(3, true);
+	REQUIRE_FALSE(actor.CanAct());
+	REQUIRE_FALSE(actor.CanActOrRecoverable());
+	REQUIRE_EQ(actor.GetSignificantRestriction(), lcf::rpg::State::Restriction_do_nothing);
+
+	actor.AddState(4, true);
+	REQUIRE(actor.HasReflectState());
+	REQUIRE_EQ(actor.GetInflictedStates(), std::vector<int16_t>{2, 3, 4});
+
+	actor.RemoveState(3, true);
+	REQUIRE(actor.CanAct());
+	REQUIRE_EQ(actor.GetInflictedStates(), std::vector<int16_t>{2, 4});
+}
+
 TEST_CASE("TryEquip") {
 	const MockActor m;
 	auto actor = MakeActor(1, 1, 99, 100, 10, 11, 12, 13, 14);
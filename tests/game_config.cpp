@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "filefinder.h"
+#include "game_config.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Config");
+
+namespace {
+
+std::string TempPath() {
+#ifdef _WIN32
+	const char* tmp = std::getenv("TEMP");
+#else
+	const char* tmp = std::getenv("TMPDIR");
+#endif
+	return FileFinder::MakePath(tmp ? tmp : "/tmp", "easyrpg_test_config.ini");
+}
+
+std::string Write(const Game_Config& cfg) {
+	const auto path = TempPath();
+	cfg.WriteToConfig(path);
+
+	std::ifstream is(path);
+	std::stringstream ss;
+	ss << is.rdbuf();
+	is.close();
+	std::remove(path.c_str());
+	return ss.str();
+}
+
+}
+
+TEST_CASE("AudioDefaultsNotWritten") {
+	Game_Config cfg;
+	CHECK_EQ(Write(cfg).find("[audio]"), std::string::npos);
+}
+
+TEST_CASE("AudioRoundTrip") {
+	const auto path = TempPath();
+
+	Game_Config cfg;
+	REQUIRE(cfg.audio.se_cache_size.Set(8));
+	CHECK_NE(Write(cfg).find("[audio]\nse-cache-size=8\n"), std::string::npos);
+
+	cfg.WriteToConfig(path);
+	Game_Config loaded;
+	loaded.LoadFromConfig(path);
+	std::remove(path.c_str());
+	CHECK_EQ(loaded.audio.se_cache_size.Get(), 8);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <vector>
+#include "game_pictures.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Pictures");
+
+namespace {
+
+constexpr int num_pics = 40;
+
+/** Small deterministic generator, the sequence must not depend on the platform */
+struct Lcg {
+	uint32_t state;
+
+	int operator()(int n) {
+		state = state * 1664525u + 1013904223u;
+		return static_cast<int>((state >> 8) % static_cast<uint32_t>(n));
+	}
+};
+
+template <typename P>
+void RandomParams(Lcg& rng, P& p) {
+	p.position_x = rng(640) - 160;
+	p.position_y = rng(480) - 120;
+	p.magnify = rng(400);
+	p.top_trans = rng(101);
+	p.bottom_trans = rng(101);
+	p.red = rng(201);
+	p.green = rng(201);
+	p.blue = rng(201);
+	p.saturation = rng(201);
+	// Effects are not part of the motion arrays
+	p.effect_mode = 0;
+	p.effect_power = 0;
+}
+
+/** The 9 interpolated fields as in Game_Pictures::Motion */
+std::vector<double> Current(const lcf::rpg::SavePicture& d) {
+	return { d.current_x, d.current_y, d.current_red, d.current_green, d.current_blue,
+		d.current_sat, d.current_magnify, d.current_top_trans, d.current_bot_trans };
+}
+
+std::vector<double> Finish(const lcf::rpg::SavePicture& d) {
+	return { d.finish_x, d.finish_y, d.finish_red, d.finish_green, d.finish_blue,
+		d.finish_sat, d.finish_magnify, d.finish_top_trans, d.finish_bot_trans };
+}
+
+}
+
+// Each update must give the same result as the per picture interpolation
+// (finish - current) / (time_left + 1) + current, no matter how pictures
+// enter and leave the motion arrays.
+TEST_CASE("MotionMatchesPerPictureInterpolation") {
+	Game_Pictures pictures;
+	Lcg rng = { 12345 };
+
+	int checked = 0;
+	for (int step = 0; step < 3000; ++step) {
+		const int id = 1 + rng(num_pics);
+		switch (rng(8)) {
+			case 0: {
+				Game_Pictures::ShowParams show = {};
+				RandomParams(rng, show);
+				show.fixed_to_map = rng(2) == 0;
+				pictures.Show(id, show);
+				break;
+			}
+			case 1:
+			case 2: {
+				Game_Pictures::MoveParams move = {};
+				RandomParams(rng, move);
+				move.duration = rng(30);
+				pictures.Move(id, move);
+				break;
+			}
+			case 3:
+				pictures.Erase(id);
+				break;
+			case 4:
+				pictures.OnMapScrolled(rng(64) - 32, rng(64) - 32);
+				break;
+			case 5:
+				if (rng(20) == 0) {
+					pictures.SetSaveData(pictures.GetSaveData());
+				}
+				break;
+		}
+
+		const auto before = pictures.GetSaveData();
+		pictures.Update(false);
+		const auto after = pictures.GetSaveData();
+
+		for (size_t i = 0; i < before.size() && i < after.size(); ++i) {
+			const auto& b = before[i];
+			const auto& a = after[i];
+			if (b.map_layer <= 0 || b.time_left == 0) {
+				continue;
+			}
+			if (a.time_left == b.time_left) {
+				// Moved but never shown: Not updated
+				REQUIRE_EQ(Current(a), Current(b));
+				continue;
+			}
+
+			const auto cur = Current(b);
+			const auto fin = Finish(a);
+			std::vector<double> expected(cur.size());
+			for (size_t f = 0; f < cur.size(); ++f) {
+				expected[f] = a.time_left > 0
+					? (fin[f] - cur[f]) / static_cast<double>(a.time_left + 1) + cur[f]
+					: fin[f];
+			}
+			REQUIRE_EQ(Current(a), expected);
+			++checked;
+		}
+	}
+
+	CHECK(checked > 1000);
+}
+
+TEST_SUITE_END();
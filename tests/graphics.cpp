@@ -0,0 +1,84 @@
+#include <vector>
+#include "audio.h"
+#include "baseui.h"
+#include "bitmap.h"
+#include "drawable_list.h"
+#include "drawable_mgr.h"
+#include "game_config.h"
+#include "graphics.h"
+#include "transition.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Graphics");
+
+namespace {
+
+class TestUi : public BaseUi {
+public:
+	TestUi(int width, int height) : BaseUi(Game_ConfigVideo()) {
+		Resize(width, height);
+	}
+
+	/** Recreates the display surface like a display mode change does */
+	void Resize(int width, int height) {
+		main_surface = Bitmap::Create(width, height, Color(0, 0, 0, 255));
+	}
+
+	void ToggleFullscreen() override {}
+	void ToggleZoom() override {}
+	void ProcessEvents() override {}
+	void UpdateDisplay() override {
+		presented.push_back(main_surface->GetRect());
+	}
+	void SetTitle(const std::string&) override {}
+	bool ShowCursor(bool) override { return false; }
+#ifdef SUPPORT_AUDIO
+	AudioInterface& GetAudio() override { return audio; }
+	EmptyAudio audio;
+#endif
+	bool IsDisplaySurfaceSwappable() const override { return true; }
+
+	std::vector<Rect> presented;
+};
+
+}
+
+TEST_CASE("PipelinedResize") {
+	auto ui = std::make_shared<TestUi>(320, 240);
+	DisplayUi = ui;
+
+	// The transition registers itself to the drawables of the current scene
+	static DrawableList transition_drawables;
+	DrawableMgr::SetLocalList(&transition_drawables);
+	REQUIRE(!Transition::instance().IsActive());
+	DrawableList drawables;
+	DrawableMgr::SetLocalList(&drawables);
+
+	Graphics::SetPipelined(true);
+	REQUIRE(Graphics::IsPipelined());
+
+	Graphics::DrawPipelined();
+	REQUIRE_EQ(DisplayUi->GetDisplaySurface()->GetRect(), Rect(0, 0, 320, 240));
+
+	ui->Resize(416, 240);
+	Graphics::DrawPipelined();
+	REQUIRE_EQ(DisplayUi->GetDisplaySurface()->GetRect(), Rect(0, 0, 416, 240));
+	Graphics::DrawPipelined();
+	REQUIRE_EQ(DisplayUi->GetDisplaySurface()->GetRect(), Rect(0, 0, 416, 240));
+
+	ui->Resize(320, 240);
+	Graphics::DrawPipelined();
+	REQUIRE_EQ(DisplayUi->GetDisplaySurface()->GetRect(), Rect(0, 0, 320, 240));
+
+	REQUIRE_EQ(ui->presented.size(), 4u);
+	CHECK_EQ(ui->presented[0], Rect(0, 0, 320, 240));
+	CHECK_EQ(ui->presented[1], Rect(0, 0, 416, 240));
+	CHECK_EQ(ui->presented[2], Rect(0, 0, 416, 240));
+	CHECK_EQ(ui->presented[3], Rect(0, 0, 320, 240));
+
+	Graphics::SetPipelined(false);
+	DrawableMgr::SetLocalList(nullptr);
+	DisplayUi.reset();
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "image_bmp.h"
+#include "image_out.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("ImageBMP");
+
+namespace {
+// 4x2 8 bit BMP, palette entry 1 duplicates the transparent color at #0
+const uint8_t bmp_dup_key[] = {
+	// BITMAPFILEHEADER
+	'B', 'M', 78, 0, 0, 0, 0, 0, 0, 0, 70, 0, 0, 0,
+	// BITMAPINFOHEADER
+	40, 0, 0, 0, 4, 0, 0, 0, 2, 0, 0, 0, 1, 0, 8, 0,
+	0, 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	4, 0, 0, 0, 0, 0, 0, 0,
+	// Palette (BGRX)
+	255, 0, 255, 0,
+	255, 0, 255, 0,
+	0, 255, 0, 0,
+	255, 0, 0, 0,
+	// Pixels, bottom-up
+	0, 1, 2, 3,
+	1, 0, 3, 2
+};
+
+std::vector<uint8_t> Read(const uint8_t* data, unsigned len) {
+	ImageOut image;
+	REQUIRE(ImageBMP::ReadBMP(data, len, true, image));
+	REQUIRE_EQ(image.width, 4);
+	REQUIRE_EQ(image.height, 2);
+	REQUIRE(image.indexed);
+
+	// Expand the indices to RGBA like the Bitmap does
+	auto* indices = static_cast<uint8_t*>(image.pixels);
+	std::vector<uint8_t> result;
+	for (int i = 0; i < image.width * image.height; ++i) {
+		const uint8_t* color = image.palette[indices[i]];
+		result.insert(result.end(), color, color + 4);
+	}
+	free(image.pixels);
+	return result;
+}
+}
+
+TEST_CASE("DuplicateKeyColor") {
+	std::vector<uint8_t> data(bmp_dup_key, bmp_dup_key + sizeof(bmp_dup_key));
+
+	// The input is left untouched, it can be a read-only memory mapping
+	auto first = Read(data.data(), data.size());
+	REQUIRE(std::memcmp(data.data(), bmp_dup_key, sizeof(bmp_dup_key)) == 0);
+
+	auto second = Read(data.data(), data.size());
+	REQUIRE(first == second);
+
+	// Top row is 1 0 3 2: The duplicate stays opaque and differs from the key
+	const uint8_t* dup = &first[0];
+	const uint8_t* key = &first[4];
+	REQUIRE_EQ(dup[3], 255);
+	REQUIRE_EQ(key[3], 0);
+	REQUIRE(std::memcmp(dup, key, 3) != 0);
+}
+
+TEST_SUITE_END();
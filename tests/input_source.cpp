@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include "input_source.h"
+#include "drawable_list.h"
+#include "drawable_mgr.h"
+#include "filefinder.h"
+#include "game_system.h"
+#include "game_targets.h"
+#include "main_data.h"
+#include "mock_game.h"
+#include "scene.h"
+#include "transition.h"
+#include <lcf/lsd/reader.h>
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("InputSource");
+
+namespace {
+
+class RecordSource : public Input::Source {
+public:
+	RecordSource() : Source(Input::GetDefaultButtonMappings(), Input::GetDefaultDirectionMappings()) {}
+
+	void Update() override {
+		Record();
+	}
+	void UpdateSystem() override {}
+
+	void SetButtons(const std::bitset<Input::BUTTON_COUNT>& buttons) {
+		pressed_buttons = buttons;
+	}
+};
+
+/** Buttons of the recording, two timelines share the frames 2000 to 5000 */
+std::bitset<Input::BUTTON_COUNT> Buttons(int frame, bool rewound) {
+	std::bitset<Input::BUTTON_COUNT> buttons;
+	buttons[Input::DECISION] = (frame / 7) % 2 == 0;
+	buttons[Input::UP] = frame % 1000 < 10;
+	buttons[Input::CANCEL] = rewound && frame % 3 == 0;
+	return buttons;
+}
+
+std::string TempPath() {
+#ifdef _WIN32
+	const char* tmp = std::getenv("TEMP");
+#else
+	const char* tmp = std::getenv("TMPDIR");
+#endif
+	return FileFinder::MakePath(tmp ? tmp : "/tmp", "easyrpg_test_input.eprb");
+}
+
+/** Steps the frame counter like the game does and replays the frame */
+void Step(Input::Source& src, int frame) {
+	auto& system = *Main_Data::game_system;
+	if (frame < system.GetFrameCounter()) {
+		system.ResetFrameCounter();
+	}
+	while (system.GetFrameCounter() < frame) {
+		system.IncFrameCounter();
+	}
+	src.Update();
+}
+
+}
+
+TEST_CASE("BinaryLogRoundTrip") {
+	const MockGame mock(MockMap::ePassBlock20x15);
+	Main_Data::game_targets = std::make_unique<Game_Targets>();
+	Scene::instance = std::make_shared<Scene>();
+	Scene::instance->type = Scene::Map;
+
+	// Keyframes are not written during transitions. The transition
+	// registers itself to the drawables of the current scene.
+	static DrawableList drawables;
+	DrawableMgr::SetLocalList(&drawables);
+	REQUIRE(!Transition::instance().IsActive());
+	DrawableMgr::SetLocalList(nullptr);
+
+	const auto path = TempPath();
+
+	// Play to frame 5000, load a savegame of frame 2000 and play to 9000
+	std::vector<std::pair<int, bool>> frames;
+	for (int frame = 0; frame <= 5000; ++frame) {
+		frames.emplace_back(frame, false);
+	}
+	for (int frame = 2000; frame <= 9000; ++frame) {
+		frames.emplace_back(frame, true);
+	}
+
+	{
+		RecordSource rec;
+		REQUIRE(rec.InitRecording(path));
+		for (auto& f: frames) {
+			rec.SetButtons(Buttons(f.first, f.second));
+			Step(rec, f.first);
+			rec.RecordKeyframe();
+		}
+	}
+
+	auto open = [&]() {
+		auto is = FileFinder::Root().OpenInputStream(path, std::ios::in | std::ios::binary);
+		REQUIRE(Input::BinaryLogSource::IsBinaryLog(is));
+		auto src = std::make_unique<Input::BinaryLogSource>(std::move(is),
+				Input::GetDefaultButtonMappings(), Input::GetDefaultDirectionMappings());
+		REQUIRE(*src);
+		return src;
+	};
+
+	SUBCASE("Replay") {
+		auto src = open();
+		for (auto& f: frames) {
+			Step(*src, f.first);
+			REQUIRE_EQ(src->GetPressedButtons(), Buttons(f.first, f.second));
+		}
+	}
+
+	SUBCASE("Seek") {
+		auto src = open();
+
+		// Keyframes at 0 and 3600 before the load, the one at 3600 is
+		// superseded by the ones at 2000 and 5600 after the load
+		auto save_data = src->Seek(6000);
+		REQUIRE(!save_data.empty());
+
+		std::istringstream is(save_data);
+		auto save = lcf::LSD_Reader::Load(is, Player::encoding);
+		REQUIRE(save);
+		const int kf_frame = save->system.frame_count;
+		REQUIRE_EQ(kf_frame, 5600);
+
+		// The savegame of the keyframe is loaded, then the replay continues
+		Main_Data::game_system->ResetFrameCounter();
+		for (auto it = frames.begin() + 5001 + (kf_frame - 2000) + 1; it != frames.end(); ++it) {
+			Step(*src, it->first);
+			REQUIRE_EQ(src->GetPressedButtons(), Buttons(it->first, it->second));
+		}
+	}
+
+	SUBCASE("SeekBeforeLoad") {
+		auto src = open();
+		auto save_data = src->Seek(1000);
+		REQUIRE(!save_data.empty());
+
+		Main_Data::game_system->ResetFrameCounter();
+		for (auto it = frames.begin() + 1; it != frames.end(); ++it) {
+			Step(*src, it->first);
+			REQUIRE_EQ(src->GetPressedButtons(), Buttons(it->first, it->second));
+		}
+	}
+
+	Player::exit_flag = false;
+	Scene::instance.reset();
+	Main_Data::game_targets.reset();
+	std::remove(path.c_str());
+}
+
+TEST_SUITE_END();
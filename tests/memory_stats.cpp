@@ -0,0 +1,101 @@
+#include <algorithm>
+#include "memory_stats.h"
+#include "pixel_format.h"
+#include "bitmap.h"
+#include "font.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("MemoryStats");
+
+namespace {
+const MemoryStats::Stats* Find(const std::vector<MemoryStats::Stats>& stats, const std::string& name) {
+	auto it = std::find_if(stats.begin(), stats.end(), [&](const MemoryStats::Stats& s) { return s.name == name; });
+	return it == stats.end() ? nullptr : &*it;
+}
+}
+
+TEST_CASE("Counters") {
+	MemoryStats::Source source("Test counters");
+	source.Allocate(100);
+	source.Allocate(50);
+	source.Release(100);
+	source.Hit();
+	source.Hit(4);
+	source.Miss();
+	source.Evict(3);
+
+	auto stats = MemoryStats::Collect();
+	auto* s = Find(stats, "Test counters");
+	REQUIRE(s != nullptr);
+	REQUIRE_EQ(s->bytes, 50);
+	REQUIRE_EQ(s->entries, 1);
+	REQUIRE_EQ(s->hits, 5);
+	REQUIRE_EQ(s->misses, 1);
+	REQUIRE_EQ(s->evictions, 3);
+}
+
+TEST_CASE("Measure") {
+	size_t size = 10;
+	MemoryStats::Source source("Test measure", [&](MemoryStats::Source& src) { src.SetUsage(size, 2); });
+
+	REQUIRE_EQ(Find(MemoryStats::Collect(), "Test measure")->bytes, 10);
+
+	size = 20;
+	REQUIRE_EQ(Find(MemoryStats::Collect(), "Test measure")->bytes, 20);
+}
+
+TEST_CASE("SumByName") {
+	MemoryStats::Source a("Test sum");
+	MemoryStats::Source b("Test sum");
+	a.Allocate(1);
+	b.Allocate(2);
+	b.Hit();
+
+	auto stats = MemoryStats::Collect();
+	REQUIRE_EQ(std::count_if(stats.begin(), stats.end(), [](const MemoryStats::Stats& s) { return s.name == "Test sum"; }), 1);
+	auto* s = Find(stats, "Test sum");
+	REQUIRE_EQ(s->bytes, 3);
+	REQUIRE_EQ(s->entries, 2);
+	REQUIRE_EQ(s->hits, 1);
+}
+
+TEST_CASE("Unregister") {
+	{
+		MemoryStats::Source source("Test unregister");
+		REQUIRE(Find(MemoryStats::Collect(), "Test unregister") != nullptr);
+	}
+	REQUIRE(Find(MemoryStats::Collect(), "Test unregister") == nullptr);
+}
+
+TEST_CASE("GlyphsReleased") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Font::Dispose();
+	const auto bytes = Find(MemoryStats::Collect(), "Glyphs")->bytes;
+
+	Font::Default(false)->Glyph('A');
+	REQUIRE_GT(Find(MemoryStats::Collect(), "Glyphs")->bytes, bytes);
+
+	Font::Dispose();
+	REQUIRE_EQ(Find(MemoryStats::Collect(), "Glyphs")->bytes, bytes);
+}
+
+TEST_CASE("FormatBytes") {
+	REQUIRE_EQ(MemoryStats::FormatBytes(512), "512B");
+	REQUIRE_EQ(MemoryStats::FormatBytes(2048), "2K");
+	REQUIRE_EQ(MemoryStats::FormatBytes(3 * 1024 * 1024 + 400 * 1024), "3.4M");
+}
+
+TEST_CASE("FormatStats") {
+	MemoryStats::Stats s;
+	s.name = "Test";
+	s.bytes = 2048;
+	s.entries = 4;
+	REQUIRE_EQ(MemoryStats::FormatStats(s), "Test: 2K / 4");
+
+	s.hits = 3;
+	s.misses = 1;
+	s.evictions = 2;
+	REQUIRE_EQ(MemoryStats::FormatStats(s), "Test: 2K / 4, hit 75%, evict 2");
+}
+
+TEST_SUITE_END();
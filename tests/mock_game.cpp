@@ -1,6 +1,7 @@
 #include "mock_game.h"
 #include "game_actors.h"
 #include "game_system.h"
+#include "state.h"
 
 static lcf::rpg::Terrain MakeTerrain() {
 	return {};
@@ -78,6 +79,7 @@ void MockGame::DoReset() {
 	Main_Data::game_pictures = {};
 	Game_Map::Quit();
 	lcf::Data::data = {};
+	StateSet::LoadFlagTable();
 
 	Main_Data::game_party.reset();
 	Input::ResetKeys();
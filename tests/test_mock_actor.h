@@ -12,6 +12,7 @@
 #include "main_data.h"
 #include "player.h"
 #include "output.h"
+#include "state.h"
 #include <lcf/data.h>
 
 static void InitEmptyDB() {
@@ -22,6 +23,7 @@ static void InitEmptyDB() {
 		}
 	};
 	lcf::Data::data = {};
+	StateSet::LoadFlagTable();
 
 	initVec(lcf::Data::actors, 20);
 	initVec(lcf::Data::skills, 200);
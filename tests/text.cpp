@@ -31,6 +31,26 @@ TEST_CASE("TextDrawSystemStrReturn") {
 	REQUIRE_EQ(draw(3, 17, "$A $B"), Rect(3, 17, cwf * 2 + cwh, ch));
 }
 
+TEST_CASE("TextDrawSystemStrRepeated") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto font = Font::Default();
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SysBlack();
+
+	auto draw = [&](int x, int y, const auto& text) {
+		return Text::Draw(*surface, x, y, *font, *system, 0, text);
+	};
+
+	// The second draw replays the cached glyph run
+	for (int i = 0; i < 2; ++i) {
+		REQUIRE_EQ(draw(0, 0, "abc"), Rect(0, 0, cwh * 3, ch));
+		REQUIRE_EQ(draw(3, 17, "$A $B"), Rect(3, 17, cwf * 2 + cwh, ch));
+	}
+
+	// Glyphs beyond the right border are skipped but still measured
+	REQUIRE_EQ(draw(width - cwh, 0, "abc"), Rect(width - cwh, 0, cwh * 3, ch));
+}
+
 TEST_CASE("TextDrawColorStrReturn") {
 	Bitmap::SetFormat(format_R8G8B8A8_a().format());
 	auto font = Font::Default();
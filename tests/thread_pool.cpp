@@ -0,0 +1,51 @@
+#include <atomic>
+#include <vector>
+#include "thread_pool.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("ThreadPool");
+
+TEST_CASE("ParallelFor") {
+	ThreadPool pool(3);
+
+	std::vector<int> hits(100);
+	pool.ParallelFor(hits.size(), [&](int i) { ++hits[i]; });
+
+	for (auto h: hits) {
+		REQUIRE_EQ(h, 1);
+	}
+}
+
+TEST_CASE("ParallelForNested") {
+	ThreadPool pool(2);
+
+	std::atomic<int> sum{0};
+	pool.ParallelFor(8, [&](int) {
+		pool.ParallelFor(8, [&](int j) { sum += j; });
+	});
+
+	REQUIRE_EQ(sum.load(), 8 * 28);
+}
+
+TEST_CASE("NoThreads") {
+	ThreadPool pool(0);
+
+	int sum = 0;
+	pool.ParallelFor(10, [&](int i) { sum += i; });
+
+	REQUIRE_EQ(sum, 45);
+}
+
+TEST_CASE("Push") {
+	std::atomic<int> count{0};
+	{
+		ThreadPool pool(2);
+		for (int i = 0; i < 50; ++i) {
+			pool.Push([&]() { ++count; });
+		}
+	}
+
+	REQUIRE_EQ(count.load(), 50);
+}
+
+TEST_SUITE_END();
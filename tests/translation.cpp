@@ -0,0 +1,80 @@
+#include <sstream>
+#include "translation.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Translation");
+
+static Dictionary MakeDictionary() {
+	std::stringstream po;
+	po << "msgid \"\"\n"
+		<< "msgstr \"\"\n"
+		<< "\n"
+		<< "msgid \"Hello\"\n"
+		<< "msgstr \"Hallo\"\n"
+		<< "\n"
+		<< "msgctxt \"actors.1.name\"\n"
+		<< "msgid \"Alex\"\n"
+		<< "msgstr \"Alexander\"\n"
+		<< "\n"
+		<< "msgid \"Line 1\\n\"\n"
+		<< "\"Line 2\"\n"
+		<< "msgstr \"Zeile 1\\n\"\n"
+		<< "\"Zeile 2\"\n"
+		<< "\n"
+		<< "msgid \"Untranslated\"\n"
+		<< "msgstr \"\"\n"
+		<< "\n"
+		<< "msgid \"Hello\"\n"
+		<< "msgstr \"Servus\"\n";
+
+	Dictionary dict;
+	REQUIRE(Dictionary::FromPo(dict, po));
+	return dict;
+}
+
+static void CheckDictionary(const Dictionary& dict) {
+	REQUIRE_EQ(dict.GetEntryCount(), 4u);
+
+	std::string s = "Hello";
+	REQUIRE(dict.TranslateString("", s));
+	// The later entry wins
+	REQUIRE_EQ(s, "Servus");
+
+	s = "Alex";
+	REQUIRE_FALSE(dict.TranslateString("", s));
+	REQUIRE(dict.TranslateString("actors.1.name", s));
+	REQUIRE_EQ(s, "Alexander");
+
+	s = "Line 1\nLine 2";
+	REQUIRE(dict.TranslateString("", s));
+	REQUIRE_EQ(s, "Zeile 1\nZeile 2");
+
+	s = "Untranslated";
+	REQUIRE_FALSE(dict.TranslateString("", s));
+	REQUIRE_EQ(s, "Untranslated");
+}
+
+TEST_CASE("FromPo") {
+	CheckDictionary(MakeDictionary());
+}
+
+TEST_CASE("Binary") {
+	std::stringstream bin;
+	MakeDictionary().ToBinary(bin);
+
+	Dictionary dict;
+	REQUIRE(Dictionary::FromBinary(dict, bin));
+	CheckDictionary(dict);
+}
+
+TEST_CASE("BinaryTruncated") {
+	std::stringstream bin;
+	MakeDictionary().ToBinary(bin);
+	std::string data = bin.str();
+	std::stringstream truncated(data.substr(0, data.size() / 2));
+
+	Dictionary dict;
+	REQUIRE_FALSE(Dictionary::FromBinary(dict, truncated));
+}
+
+TEST_SUITE_END();